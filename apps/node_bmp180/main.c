@@ -14,11 +14,12 @@
 /* RIOT firmware libraries */
 #include "coap_common.h"
 #include "coap_position.h"
-#include "coap_bmp180.h"
+#include "coap_saul.h"
+#include "node_config.h"
+#include "node_tools.h"
 
-static const shell_command_t shell_commands[] = {
-    { NULL, NULL, NULL }
-};
+#include "app_manifest.h"
+#include "manifest.h"
 
 #define MAIN_QUEUE_SIZE       (8)
 static msg_t _main_msg_queue[MAIN_QUEUE_SIZE];
@@ -26,16 +27,8 @@ static msg_t _main_msg_queue[MAIN_QUEUE_SIZE];
 /* import "ifconfig" shell command, used for printing addresses */
 extern int _gnrc_netif_config(int argc, char **argv);
 
-/* CoAP resources (alphabetical order) */
-static const coap_resource_t _resources[] = {
-    { "/board", COAP_GET, board_handler, NULL },
-    { "/mcu", COAP_GET, mcu_handler, NULL },
-    { "/name", COAP_GET, name_handler, NULL },
-    { "/os", COAP_GET, os_handler, NULL },
-    { "/position", COAP_GET, position_handler, NULL },
-    { "/pressure", COAP_GET, bmp180_pressure_handler, NULL },
-    { "/temperature", COAP_GET, bmp180_temperature_handler, NULL },
-};
+/* CoAP resources, generated from manifest.h */
+static const coap_resource_t _resources[] = { APP_MANIFEST_COAP_RESOURCES };
 
 static gcoap_listener_t _listener = {
     (coap_resource_t *)&_resources[0],
@@ -60,11 +53,13 @@ int main(void)
     /* start coap server loop */
     gcoap_register_listener(&_listener);
     init_beacon_sender();
-    init_bmp180_sender(true, true);
+    init_config_handler();
+    node_tools_init(&_listener);
+    init_saul_sender();
 
     puts("All up, running the shell now");
     char line_buf[SHELL_DEFAULT_BUFSIZE];
-    shell_run(shell_commands, line_buf, SHELL_DEFAULT_BUFSIZE);
+    shell_run(node_tools_shell_commands, line_buf, SHELL_DEFAULT_BUFSIZE);
 
     return 0;
 }
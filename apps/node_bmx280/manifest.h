@@ -0,0 +1,22 @@
+#ifndef MANIFEST_H
+#define MANIFEST_H
+
+#ifdef MODULE_BME280
+#define MANIFEST_HUMIDITY(X, SEP) \
+    X(humidity, "humidity", COAP_GET, bmx280_humidity_handler, NULL) SEP()
+#else
+#define MANIFEST_HUMIDITY(X, SEP)
+#endif
+
+/* Resources (alphabetical order) */
+#define APP_MANIFEST(X, SEP) \
+    X(board, "board", COAP_GET, board_handler, NULL) SEP() \
+    MANIFEST_HUMIDITY(X, SEP) \
+    X(mcu, "mcu", COAP_GET, mcu_handler, NULL) SEP() \
+    X(name, "name", COAP_GET, name_handler, NULL) SEP() \
+    X(os, "os", COAP_GET, os_handler, NULL) SEP() \
+    X(position, "position", COAP_GET, position_handler, NULL) SEP() \
+    X(pressure, "pressure", COAP_GET, bmx280_pressure_handler, NULL) SEP() \
+    X(temperature, "temperature", COAP_GET, bmx280_temperature_handler, NULL)
+
+#endif /* MANIFEST_H */
@@ -0,0 +1,14 @@
+#ifndef MANIFEST_H
+#define MANIFEST_H
+
+/* Resources (alphabetical order) */
+#define APP_MANIFEST(X, SEP) \
+    X(board, "board", COAP_GET, board_handler, NULL) SEP() \
+    X(eco2, "eco2", COAP_GET, ccs811_eco2_handler, NULL) SEP() \
+    X(mcu, "mcu", COAP_GET, mcu_handler, NULL) SEP() \
+    X(name, "name", COAP_GET, name_handler, NULL) SEP() \
+    X(os, "os", COAP_GET, os_handler, NULL) SEP() \
+    X(position, "position", COAP_GET, position_handler, NULL) SEP() \
+    X(tvoc, "tvoc", COAP_GET, ccs811_tvoc_handler, NULL)
+
+#endif /* MANIFEST_H */
@@ -0,0 +1,15 @@
+#ifndef MANIFEST_H
+#define MANIFEST_H
+
+/* Resources (alphabetical order) */
+#define APP_MANIFEST(X, SEP) \
+    X(board, "board", COAP_GET, board_handler, NULL) SEP() \
+    X(imu, "imu", COAP_GET, coap_imu_handler, NULL) SEP() \
+    X(imu_capture, "imu/capture", COAP_GET | COAP_PUT | COAP_POST, imu_capture_handler, NULL) SEP() \
+    X(imu_features, "imu/features", COAP_GET, imu_features_handler, NULL) SEP() \
+    X(mcu, "mcu", COAP_GET, mcu_handler, NULL) SEP() \
+    X(name, "name", COAP_GET, name_handler, NULL) SEP() \
+    X(orientation, "orientation", COAP_GET, imu_orientation_handler, NULL) SEP() \
+    X(os, "os", COAP_GET, os_handler, NULL)
+
+#endif /* MANIFEST_H */
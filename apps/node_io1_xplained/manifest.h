@@ -0,0 +1,12 @@
+#ifndef MANIFEST_H
+#define MANIFEST_H
+
+/* Resources (alphabetical order) */
+#define APP_MANIFEST(X, SEP) \
+    X(board, "board", COAP_GET, board_handler, NULL) SEP() \
+    X(mcu, "mcu", COAP_GET, mcu_handler, NULL) SEP() \
+    X(name, "name", COAP_GET, name_handler, NULL) SEP() \
+    X(os, "os", COAP_GET, os_handler, NULL) SEP() \
+    X(temperature, "temperature", COAP_GET, io1_xplained_temperature_handler, NULL)
+
+#endif /* MANIFEST_H */
@@ -0,0 +1,14 @@
+#ifndef MANIFEST_H
+#define MANIFEST_H
+
+/* Resources (alphabetical order), sensor resources are built from the SAUL
+   registry */
+#define APP_MANIFEST(X, SEP) \
+    X(board, "board", COAP_GET, board_handler, NULL) SEP() \
+    X(led, "led", COAP_GET | COAP_PUT | COAP_POST, led_handler, NULL) SEP() \
+    X(mcu, "mcu", COAP_GET, mcu_handler, NULL) SEP() \
+    X(name, "name", COAP_GET, name_handler, NULL) SEP() \
+    X(os, "os", COAP_GET, os_handler, NULL) SEP() \
+    X(position, "position", COAP_GET, position_handler, NULL)
+
+#endif /* MANIFEST_H */
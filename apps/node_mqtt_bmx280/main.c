@@ -14,7 +14,6 @@
 #include "shell.h"
 #include "msg.h"
 #include "net/emcute.h"
-#include "net/ipv6/addr.h"
 #include "board.h"
 
 #include "periph/gpio.h"
@@ -22,129 +21,73 @@
 #include "mqtt_common.h"
 #include "mqtt_bmx280.h"
 #include "mqtt_utils.h"
+#include "node_config.h"
+#include "node_tools.h"
+
+#include "app_manifest.h"
+#include "manifest.h"
 
 #define ENABLE_DEBUG   (0)
 #include "debug.h"
 
-#define MQTT_PORT           (1883U)
 #define NUMOFSUBS           (16U)
 #define TOPIC_MAXLEN        (64U)
 
-#ifndef GATEWAY_ADDR
-#define GATEWAY_ADDR "2001:660:3207:102::4"
-#endif
-
-#ifndef GATEWAY_PORT
-#define GATEWAY_PORT 1885
-#endif
-
-#ifndef NODE_ID
-#define NODE_ID "node_id_0"
-#endif
-
-static const shell_command_t shell_commands[] = {
-    { NULL, NULL, NULL }
-};
-
-#define EMCUTE_PRIO           (THREAD_PRIORITY_MAIN - 1)
-
 #define MAIN_QUEUE_SIZE       (8)
 static msg_t _main_msg_queue[MAIN_QUEUE_SIZE];
 
-static char stack[THREAD_STACKSIZE_DEFAULT];
-
 typedef void (*mqtt_handler_t)(char *value);
 
-typedef struct {
-    const char *path;
-    mqtt_handler_t handler;
-} mqtt_resource_t;
-
 static char payload[64] = {0};
 
-static const mqtt_resource_t mqtt_resources[] = {
-    {"board", get_board},
-#ifdef MODULE_BME280
-    {"humidity", get_humidity},
-#endif
-    {"mcu", get_mcu},
-    {"os", get_os},
-    {"name", get_name},
-    {"pressure", get_pressure},
-    {"temperature", get_temperature},
-};
+/* MQTT resources, generated from manifest.h */
+enum { APP_MANIFEST_IDS, APP_RES_NUMOF };
 
-static const unsigned coap_resources_numof = sizeof(mqtt_resources) / sizeof(mqtt_resources[0]);
+static emcute_topic_t mqtt_topics[APP_RES_NUMOF] = { APP_MANIFEST_MQTT_TOPICS };
 
-static int initialize_mqtt_node(void)
-{
-    char topic[64] = { 0 };
-    sock_udp_ep_t gw = {.family = AF_INET6, .port = GATEWAY_PORT};
+static const mqtt_handler_t mqtt_getters[APP_RES_NUMOF] = { APP_MANIFEST_MQTT_GETTERS };
 
-    /* parse address */
-    if (ipv6_addr_from_str((ipv6_addr_t *)&gw.addr.ipv6, GATEWAY_ADDR) == NULL) {
-        DEBUG("[ERROR] error parsing IPv6 address\n");
-        return -1;
-    }
+static emcute_topic_t resources_topic = { MQTT_TOPIC("resources"), 0 };
+
+static const char resources_payload[] = APP_MANIFEST_JSON;
 
-    if (emcute_con(&gw, true, NULL, NULL, 0, 0) != EMCUTE_OK) {
-        DEBUG("[ERROR] unable to connect to [%s]:%i\n",
-              GATEWAY_ADDR, (int)GATEWAY_PORT);
+static int initialize_mqtt_node(void)
+{
+    /* starts emcute, the telemetry sink of the sensor shares the
+       connection */
+    if (mqtt_utils_connect() < 0) {
         return -1;
     }
-    DEBUG("[INFO] Successfully connected to gateway at [%s]:%i\n",
-          GATEWAY_ADDR, (int)GATEWAY_PORT);
 
-    memset(payload, 0, sizeof(payload));
-    sprintf(payload, "{\"id\": \"%s\"}", NODE_ID);
-    if (publish((uint8_t*)"node/check", (uint8_t*)payload)) {
+    if (publish((uint8_t*)"node/check", (uint8_t*)"{\"id\": \"" NODE_ID "\"}")) {
         DEBUG("[ERROR] Failed to publish led status\n");
         return -1;
     }
 
     xtimer_sleep(1);
 
-#ifdef MODULE_BME280
-    sprintf(payload,
-            "[\"board\",\"mcu\",\"os\",\"name\","
-            "\"temperature\",\"pressure\",\"humidity\"]");
-#else
-    sprintf(payload,
-            "[\"board\",\"mcu\",\"os\",\"name\","
-            "\"temperature\",\"pressure\"]");
-#endif
-    memset(topic, 0, sizeof(topic));
-    sprintf(topic, "node/%s/resources", NODE_ID);
-    if (publish((uint8_t*)topic, (uint8_t*)payload)) {
-        DEBUG("[ERROR] Failed to publish on node/%s/resources\n",
-                NODE_ID);
+    if (publish_topic(&resources_topic, resources_payload)) {
+        DEBUG("[ERROR] Failed to publish on %s\n", resources_topic.name);
         return -1;
     }
 
     xtimer_sleep(1);
 
-    for (unsigned i = 0; i < coap_resources_numof; ++i) {
-        mqtt_resources[i].handler(payload);
-        memset(topic, 0, sizeof(topic));
-        sprintf(topic, "node/%s/%s", NODE_ID, mqtt_resources[i].path);
-        if (publish((uint8_t*)topic, (uint8_t*)payload)) {
-            DEBUG("[ERROR] Failed to publish on %s\n", topic);
+    for (unsigned i = 0; i < APP_RES_NUMOF; ++i) {
+        mqtt_getters[i](payload);
+        if (publish_topic(&mqtt_topics[i], payload)) {
+            DEBUG("[ERROR] Failed to publish on %s\n", mqtt_topics[i].name);
             continue;
         }
     }
 
+    init_config_mqtt();
+
     DEBUG("[INFO] MQTT node initialized with success\n");
 
     return 0;
 }
 
-static void *emcute_thread(void *arg)
-{
-    (void)arg;
-    emcute_run(MQTT_PORT, NODE_ID);
-    return NULL;    /* should never be reached */
-}
-
 /* import "ifconfig" shell command, used for printing addresses */
 extern int _gnrc_netif_config(int argc, char **argv);
 
@@ -162,20 +105,20 @@ int main(void)
     puts("Configured network interfaces:");
     _gnrc_netif_config(0, NULL);
 
-    /* start the emcute thread */
-    thread_create(stack, sizeof(stack), EMCUTE_PRIO, 0,
-                  emcute_thread, NULL, "emcute");
+    /* the sensor is initialized first, the resource values are published
+       once connected */
+    node_tools_init(NULL);
+    init_bmx280_mqtt_sender();
 
     if (initialize_mqtt_node() < 0) {
         puts("Failed to initialize MQTT node");
     }
 
-    init_bmx280_mqtt_sender();
     init_beacon_sender();
 
     puts("All up, running the shell now");
     char line_buf[SHELL_DEFAULT_BUFSIZE];
-    shell_run(shell_commands, line_buf, SHELL_DEFAULT_BUFSIZE);
+    shell_run(node_tools_shell_commands, line_buf, SHELL_DEFAULT_BUFSIZE);
 
     return 0;
 }
@@ -0,0 +1,21 @@
+#ifndef MANIFEST_H
+#define MANIFEST_H
+
+#ifdef MODULE_BME280
+#define MANIFEST_HUMIDITY(X, SEP) \
+    X(humidity, "humidity", 0, NULL, get_humidity) SEP()
+#else
+#define MANIFEST_HUMIDITY(X, SEP)
+#endif
+
+/* Resources (alphabetical order) */
+#define APP_MANIFEST(X, SEP) \
+    X(board, "board", 0, NULL, get_board) SEP() \
+    MANIFEST_HUMIDITY(X, SEP) \
+    X(mcu, "mcu", 0, NULL, get_mcu) SEP() \
+    X(name, "name", 0, NULL, get_name) SEP() \
+    X(os, "os", 0, NULL, get_os) SEP() \
+    X(pressure, "pressure", 0, NULL, get_pressure) SEP() \
+    X(temperature, "temperature", 0, NULL, get_temperature)
+
+#endif /* MANIFEST_H */
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2017 Inria
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include "shell.h"
+#include "net/nanocoap.h"
+#include "net/gcoap.h"
+
+/* RIOT firmware libraries */
+#include "coap_common.h"
+#include "coap_saul.h"
+#include "node_config.h"
+#include "node_tools.h"
+
+#include "app_manifest.h"
+#include "manifest.h"
+
+#define MAIN_QUEUE_SIZE       (8)
+static msg_t _main_msg_queue[MAIN_QUEUE_SIZE];
+
+/* import "ifconfig" shell command, used for printing addresses */
+extern int _gnrc_netif_config(int argc, char **argv);
+
+/* CoAP resources, generated from manifest.h */
+static const coap_resource_t _resources[] = { APP_MANIFEST_COAP_RESOURCES };
+
+static gcoap_listener_t _listener = {
+    (coap_resource_t *)&_resources[0],
+    sizeof(_resources) / sizeof(_resources[0]),
+    NULL
+};
+
+int main(void)
+{
+    puts("RIOT SAUL Node application");
+
+    /* gnrc which needs a msg queue */
+    msg_init_queue(_main_msg_queue, MAIN_QUEUE_SIZE);
+
+    puts("Waiting for address autoconfiguration...");
+    xtimer_sleep(3);
+
+    /* print network addresses */
+    puts("Configured network interfaces:");
+    _gnrc_netif_config(0, NULL);
+
+    /* start coap server loop */
+    gcoap_register_listener(&_listener);
+    init_beacon_sender();
+    init_config_handler();
+    node_tools_init(&_listener);
+    init_saul_sender();
+
+    puts("All up, running the shell now");
+    char line_buf[SHELL_DEFAULT_BUFSIZE];
+    shell_run(node_tools_shell_commands, line_buf, SHELL_DEFAULT_BUFSIZE);
+
+    return 0;
+}
@@ -0,0 +1,59 @@
+#ifndef APP_MANIFEST_H
+#define APP_MANIFEST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* An application lists its resources once in a manifest.h, in alphabetical
+ * order as required by gcoap, with SEP() between entries:
+ *
+ *   #define APP_MANIFEST(X, SEP) \
+ *       X(board, "board", COAP_GET, board_handler, get_board) SEP() \
+ *       X(mcu, "mcu", COAP_GET, mcu_handler, get_mcu)
+ *
+ * Each entry gives an identifier, the path, the CoAP methods, the CoAP
+ * handler and the MQTT getter, a transport not used by the application can
+ * be NULL. Optional resources are wrapped in a macro of their own taking
+ * (X, SEP), which expands to nothing when the resource is disabled.
+ *
+ * The tables below are expanded from the manifest at compile time, only the
+ * ones used by the application end up in flash. */
+
+#define APP_MANIFEST_SEP_COMMA()    ,
+#define APP_MANIFEST_SEP_JSON()     "\",\""
+
+#define _APP_MANIFEST_ID(id, path, methods, coap, mqtt)      APP_RES_ ## id
+#define _APP_MANIFEST_PATH(id, path, methods, coap, mqtt)    path
+#define _APP_MANIFEST_COAP(id, path, methods, coap, mqtt) \
+    { "/" path, methods, coap, NULL }
+#define _APP_MANIFEST_TOPIC(id, path, methods, coap, mqtt) \
+    { MQTT_TOPIC(path), 0 }
+#define _APP_MANIFEST_GETTER(id, path, methods, coap, mqtt)  mqtt
+
+/* resource identifiers, in manifest order: enum { APP_MANIFEST_IDS, APP_RES_NUMOF } */
+#define APP_MANIFEST_IDS \
+    APP_MANIFEST(_APP_MANIFEST_ID, APP_MANIFEST_SEP_COMMA)
+
+/* coap_resource_t initializers */
+#define APP_MANIFEST_COAP_RESOURCES \
+    APP_MANIFEST(_APP_MANIFEST_COAP, APP_MANIFEST_SEP_COMMA)
+
+/* emcute_topic_t initializers with "node/<NODE_ID>/<path>" names, the topic
+   ids are assigned by the gateway on registration (needs mqtt_utils.h) */
+#define APP_MANIFEST_MQTT_TOPICS \
+    APP_MANIFEST(_APP_MANIFEST_TOPIC, APP_MANIFEST_SEP_COMMA)
+
+/* MQTT getters, indexed like the topics */
+#define APP_MANIFEST_MQTT_GETTERS \
+    APP_MANIFEST(_APP_MANIFEST_GETTER, APP_MANIFEST_SEP_COMMA)
+
+/* resources advertisement payload: ["board","mcu",...] */
+#define APP_MANIFEST_JSON \
+    "[\"" APP_MANIFEST(_APP_MANIFEST_PATH, APP_MANIFEST_SEP_JSON) "\"]"
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -4,9 +4,6 @@
 #include <stdio.h>
 #include <string.h>
 
-#include "msg.h"
-#include "thread.h"
-#include "xtimer.h"
 #include "periph/i2c.h"
 
 #include "bmx280_params.h"
@@ -14,133 +11,506 @@
 
 #include "net/gcoap.h"
 
+#include "xtimer.h"
+
 #include "coap_utils.h"
+#include "sensor_filter.h"
+#include "sensor_bus.h"
+#include "telemetry.h"
+#include "metrics.h"
+#include "trace.h"
 #include "coap_bmx280.h"
+#ifdef MODULE_NODE_CONFIG
+#include "node_config.h"
+#endif
+#ifdef MODULE_COAP_BURST
+#include "coap_burst.h"
+#endif
 
 #define ENABLE_DEBUG (0)
 #include "debug.h"
 
-#define SEND_INTERVAL              (5000000UL)    /* set temperature updates interval to 5 seconds */
+#ifndef BMX280_FILTER_MEDIAN
+#define BMX280_FILTER_MEDIAN       (3U)    /* median-of-N spike rejection, 0 to disable */
+#endif
+#ifndef BMX280_FILTER_EMA_SHIFT
+#define BMX280_FILTER_EMA_SHIFT    (0U)    /* EMA smoothing, alpha = 1/2^N, 0 to disable */
+#endif
 
-#define BMX280_QUEUE_SIZE    (8)
+/* The sensor runs in forced mode: one measurement per sample, then it goes
+   back to sleep until the next one */
+#ifndef BMX280_TEMP_OVERSAMPLE
+#define BMX280_TEMP_OVERSAMPLE     (BMX280_OSRS_X1)
+#endif
+#ifndef BMX280_PRESS_OVERSAMPLE
+#define BMX280_PRESS_OVERSAMPLE    (BMX280_OSRS_X1)
+#endif
+#ifndef BMX280_HUMID_OVERSAMPLE
+#define BMX280_HUMID_OVERSAMPLE    (BMX280_OSRS_X1)
+#endif
+#ifndef BMX280_IIR_FILTER
+#define BMX280_IIR_FILTER          (BMX280_FILTER_OFF)    /* on-chip IIR filter */
+#endif
+
+#define BMX280_ACTIVE_UA           (714U)  /* typical current while measuring */
+#define BMX280_SLEEP_UA            (1U)    /* typical current in sleep mode */
+
+#define BMX280_REG_CTRL_MEAS       (0xF4)  /* osrs_t[7:5], osrs_p[4:2], mode[1:0] */
 
-static msg_t _bmx280_msg_queue[BMX280_QUEUE_SIZE];
-static char bmx280_stack[THREAD_STACKSIZE_DEFAULT];
+#define BMX280_NUMOF               (sizeof(bmx280_params) / sizeof(bmx280_params[0]))
+#define BMX280_CHANNELS            (3U)
+#define BMX280_PATH_LEN            (20U)
 
-static bmx280_t bmx280_dev;
+typedef struct {
+    bmx280_t dev;
+    bmx280_params_t conf;
+    uint32_t conv_time;         /* max measurement time of the settings in us */
+    sensor_filter_t temperature_filter;
+    sensor_filter_t pressure_filter;
+#ifdef MODULE_BME280
+    sensor_filter_t humidity_filter;
+#endif
+} bmx280_instance_t;
+
+static bmx280_instance_t instances[BMX280_NUMOF];
 static uint8_t response[64] = { 0 };
 
 static bool use_temperature = false;
 static bool use_pressure = false;
-
 #ifdef MODULE_BME280
 static bool use_humidity = false;
 #endif
+/* enabled channels changed, the sensors are configured again before the
+   next read */
+static volatile bool reconfigure = false;
+
+#ifdef MODULE_NODE_CONFIG
+static void _apply_channels(const node_config_entry_t *entry)
+{
+    (void)entry;
+    reconfigure = true;
+}
+
+static node_config_entry_t _config_temperature = {
+    .name = "bmx280_temperature",
+    .type = NODE_CONFIG_BOOL,
+    .value = &use_temperature,
+    .apply = _apply_channels,
+};
+
+static node_config_entry_t _config_pressure = {
+    .name = "bmx280_pressure",
+    .type = NODE_CONFIG_BOOL,
+    .value = &use_pressure,
+    .apply = _apply_channels,
+};
+
+#ifdef MODULE_BME280
+static node_config_entry_t _config_humidity = {
+    .name = "bmx280_humidity",
+    .type = NODE_CONFIG_BOOL,
+    .value = &use_humidity,
+    .apply = _apply_channels,
+};
+#endif
+#endif
+
+/* "/<channel>/<index>" resources, one per channel of each instance */
+static char _paths[BMX280_NUMOF * BMX280_CHANNELS][BMX280_PATH_LEN];
+static coap_resource_t _resources[BMX280_NUMOF * BMX280_CHANNELS];
+static gcoap_listener_t _listener = { &_resources[0], 0, NULL };
+
+/* raw values: centi degrees, Pa and centi percent */
+static const telemetry_sample_t _temperature = {
+    .name = "temperature", .scale = -2, .digits = 1, .unit = "°C",
+};
+static const telemetry_sample_t _pressure = {
+    .name = "pressure", .scale = -2, .digits = 2, .unit = "hPa",
+};
+#ifdef MODULE_BME280
+static const telemetry_sample_t _humidity = {
+    .name = "humidity", .scale = -2, .digits = 2, .unit = "%",
+};
+#endif
+
+static size_t _format(char *buf, const telemetry_sample_t *channel,
+                      int32_t value)
+{
+    telemetry_sample_t sample = *channel;
+    sample.value = value;
+    return telemetry_format(buf, &sample);
+}
+
+static size_t _format_temperature(char *buf, int32_t temperature)
+{
+    return _format(buf, &_temperature, temperature);
+}
+
+static size_t _format_pressure(char *buf, int32_t pressure)
+{
+    return _format(buf, &_pressure, pressure);
+}
+
+#ifdef MODULE_BME280
+static size_t _format_humidity(char *buf, int32_t humidity)
+{
+    return _format(buf, &_humidity, humidity);
+}
+#endif
+
+static void _publish(const telemetry_sample_t *channel, unsigned idx,
+                     int32_t value)
+{
+    telemetry_sample_t sample = *channel;
+    sample.idx = (BMX280_NUMOF > 1) ? idx : TELEMETRY_NO_INDEX;
+    sample.value = value;
+    telemetry_publish(&sample);
+}
+
+/* The module triggers the forced measurements itself and the driver is set
+   to sleep mode, so that its reads only fetch and compensate the results:
+   the bus scheduler starts the measurements of all instances, and of the
+   other sensors, then reads them once the slowest one is done */
+static int _start(bmx280_instance_t *inst)
+{
+    const bmx280_params_t *p = &inst->conf;
+    uint8_t ctrl_meas = (p->temp_oversample << 5) | (p->press_oversample << 2) |
+                        BMX280_MODE_FORCED;
+
+    i2c_acquire(p->i2c_dev);
+    int res = i2c_write_reg(p->i2c_dev, p->i2c_addr, BMX280_REG_CTRL_MEAS,
+                            ctrl_meas, 0);
+    i2c_release(p->i2c_dev);
+    return res;
+}
+
+/* oversampling factor of a setting, 0 when skipped */
+static uint32_t _osrs(bmx280_osrs_t osrs)
+{
+    return (osrs == BMX280_OSRS_SKIPPED) ? 0 : 1U << (osrs - 1);
+}
+
+/* max measurement time of the datasheet, in us */
+static uint32_t _conv_time(const bmx280_params_t *p)
+{
+    uint32_t us = 1250 + 2300 * _osrs(p->temp_oversample);
+    if (p->press_oversample != BMX280_OSRS_SKIPPED) {
+        us += 2300 * _osrs(p->press_oversample) + 575;
+    }
+#ifdef MODULE_BME280
+    if (p->humid_oversample != BMX280_OSRS_SKIPPED) {
+        us += 2300 * _osrs(p->humid_oversample) + 575;
+    }
+#endif
+    return us;
+}
+
+/* single measurement outside of the bus cycles, for the handlers and
+   bursts, with the bus lock held. Pressure and humidity are compensated
+   with the temperature read last: it must be read before each of them */
+static int16_t _convert(bmx280_instance_t *inst)
+{
+    _start(inst);
+    xtimer_usleep(inst->conv_time);
+    return bmx280_read_temperature(&inst->dev);
+}
+
+static int16_t _measure(bmx280_instance_t *inst)
+{
+    sensor_bus_lock();
+    int16_t temperature = _convert(inst);
+    sensor_bus_unlock();
+    return temperature;
+}
+
+static int32_t _read_pressure(bmx280_instance_t *inst)
+{
+    sensor_bus_lock();
+    _convert(inst);
+    int32_t pressure = bmx280_read_pressure(&inst->dev);
+    sensor_bus_unlock();
+    return pressure;
+}
+
+#ifdef MODULE_BME280
+static int32_t _read_humidity(bmx280_instance_t *inst)
+{
+    sensor_bus_lock();
+    _convert(inst);
+    int32_t humidity = bme280_read_humidity(&inst->dev);
+    sensor_bus_unlock();
+    return humidity;
+}
+#endif
+
+#ifdef MODULE_COAP_BURST
+/* burst samples are raw, they bypass the filter chain, only the first
+   instance can be sampled */
+static size_t _burst_read_temperature(char *buf, size_t len)
+{
+    (void)len;
+    return _format_temperature(buf, _measure(&instances[0]));
+}
+
+static size_t _burst_read_pressure(char *buf, size_t len)
+{
+    (void)len;
+    return _format_pressure(buf, _read_pressure(&instances[0]));
+}
+
+static coap_burst_source_t _burst_temperature = {
+    .name = "temperature",
+    .max_rate = BMX280_BURST_MAX_RATE,
+    .sample_size = BURST_VALUE_LEN,
+    .read = _burst_read_temperature,
+};
+
+static coap_burst_source_t _burst_pressure = {
+    .name = "pressure",
+    .max_rate = BMX280_BURST_MAX_RATE,
+    .sample_size = BURST_VALUE_LEN,
+    .read = _burst_read_pressure,
+};
+
+#ifdef MODULE_BME280
+static size_t _burst_read_humidity(char *buf, size_t len)
+{
+    (void)len;
+    return _format_humidity(buf, _read_humidity(&instances[0]));
+}
+
+static coap_burst_source_t _burst_humidity = {
+    .name = "humidity",
+    .max_rate = BMX280_BURST_MAX_RATE,
+    .sample_size = BURST_VALUE_LEN,
+    .read = _burst_read_humidity,
+};
+#endif
+#endif
+
+/* the context of indexed resources is their instance, the plain resources
+   registered by the application serve the first one */
+static bmx280_instance_t *_instance(void *ctx)
+{
+    return (ctx) ? ctx : &instances[0];
+}
 
 ssize_t bmx280_temperature_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx)
 {
-    (void)ctx;
+    METRICS_START(t);
+    TRACE_REQUEST(coap_get_id(pdu));
+    TRACE_BEGIN(HANDLER);
+    bmx280_instance_t *inst = _instance(ctx);
     ssize_t p = 0;
     gcoap_resp_init(pdu, buf, len, COAP_CODE_CONTENT);
     memset(response, 0, sizeof(response));
-    int16_t temperature = bmx280_read_temperature(&bmx280_dev);
-    bool negative = (temperature < 0);
-    if (negative) {
-        temperature = -temperature;
+    int32_t temperature;
+    if (!sensor_filter_get(&inst->temperature_filter, &temperature)) {
+        TRACE_BEGIN(SENSOR);
+        temperature = _measure(inst);
+        TRACE_END(SENSOR);
     }
-    p += sprintf((char*)response, "%s%d.%d°C",
-                 (negative) ? "-" : "",
-                 temperature / 100, (temperature % 100) / 10);
+    p += _format_temperature((char*)response, temperature);
     response[p] = '\0';
     memcpy(pdu->payload, response, p);
 
-    return gcoap_finish(pdu, p, COAP_FORMAT_TEXT);
+    ssize_t res = gcoap_finish(pdu, p, COAP_FORMAT_TEXT);
+    TRACE_END(HANDLER);
+    METRICS_STOP(HANDLER, t);
+    return res;
 }
 
 ssize_t bmx280_pressure_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx)
 {
-    (void)ctx;
+    METRICS_START(t);
+    TRACE_REQUEST(coap_get_id(pdu));
+    TRACE_BEGIN(HANDLER);
+    bmx280_instance_t *inst = _instance(ctx);
     ssize_t p = 0;
     gcoap_resp_init(pdu, buf, len, COAP_CODE_CONTENT);
     memset(response, 0, sizeof(response));
-    uint32_t pressure = bmx280_read_pressure(&bmx280_dev);
-    p += sprintf((char*)response, "%lu.%dhPa",
-                 (unsigned long)pressure / 100,
-                 (int)pressure % 100);
+    int32_t pressure;
+    if (!sensor_filter_get(&inst->pressure_filter, &pressure)) {
+        TRACE_BEGIN(SENSOR);
+        pressure = _read_pressure(inst);
+        TRACE_END(SENSOR);
+    }
+    p += _format_pressure((char*)response, pressure);
     response[p] = '\0';
     memcpy(pdu->payload, response, p);
 
-    return gcoap_finish(pdu, p, COAP_FORMAT_TEXT);
+    ssize_t res = gcoap_finish(pdu, p, COAP_FORMAT_TEXT);
+    TRACE_END(HANDLER);
+    METRICS_STOP(HANDLER, t);
+    return res;
 }
 
 #ifdef MODULE_BME280
 ssize_t bmx280_humidity_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx)
 {
-    (void)ctx;
+    METRICS_START(t);
+    TRACE_REQUEST(coap_get_id(pdu));
+    TRACE_BEGIN(HANDLER);
+    bmx280_instance_t *inst = _instance(ctx);
     ssize_t p = 0;
     gcoap_resp_init(pdu, buf, len, COAP_CODE_CONTENT);
     memset(response, 0, sizeof(response));
-    uint16_t humidity = bme280_read_humidity(&bmx280_dev);
-    p += sprintf((char*)response, "%u.%02u%%",
-            (unsigned int)(humidity / 100),
-            (unsigned int)(humidity % 100));
+    int32_t humidity;
+    if (!sensor_filter_get(&inst->humidity_filter, &humidity)) {
+        TRACE_BEGIN(SENSOR);
+        humidity = _read_humidity(inst);
+        TRACE_END(SENSOR);
+    }
+    p += _format_humidity((char*)response, humidity);
     response[p] = '\0';
     memcpy(pdu->payload, response, p);
 
-    return gcoap_finish(pdu, p, COAP_FORMAT_TEXT);
+    ssize_t res = gcoap_finish(pdu, p, COAP_FORMAT_TEXT);
+    TRACE_END(HANDLER);
+    METRICS_STOP(HANDLER, t);
+    return res;
 }
 #endif
 
-void *bmx280_thread(void *args)
+static int _configure(bmx280_instance_t *inst, unsigned idx);
+
+static sensor_bus_dev_t _bus_dev;
+
+static int _bus_start(void *arg)
 {
-    (void)args;
-    msg_init_queue(_bmx280_msg_queue, BMX280_QUEUE_SIZE);
+    (void)arg;
+    bool update = reconfigure;
+    reconfigure = false;
+    int res = 0;
 
-    for(;;) {
-        if (use_temperature) {
-            ssize_t p = 0;
-            int16_t temp = bmx280_read_temperature(&bmx280_dev);
-            bool negative = (temp < 0);
-            if (negative) {
-                temp = -temp;
-            }
-            p += sprintf((char*)&response[p], "temperature:");
-            p += sprintf((char*)&response[p], "%s%d.%d°C",
-                         negative ? "-" : "",
-                         temp / 100, (temp % 100) /10);
-            response[p] = '\0';
-            send_coap_post((uint8_t*)"/server", response);
+    _bus_dev.conv_time = 0;
+    for (unsigned i = 0; i < BMX280_NUMOF; i++) {
+        bmx280_instance_t *inst = &instances[i];
+        if (update) {
+            _configure(inst, i);
+        }
+        if (_start(inst) < 0) {
+            res = -1;
         }
+        /* the measurements run in parallel */
+        if (inst->conv_time > _bus_dev.conv_time) {
+            _bus_dev.conv_time = inst->conv_time;
+        }
+    }
+    return res;
+}
+
+/* temperature is read first: the driver fetches all channels in a single
+   burst and compensates pressure and humidity with it */
+static int _bus_read(void *arg)
+{
+    (void)arg;
 
+    for (unsigned i = 0; i < BMX280_NUMOF; i++) {
+        bmx280_instance_t *inst = &instances[i];
+        sensor_filter_update(&inst->temperature_filter,
+                             bmx280_read_temperature(&inst->dev));
         if (use_pressure) {
-            ssize_t p = 0;
-            uint32_t pres = bmx280_read_pressure(&bmx280_dev);
-            p += sprintf((char*)&response[p], "pressure:");
-            p += sprintf((char*)&response[p], "%lu.%dhPa",
-                         (unsigned long)pres / 100,
-                         (int)pres % 100);
-            response[p] = '\0';
-            send_coap_post((uint8_t*)"/server", response);
+            sensor_filter_update(&inst->pressure_filter,
+                                 bmx280_read_pressure(&inst->dev));
         }
-
 #ifdef MODULE_BME280
         if (use_humidity) {
-            ssize_t p = 0;
-            uint16_t hum = bme280_read_humidity(&bmx280_dev);
-            p += sprintf((char*)&response[p], "humidity:");
-            p += sprintf((char*)&response[p], "%u.%02u%%",
-                         (unsigned int)(hum / 100),
-                         (unsigned int)(hum % 100));
-            response[p] = '\0';
-            send_coap_post((uint8_t*)"/server", response);
+            sensor_filter_update(&inst->humidity_filter,
+                                 bme280_read_humidity(&inst->dev));
+        }
+#endif
+    }
+    return 0;
+}
+
+static void _bus_report(void *arg)
+{
+    (void)arg;
+    int32_t value;
+
+    for (unsigned i = 0; i < BMX280_NUMOF; i++) {
+        bmx280_instance_t *inst = &instances[i];
+        if (use_temperature &&
+            sensor_filter_get(&inst->temperature_filter, &value)) {
+            _publish(&_temperature, i, value);
+        }
+
+        if (use_pressure && sensor_filter_get(&inst->pressure_filter, &value)) {
+            _publish(&_pressure, i, value);
+        }
+
+#ifdef MODULE_BME280
+        if (use_humidity && sensor_filter_get(&inst->humidity_filter, &value)) {
+            _publish(&_humidity, i, value);
         }
 #endif
+    }
+    telemetry_flush();
+}
+
+static sensor_bus_dev_t _bus_dev = {
+    .name = "bmx280",
+    .start = _bus_start,
+    .read = _bus_read,
+    .report = _bus_report,
+};
+
+static void _add_resource(const char *name, unsigned idx, coap_handler_t handler)
+{
+    unsigned n = _listener.resources_len++;
+    snprintf(_paths[n], BMX280_PATH_LEN, "/%s/%u", name, idx);
+    _resources[n].path = _paths[n];
+    _resources[n].methods = COAP_GET;
+    _resources[n].handler = handler;
+    _resources[n].context = &instances[idx];
+}
+
+static int _configure(bmx280_instance_t *inst, unsigned idx)
+{
+    inst->conf = bmx280_params[idx];
+    /* measurements are started by _start(), see above */
+    inst->conf.run_mode = BMX280_MODE_SLEEP;
+    inst->conf.filter = BMX280_IIR_FILTER;
+    inst->conf.temp_oversample = BMX280_TEMP_OVERSAMPLE;
+    /* unused channels are skipped to shorten the measurement */
+    inst->conf.press_oversample = (use_pressure) ? BMX280_PRESS_OVERSAMPLE
+                                                 : BMX280_OSRS_SKIPPED;
+#ifdef MODULE_BME280
+    inst->conf.humid_oversample = (use_humidity) ? BMX280_HUMID_OVERSAMPLE
+                                                 : BMX280_OSRS_SKIPPED;
+#endif
+    inst->conv_time = _conv_time(&inst->conf);
+
+    return bmx280_init(&inst->dev, &inst->conf);
+}
+
+static int _init_instance(unsigned idx)
+{
+    bmx280_instance_t *inst = &instances[idx];
+
+    sensor_filter_setup(&inst->temperature_filter,
+                        BMX280_FILTER_MEDIAN, BMX280_FILTER_EMA_SHIFT);
+    sensor_filter_setup(&inst->pressure_filter,
+                        BMX280_FILTER_MEDIAN, BMX280_FILTER_EMA_SHIFT);
+#ifdef MODULE_BME280
+    sensor_filter_setup(&inst->humidity_filter,
+                        BMX280_FILTER_MEDIAN, BMX280_FILTER_EMA_SHIFT);
+#endif
 
-        /* wait 5 seconds */
-        xtimer_usleep(SEND_INTERVAL);
+    if (use_temperature) {
+        _add_resource("temperature", idx, bmx280_temperature_handler);
     }
+    if (use_pressure) {
+        _add_resource("pressure", idx, bmx280_pressure_handler);
+    }
+#ifdef MODULE_BME280
+    if (use_humidity) {
+        _add_resource("humidity", idx, bmx280_humidity_handler);
+    }
+#endif
 
-    return NULL;
+    return _configure(inst, idx);
 }
 
 void init_bmx280_sender(bool temperature, bool pressure, bool humidity)
@@ -149,31 +519,59 @@ void init_bmx280_sender(bool temperature, bool pressure, bool humidity)
     use_pressure = pressure;
 #ifdef MODULE_BME280
     use_humidity = humidity;
+#else
+    (void)humidity;
+#endif
+#ifdef MODULE_NODE_CONFIG
+    /* persisted settings take precedence over the arguments, resources
+       are only created for the channels enabled at boot */
+    node_config_register(&_config_temperature);
+    node_config_register(&_config_pressure);
+#ifdef MODULE_BME280
+    node_config_register(&_config_humidity);
+#endif
+    reconfigure = false;
 #endif
+    telemetry_init();
 
-    /* Initialize the BMX280 sensor */
-    printf("+------------Initializing BMX280 sensor ------------+\n");
-    int result = bmx280_init(&bmx280_dev, &bmx280_params[0]);
-    if (result == -1) {
-        puts("[Error] The given i2c is not enabled");
-    }
-    else if (result == -2) {
-        puts("[Error] The sensor did not answer correctly on the given address");
-    }
-    else {
-        printf("Initialization successful\n\n");
+    /* Initialize the BMX280 sensors */
+    for (unsigned i = 0; i < BMX280_NUMOF; i++) {
+        printf("+------------Initializing BMX280 sensor %u ------------+\n", i);
+        int result = _init_instance(i);
+        if (result == -1) {
+            puts("[Error] The given i2c is not enabled");
+        }
+        else if (result == -2) {
+            puts("[Error] The sensor did not answer correctly on the given address");
+        }
+        else {
+            printf("Initialization successful\n\n");
+        }
     }
 
-    /* create the sensors thread that will send periodic updates to
-       the server */
-    int bmx280_pid = thread_create(bmx280_stack, sizeof(bmx280_stack),
-                                   THREAD_PRIORITY_MAIN - 1,
-                                   THREAD_CREATE_STACKTEST, bmx280_thread,
-                                   NULL, "bmx280 thread");
-    if (bmx280_pid == -EINVAL || bmx280_pid == -EOVERFLOW) {
-        puts("Error: failed to create bmx280 thread, exiting\n");
+    sort_coap_resources(_resources, _listener.resources_len);
+    gcoap_register_listener(&_listener);
+#ifdef MODULE_TELEMETRY_OBSERVE
+    telemetry_observe_listener(&_listener);
+#endif
+
+#ifdef MODULE_COAP_BURST
+    if (use_temperature) {
+        coap_burst_register(&_burst_temperature);
     }
-    else {
-        puts("Successfuly created bmx280 thread !\n");
+    if (use_pressure) {
+        coap_burst_register(&_burst_pressure);
     }
+#ifdef MODULE_BME280
+    if (use_humidity) {
+        coap_burst_register(&_burst_humidity);
+    }
+#endif
+#endif
+
+    /* periodic updates to the server are sent by the bus scheduler, the
+       instances measure at the same time */
+    _bus_dev.active_ua = BMX280_NUMOF * BMX280_ACTIVE_UA;
+    _bus_dev.idle_ua = BMX280_NUMOF * BMX280_SLEEP_UA;
+    sensor_bus_register(&_bus_dev);
 }
@@ -10,6 +10,10 @@
 extern "C" {
 #endif
 
+#ifndef BMX280_BURST_MAX_RATE
+#define BMX280_BURST_MAX_RATE      (10U)   /* max burst rate in Hz, one forced measurement per sample */
+#endif
+
 ssize_t bmx280_temperature_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx);
 ssize_t bmx280_pressure_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx);
 #ifdef MODULE_BME280
@@ -0,0 +1,289 @@
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#include "msg.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#include "net/gcoap.h"
+
+#include "coap_utils.h"
+#include "coap_burst.h"
+#include "tlog.h"
+#include "trace.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+#define BURST_QUEUE_SIZE      (4U)
+#define BURST_POLL_INTERVAL   (100U * US_PER_MS)    /* for self streaming sources */
+
+#ifndef BURST_STACKSIZE
+#define BURST_STACKSIZE       (THREAD_STACKSIZE_DEFAULT)
+#endif
+
+static msg_t _burst_msg_queue[BURST_QUEUE_SIZE];
+static char burst_stack[BURST_STACKSIZE];
+static kernel_pid_t burst_pid = KERNEL_PID_UNDEF;
+
+static coap_burst_source_t *_sources = NULL;
+
+static struct {
+    coap_burst_source_t *source;
+    uint16_t rate;
+    uint16_t duration;
+    uint32_t sent;
+    uint32_t dropped;
+    volatile bool active;
+    volatile bool cancel;
+} _burst;
+
+static ssize_t _burst_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx);
+
+static const coap_resource_t _resources[] = {
+    { "/burst", COAP_GET | COAP_POST | COAP_PUT, _burst_handler, NULL },
+};
+
+static gcoap_listener_t _listener = {
+    (coap_resource_t *)&_resources[0],
+    sizeof(_resources) / sizeof(_resources[0]),
+    NULL
+};
+
+static coap_burst_source_t *_find_source(const char *name)
+{
+    for (coap_burst_source_t *s = _sources; s != NULL; s = s->next) {
+        if (strcmp(s->name, name) == 0) {
+            return s;
+        }
+    }
+    return NULL;
+}
+
+static void _notify(coap_burst_source_t *source)
+{
+    char msg[BURST_VALUE_LEN + 16];
+    size_t p = 0;
+
+    /* each notification is traced as one request */
+    TRACE_NEW();
+    p += sprintf(&msg[p], "%s:", source->name);
+    TRACE_BEGIN(SENSOR);
+    size_t n = source->read(&msg[p], sizeof(msg) - p);
+    TRACE_END(SENSOR);
+    if (n == 0) {
+        _burst.dropped++;
+        return;
+    }
+    p += n;
+    msg[p] = '\0';
+
+    /* notify observers of /burst, fall back to a push to the broker */
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+    switch (gcoap_obs_init(&pdu, buf, sizeof(buf), &_resources[0])) {
+    case GCOAP_OBS_INIT_OK:
+        memcpy(pdu.payload, msg, p);
+        TRACE_BEGIN(SEND);
+        gcoap_obs_send(buf, gcoap_finish(&pdu, p, COAP_FORMAT_TEXT),
+                       &_resources[0]);
+        TRACE_END(SEND);
+        break;
+    case GCOAP_OBS_INIT_UNUSED:
+        send_coap_post((uint8_t*)"/server", (uint8_t*)msg);
+        break;
+    default:
+        TLOG("[DEBUG] burst: notification dropped\n");
+        _burst.dropped++;
+        return;
+    }
+    _burst.sent++;
+}
+
+static void *_burst_thread(void *args)
+{
+    (void)args;
+    msg_t msg;
+
+    msg_init_queue(_burst_msg_queue, BURST_QUEUE_SIZE);
+
+    for(;;) {
+        msg_receive(&msg);
+
+        coap_burst_source_t *source = _burst.source;
+        uint32_t period = (source->read) ? (US_PER_SEC / _burst.rate)
+                                         : BURST_POLL_INTERVAL;
+        uint64_t end = xtimer_now_usec64() +
+                       (uint64_t)_burst.duration * US_PER_SEC;
+
+        TLOG("[DEBUG] burst: %s at %uHz for %us\n",
+             source->name, _burst.rate, _burst.duration);
+
+        if (source->start) {
+            source->start(_burst.rate);
+        }
+
+        uint32_t last_wakeup = xtimer_now_usec();
+        while (!_burst.cancel && (xtimer_now_usec64() < end)) {
+            if (source->read) {
+                _notify(source);
+            }
+            xtimer_periodic_wakeup(&last_wakeup, period);
+        }
+
+        /* back to the normal schedule */
+        if (source->stop) {
+            source->stop();
+        }
+        _burst.active = false;
+        TLOG("[DEBUG] burst: done, %" PRIu32 " sent\n", _burst.sent);
+    }
+
+    return NULL;
+}
+
+static int _start(const char *name, long rate, long duration)
+{
+    coap_burst_source_t *source = _find_source(name);
+    if (source == NULL) {
+        return -ENOENT;
+    }
+
+    if (duration == 0) {
+        /* cancel the running burst */
+        _burst.cancel = true;
+        return 0;
+    }
+
+    if ((rate <= 0) || (rate > source->max_rate) ||
+        (duration < 0) || (duration > BURST_MAX_DURATION) ||
+        ((uint64_t)rate * duration * source->sample_size > BURST_MAX_BYTES)) {
+        return -EINVAL;
+    }
+
+    if (_burst.active) {
+        return -EBUSY;
+    }
+
+    _burst.source = source;
+    _burst.rate = rate;
+    _burst.duration = duration;
+    _burst.sent = 0;
+    _burst.dropped = 0;
+    _burst.cancel = false;
+    _burst.active = true;
+
+    msg_t msg;
+    if (msg_try_send(&msg, burst_pid) != 1) {
+        _burst.active = false;
+        return -EBUSY;
+    }
+
+    return 0;
+}
+
+static ssize_t _burst_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx)
+{
+    (void)ctx;
+    unsigned method_flag = coap_method2flag(coap_get_code_detail(pdu));
+
+    if (method_flag & (COAP_POST | COAP_PUT)) {
+        char payload[64] = { 0 };
+        char name[16] = { 0 };
+        long rate = 0;
+        long duration = -1;
+
+        if (pdu->payload_len >= sizeof(payload)) {
+            return coap_reply_simple(pdu, COAP_CODE_REQUEST_ENTITY_TOO_LARGE,
+                                     buf, len, COAP_FORMAT_TEXT, NULL, 0);
+        }
+        memcpy(payload, pdu->payload, pdu->payload_len);
+
+        char *saveptr = NULL;
+        for (char *tok = strtok_r(payload, "&,", &saveptr); tok != NULL;
+             tok = strtok_r(NULL, "&,", &saveptr)) {
+            char *val = strchr(tok, '=');
+            if (val == NULL) {
+                continue;
+            }
+            *val++ = '\0';
+            if (strcmp(tok, "resource") == 0) {
+                strncpy(name, val, sizeof(name) - 1);
+            }
+            else if (strcmp(tok, "rate") == 0) {
+                rate = strtol(val, NULL, 10);
+            }
+            else if (strcmp(tok, "duration") == 0) {
+                duration = strtol(val, NULL, 10);
+            }
+        }
+
+        unsigned code;
+        switch (_start(name, rate, duration)) {
+        case 0:
+            code = COAP_CODE_CHANGED;
+            break;
+        case -ENOENT:
+            code = COAP_CODE_NOT_FOUND;
+            break;
+        case -EBUSY:
+            code = COAP_CODE_SERVICE_UNAVAILABLE;
+            break;
+        default:
+            code = COAP_CODE_BAD_REQUEST;
+            break;
+        }
+        return coap_reply_simple(pdu, code, buf, len, COAP_FORMAT_TEXT, NULL, 0);
+    }
+
+    /* GET: burst status, observe it to receive the burst samples */
+    gcoap_resp_init(pdu, buf, len, COAP_CODE_CONTENT);
+    char *out = (char*)pdu->payload;
+    size_t max = pdu->payload_len;
+    int n = snprintf(out, max, "{\"active\":%s,\"resource\":\"%s\","
+                     "\"rate\":%u,\"sent\":%" PRIu32 ",\"dropped\":%" PRIu32
+                     ",\"sources\":[",
+                     (_burst.active) ? "true" : "false",
+                     (_burst.source) ? _burst.source->name : "",
+                     _burst.rate, _burst.sent, _burst.dropped);
+    size_t p = ((n < 0) || ((size_t)n >= max)) ? max : (size_t)n;
+    for (coap_burst_source_t *s = _sources; (s != NULL) && (p < max); s = s->next) {
+        n = snprintf(&out[p], max - p, "%s\"%s\"",
+                     (s == _sources) ? "" : ",", s->name);
+        p += ((n < 0) || ((size_t)n >= max - p)) ? (max - p) : (size_t)n;
+    }
+    n = snprintf(&out[p], (p < max) ? max - p : 0, "]}");
+    if ((p >= max) || (n < 0) || ((size_t)n >= max - p)) {
+        return coap_reply_simple(pdu, COAP_CODE_INTERNAL_SERVER_ERROR, buf, len,
+                                 COAP_FORMAT_TEXT, NULL, 0);
+    }
+    p += n;
+
+    return gcoap_finish(pdu, p, COAP_FORMAT_JSON);
+}
+
+void coap_burst_register(coap_burst_source_t *source)
+{
+    source->next = _sources;
+    _sources = source;
+}
+
+void init_burst_handler(void)
+{
+    gcoap_register_listener(&_listener);
+
+    burst_pid = thread_create(burst_stack, sizeof(burst_stack),
+                              THREAD_PRIORITY_MAIN - 1,
+                              THREAD_CREATE_STACKTEST, _burst_thread,
+                              NULL, "burst thread");
+    if (burst_pid == -EINVAL || burst_pid == -EOVERFLOW) {
+        puts("Error: failed to create burst thread, exiting\n");
+    }
+    else {
+        puts("Successfuly created burst thread !\n");
+    }
+}
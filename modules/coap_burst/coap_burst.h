@@ -0,0 +1,45 @@
+#ifndef COAP_BURST_H
+#define COAP_BURST_H
+
+#include <inttypes.h>
+
+#include "net/gcoap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef BURST_MAX_DURATION
+#define BURST_MAX_DURATION    (300U)            /* max burst duration in seconds */
+#endif
+
+#ifndef BURST_MAX_BYTES
+#define BURST_MAX_BYTES       (64UL * 1024)     /* airtime budget per burst in bytes */
+#endif
+
+#ifndef BURST_VALUE_LEN
+#define BURST_VALUE_LEN       (48U)             /* max length of a formatted value */
+#endif
+
+/* A resource that can be sampled at a higher rate for a limited time.
+ * Polled sources provide `read`, which samples and formats one value.
+ * Sources that stream on their own provide `start` and `stop` instead. */
+typedef struct coap_burst_source {
+    struct coap_burst_source *next;
+    const char *name;
+    uint16_t max_rate;                      /* Hz */
+    uint16_t sample_size;                   /* estimated uplink bytes per sample */
+    size_t (*read)(char *buf, size_t len);
+    void (*start)(uint16_t rate);
+    void (*stop)(void);
+} coap_burst_source_t;
+
+void coap_burst_register(coap_burst_source_t *source);
+
+void init_burst_handler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* COAP_BURST_H */
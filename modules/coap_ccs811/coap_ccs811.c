@@ -4,10 +4,8 @@
 #include <stdio.h>
 #include <string.h>
 
-#include "msg.h"
-#include "thread.h"
-#include "xtimer.h"
 #include "periph/i2c.h"
+#include "periph/gpio.h"
 
 #include "ccs811_params.h"
 #include "ccs811.h"
@@ -15,112 +13,385 @@
 #include "net/gcoap.h"
 
 #include "coap_utils.h"
+#include "sensor_filter.h"
+#include "sensor_bus.h"
+#include "telemetry.h"
+#include "metrics.h"
+#include "trace.h"
 #include "coap_ccs811.h"
+#ifdef MODULE_COAP_BURST
+#include "coap_burst.h"
+#endif
 
 #define ENABLE_DEBUG (0)
 #include "debug.h"
 
-#define SEND_INTERVAL        (5000000UL)    /* set updates interval to 5 seconds */
+#ifndef CCS811_FILTER_MEDIAN
+#define CCS811_FILTER_MEDIAN      (5U)    /* median-of-N spike rejection, 0 to disable */
+#endif
+#ifndef CCS811_FILTER_EMA_SHIFT
+#define CCS811_FILTER_EMA_SHIFT   (2U)    /* EMA smoothing, alpha = 1/2^N, 0 to disable */
+#endif
 
-#define CCS811_QUEUE_SIZE    (8)
+/* Without CCS811_DRIVE_MODE, the drive mode follows the report interval,
+   see _bus_interval() */
 
 #define I2C_DEVICE           (0)
 
-static msg_t _ccs811_msg_queue[CCS811_QUEUE_SIZE];
-static char ccs811_stack[THREAD_STACKSIZE_DEFAULT];
+#define CCS811_NUMOF              (sizeof(ccs811_params) / sizeof(ccs811_params[0]))
+#define CCS811_CHANNELS           (2U)
+#define CCS811_PATH_LEN           (12U)
 
-static ccs811_t ccs811_dev;
+typedef struct {
+    ccs811_t dev;
+    ccs811_params_t conf;
+    sensor_filter_t eco2_filter;
+    sensor_filter_t tvoc_filter;
+} ccs811_instance_t;
+
+static ccs811_instance_t instances[CCS811_NUMOF];
 static uint8_t response[64] = { 0 };
 
 static bool use_eco2 = false;
 static bool use_tvoc = false;
 
+/* "/<channel>/<index>" resources, one per channel of each instance */
+static char _paths[CCS811_NUMOF * CCS811_CHANNELS][CCS811_PATH_LEN];
+static coap_resource_t _resources[CCS811_NUMOF * CCS811_CHANNELS];
+static gcoap_listener_t _listener = { &_resources[0], 0, NULL };
+
+#ifdef MODULE_COAP_BURST
+/* burst samples are raw, they bypass the filter chain, only the first
+   instance can be sampled */
+static size_t _burst_read_eco2(char *buf, size_t len)
+{
+    uint16_t eco2;
+    sensor_bus_lock();
+    int res = ccs811_read_iaq(&instances[0].dev, NULL, &eco2, NULL, NULL);
+    sensor_bus_unlock();
+    if (res != CCS811_OK) {
+        return 0;
+    }
+    return snprintf(buf, len, "%ippm", (int)eco2);
+}
+
+static size_t _burst_read_tvoc(char *buf, size_t len)
+{
+    uint16_t tvoc;
+    sensor_bus_lock();
+    int res = ccs811_read_iaq(&instances[0].dev, &tvoc, NULL, NULL, NULL);
+    sensor_bus_unlock();
+    if (res != CCS811_OK) {
+        return 0;
+    }
+    return snprintf(buf, len, "%ippb", (int)tvoc);
+}
+
+static coap_burst_source_t _burst_eco2 = {
+    .name = "eco2",
+    .max_rate = CCS811_BURST_MAX_RATE,
+    .sample_size = BURST_VALUE_LEN,
+    .read = _burst_read_eco2,
+};
+
+static coap_burst_source_t _burst_tvoc = {
+    .name = "tvoc",
+    .max_rate = CCS811_BURST_MAX_RATE,
+    .sample_size = BURST_VALUE_LEN,
+    .read = _burst_read_tvoc,
+};
+#endif
+
+/* the context of indexed resources is their instance, the plain resources
+   registered by the application serve the first one */
+static ccs811_instance_t *_instance(void *ctx)
+{
+    return (ctx) ? ctx : &instances[0];
+}
+
 ssize_t ccs811_eco2_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len, void *ctx)
 {
-    (void)ctx;
+    METRICS_START(t);
+    TRACE_REQUEST(coap_get_id(pdu));
+    TRACE_BEGIN(HANDLER);
+    ccs811_instance_t *inst = _instance(ctx);
+    int32_t eco2;
+    if (!sensor_filter_get(&inst->eco2_filter, &eco2)) {
+        uint16_t raw;
+        TRACE_BEGIN(SENSOR);
+        sensor_bus_lock();
+        int res = ccs811_read_iaq(&inst->dev, NULL, &raw, NULL, NULL);
+        sensor_bus_unlock();
+        TRACE_END(SENSOR);
+        if (res != CCS811_OK) {
+            TRACE_END(HANDLER);
+            METRICS_STOP(HANDLER, t);
+            return coap_reply_simple(pdu, COAP_CODE_SERVICE_UNAVAILABLE, buf,
+                                     len, COAP_FORMAT_TEXT, NULL, 0);
+        }
+        eco2 = raw;
+    }
     gcoap_resp_init(pdu, buf, len, COAP_CODE_CONTENT);
     memset(response, 0, sizeof(response));
-    uint16_t eco2;
-    ccs811_read_iaq(&ccs811_dev, NULL, &eco2, NULL, NULL);
-    sprintf((char*)response, "%ippm", eco2);
-    size_t payload_len = sizeof(response);
+    sprintf((char*)response, "%ippm", (int)eco2);
+    size_t payload_len = strlen((char*)response);
     memcpy(pdu->payload, response, payload_len);
 
-    return gcoap_finish(pdu, payload_len, COAP_FORMAT_TEXT);
+    ssize_t res = gcoap_finish(pdu, payload_len, COAP_FORMAT_TEXT);
+    TRACE_END(HANDLER);
+    METRICS_STOP(HANDLER, t);
+    return res;
 }
 
 ssize_t ccs811_tvoc_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len, void *ctx)
 {
-    (void)ctx;
+    METRICS_START(t);
+    TRACE_REQUEST(coap_get_id(pdu));
+    TRACE_BEGIN(HANDLER);
+    ccs811_instance_t *inst = _instance(ctx);
+    int32_t tvoc;
+    if (!sensor_filter_get(&inst->tvoc_filter, &tvoc)) {
+        uint16_t raw;
+        TRACE_BEGIN(SENSOR);
+        sensor_bus_lock();
+        int res = ccs811_read_iaq(&inst->dev, &raw, NULL, NULL, NULL);
+        sensor_bus_unlock();
+        TRACE_END(SENSOR);
+        if (res != CCS811_OK) {
+            TRACE_END(HANDLER);
+            METRICS_STOP(HANDLER, t);
+            return coap_reply_simple(pdu, COAP_CODE_SERVICE_UNAVAILABLE, buf,
+                                     len, COAP_FORMAT_TEXT, NULL, 0);
+        }
+        tvoc = raw;
+    }
     gcoap_resp_init(pdu, buf, len, COAP_CODE_CONTENT);
     memset(response, 0, sizeof(response));
-    uint16_t tvoc;
-    ccs811_read_iaq(&ccs811_dev, &tvoc, NULL, NULL, NULL);
-    sprintf((char*)response, "%ippb", tvoc);
-    size_t payload_len = sizeof(response);
+    sprintf((char*)response, "%ippb", (int)tvoc);
+    size_t payload_len = strlen((char*)response);
     memcpy(pdu->payload, response, payload_len);
 
-    return gcoap_finish(pdu, payload_len, COAP_FORMAT_TEXT);
+    ssize_t res = gcoap_finish(pdu, payload_len, COAP_FORMAT_TEXT);
+    TRACE_END(HANDLER);
+    METRICS_STOP(HANDLER, t);
+    return res;
 }
 
-void *ccs811_thread(void *args)
+static void _publish(const char *name, const char *unit, unsigned idx,
+                     int32_t value)
 {
-    (void) args;
-    msg_init_queue(_ccs811_msg_queue, CCS811_QUEUE_SIZE);
+    telemetry_sample_t sample = {
+        .name = name,
+        .idx = (CCS811_NUMOF > 1) ? idx : TELEMETRY_NO_INDEX,
+        .value = value,
+        .unit = unit,
+    };
+    telemetry_publish(&sample);
+}
 
-    for(;;) {
-        if (use_eco2) {
-            ssize_t p = 0;
-            uint16_t eco2;
-            ccs811_read_iaq(&ccs811_dev, NULL, &eco2, NULL, NULL);
-            p += sprintf((char*)&response[p], "eco2:");
-            p += sprintf((char*)&response[p], "%ippm", eco2);
-            response[p] = '\0';
-            send_coap_post((uint8_t*)"/server", response);
+/* both values come from a single result register read, instances without
+   new data keep their previous values */
+static int _bus_read(void *arg)
+{
+    (void)arg;
+    int res = -1;
+    for (unsigned i = 0; i < CCS811_NUMOF; i++) {
+        ccs811_instance_t *inst = &instances[i];
+        uint16_t eco2_raw, tvoc_raw;
+        if (ccs811_read_iaq(&inst->dev, &tvoc_raw, &eco2_raw,
+                            NULL, NULL) != CCS811_OK) {
+            continue;
         }
+        sensor_filter_update(&inst->eco2_filter, eco2_raw);
+        sensor_filter_update(&inst->tvoc_filter, tvoc_raw);
+        res = 0;
+    }
+    return res;
+}
+
+static void _bus_report(void *arg)
+{
+    (void)arg;
+    int32_t eco2, tvoc;
 
-        if (use_tvoc) {
-            ssize_t p = 0;
-            uint16_t tvoc;
-            ccs811_read_iaq(&ccs811_dev, &tvoc, NULL, NULL, NULL);
-            p += sprintf((char*)&response[p], "tvoc:");
-            p += sprintf((char*)&response[p], "%ippb", tvoc);
-            response[p] = '\0';
-            send_coap_post((uint8_t*)"/server", response);
+    for (unsigned i = 0; i < CCS811_NUMOF; i++) {
+        ccs811_instance_t *inst = &instances[i];
+        if (use_eco2 && sensor_filter_get(&inst->eco2_filter, &eco2)) {
+            _publish("eco2", "ppm", i, eco2);
         }
 
-        /* wait 5 seconds */
-        xtimer_usleep(SEND_INTERVAL);
+        if (use_tvoc && sensor_filter_get(&inst->tvoc_filter, &tvoc)) {
+            _publish("tvoc", "ppb", i, tvoc);
+        }
     }
+    telemetry_flush();
+}
 
-    return NULL;
+/* approximate average supply current of each drive mode, the heater
+   dominates so reads do not change it */
+static uint32_t _mode_current(ccs811_mode_t mode)
+{
+    switch (mode) {
+    case CCS811_MODE_250MS:
+        return 30000;
+    case CCS811_MODE_1S:
+        return 26000;
+    case CCS811_MODE_10S:
+        return 2800;
+    case CCS811_MODE_60S:
+        return 1200;
+    default:
+        return 19;
+    }
+}
+
+/* slowest drive mode that still gives a new value each report interval */
+static ccs811_mode_t _drive_mode(uint64_t interval)
+{
+#ifdef CCS811_DRIVE_MODE
+    (void)interval;
+    return CCS811_DRIVE_MODE;
+#else
+    if (interval >= 60 * US_PER_SEC) {
+        return CCS811_MODE_60S;
+    }
+    if (interval >= 10 * US_PER_SEC) {
+        return CCS811_MODE_10S;
+    }
+    return CCS811_MODE_1S;
+#endif
+}
+
+static sensor_bus_dev_t _bus_dev;
+
+static void _bus_interval(void *arg, uint64_t interval)
+{
+    (void)arg;
+    ccs811_mode_t mode = _drive_mode(interval);
+
+    for (unsigned i = 0; i < CCS811_NUMOF; i++) {
+        ccs811_instance_t *inst = &instances[i];
+        if (inst->conf.mode == mode) {
+            continue;
+        }
+        if (ccs811_set_mode(&inst->dev, mode) != CCS811_OK) {
+            DEBUG("[ERROR] ccs811: cannot set the drive mode of %u\n", i);
+            continue;
+        }
+        inst->conf.mode = mode;
+    }
+    _bus_dev.active_ua = CCS811_NUMOF * _mode_current(mode);
+    _bus_dev.idle_ua = _bus_dev.active_ua;
+}
+
+static sensor_bus_dev_t _bus_dev = {
+    .name = "ccs811",
+    .read = _bus_read,
+    .report = _bus_report,
+    .interval = _bus_interval,
+};
+
+#ifdef MODULE_CCS811_FULL
+static void _data_ready_cb(void *arg)
+{
+    (void)arg;
+    sensor_bus_trigger(&_bus_dev);
+}
+
+/* nINT is active low and released when the results are read */
+static int _init_int(ccs811_instance_t *inst)
+{
+    if (inst->conf.int_pin == GPIO_UNDEF) {
+        return -1;
+    }
+    if ((CCS811_INT_MODE == CCS811_INT_THRESHOLD) &&
+        (ccs811_set_eco2_thresholds(&inst->dev, CCS811_ECO2_THRESH_LOW,
+                                    CCS811_ECO2_THRESH_HIGH,
+                                    CCS811_ECO2_THRESH_HYST) != CCS811_OK)) {
+        return -1;
+    }
+    if (ccs811_set_int_mode(&inst->dev, CCS811_INT_MODE) != CCS811_OK) {
+        return -1;
+    }
+    return gpio_init_int(inst->conf.int_pin, GPIO_IN_PU, GPIO_FALLING,
+                         _data_ready_cb, inst);
+}
+#endif
+
+static void _add_resource(const char *name, unsigned idx, coap_handler_t handler)
+{
+    unsigned n = _listener.resources_len++;
+    snprintf(_paths[n], CCS811_PATH_LEN, "/%s/%u", name, idx);
+    _resources[n].path = _paths[n];
+    _resources[n].methods = COAP_GET;
+    _resources[n].handler = handler;
+    _resources[n].context = &instances[idx];
+}
+
+static int _init_instance(unsigned idx)
+{
+    ccs811_instance_t *inst = &instances[idx];
+
+    sensor_filter_setup(&inst->eco2_filter,
+                        CCS811_FILTER_MEDIAN, CCS811_FILTER_EMA_SHIFT);
+    sensor_filter_setup(&inst->tvoc_filter,
+                        CCS811_FILTER_MEDIAN, CCS811_FILTER_EMA_SHIFT);
+
+    if (use_eco2) {
+        _add_resource("eco2", idx, ccs811_eco2_handler);
+    }
+    if (use_tvoc) {
+        _add_resource("tvoc", idx, ccs811_tvoc_handler);
+    }
+
+    inst->conf = ccs811_params[idx];
+    inst->conf.mode = _drive_mode(sensor_bus_get_interval());
+    return ccs811_init(&inst->dev, &inst->conf);
 }
 
 void init_ccs811_sender(bool eco2, bool tvoc)
 {
     use_eco2 = eco2;
     use_tvoc = tvoc;
+    telemetry_init();
 
-    /* Initialize the CCS811 sensor */
-    printf("+------------Initializing CCS811 sensor ------------+\n");
-    int result = ccs811_init(&ccs811_dev, &ccs811_params[0]);
-    if (result != 0) {
-        puts("[Error] Cannot initialize CCS811 sensor");
-    }
-    else {
-        printf("Initialization successful\n\n");
+    /* Initialize the CCS811 sensors */
+    for (unsigned i = 0; i < CCS811_NUMOF; i++) {
+        printf("+------------Initializing CCS811 sensor %u ------------+\n", i);
+        if (_init_instance(i) != 0) {
+            puts("[Error] Cannot initialize CCS811 sensor");
+        }
+        else {
+            printf("Initialization successful\n\n");
+        }
     }
 
-    /* create the sensors thread that will send periodic updates to
-       the server */
-    int ccs811_pid = thread_create(ccs811_stack, sizeof(ccs811_stack),
-                                   THREAD_PRIORITY_MAIN - 1,
-                                   THREAD_CREATE_STACKTEST, ccs811_thread,
-                                   NULL, "ccs811 thread");
-    if (ccs811_pid == -EINVAL || ccs811_pid == -EOVERFLOW) {
-        puts("Error: failed to create ccs811 thread, exiting\n");
+    sort_coap_resources(_resources, _listener.resources_len);
+    gcoap_register_listener(&_listener);
+#ifdef MODULE_TELEMETRY_OBSERVE
+    telemetry_observe_listener(&_listener);
+#endif
+
+#ifdef MODULE_COAP_BURST
+    if (use_eco2) {
+        coap_burst_register(&_burst_eco2);
     }
-    else {
-        puts("Successfuly created ccs811 thread !\n");
+    if (use_tvoc) {
+        coap_burst_register(&_burst_tvoc);
+    }
+#endif
+
+    /* periodic updates to the server are sent by the bus scheduler, the
+       drive mode and current follow its interval */
+    sensor_bus_register(&_bus_dev);
+
+#ifdef MODULE_CCS811_FULL
+    /* with the interrupt, updates follow the sensor cadence and polling
+       only remains as a fallback */
+    for (unsigned i = 0; i < CCS811_NUMOF; i++) {
+        if (_init_int(&instances[i]) == 0) {
+            printf("CCS811 sensor %u interrupt enabled\n", i);
+        }
     }
+#endif
 }
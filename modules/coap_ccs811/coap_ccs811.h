@@ -10,6 +10,24 @@
 extern "C" {
 #endif
 
+#ifndef CCS811_INT_MODE
+#define CCS811_INT_MODE           (CCS811_INT_DATA_READY)   /* used when the nINT pin is wired */
+#endif
+
+#ifndef CCS811_ECO2_THRESH_LOW
+#define CCS811_ECO2_THRESH_LOW    (1500U)   /* ppm, for CCS811_INT_THRESHOLD */
+#endif
+#ifndef CCS811_ECO2_THRESH_HIGH
+#define CCS811_ECO2_THRESH_HIGH   (2500U)   /* ppm, for CCS811_INT_THRESHOLD */
+#endif
+#ifndef CCS811_ECO2_THRESH_HYST
+#define CCS811_ECO2_THRESH_HYST   (50U)     /* ppm, for CCS811_INT_THRESHOLD */
+#endif
+
+#ifndef CCS811_BURST_MAX_RATE
+#define CCS811_BURST_MAX_RATE     (1U)    /* max burst rate in Hz, the sensor updates once per second */
+#endif
+
 ssize_t ccs811_eco2_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx);
 ssize_t ccs811_tvoc_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx);
 
@@ -11,6 +11,9 @@
 
 #include "coap_common.h"
 #include "coap_utils.h"
+#ifdef MODULE_NODE_CONFIG
+#include "node_config.h"
+#endif
 
 #define ENABLE_DEBUG (0)
 #include "debug.h"
@@ -19,11 +22,29 @@
 #define APPLICATION_NAME "Node"
 #endif
 
-#define BEACON_INTERVAL       (30000000U)    /* set interval to 30 seconds */
+#define BEACON_INTERVAL       (30U)    /* default interval in seconds */
 
 #define BEACONING_QUEUE_SIZE  (8U)
+
+#ifndef BEACON_STACKSIZE
+#define BEACON_STACKSIZE      (THREAD_STACKSIZE_DEFAULT)
+#endif
+
 static msg_t _beaconing_msg_queue[BEACONING_QUEUE_SIZE];
-static char beaconing_stack[THREAD_STACKSIZE_DEFAULT];
+static char beaconing_stack[BEACON_STACKSIZE];
+
+static uint32_t beacon_interval = BEACON_INTERVAL;
+
+#ifdef MODULE_NODE_CONFIG
+/* read by the beaconing thread before each wait */
+static node_config_entry_t _config = {
+    .name = "beacon_interval",
+    .type = NODE_CONFIG_UINT,
+    .value = &beacon_interval,
+    .min = 1,
+    .max = 24 * 60 * 60,
+};
+#endif
 
 ssize_t name_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx)
 {
@@ -84,14 +105,18 @@ void *beaconing_thread(void *args)
     for(;;) {
         DEBUG("[DEBUG] common: sending beacon\n");
         send_coap_post((uint8_t*)"/alive", (uint8_t*)alive_msg);
-        /* wait 30 seconds */
-        xtimer_usleep(BEACON_INTERVAL);
+        xtimer_sleep(beacon_interval);
     }
     return NULL;
 }
 
 void init_beacon_sender(void)
 {
+#ifdef MODULE_NODE_CONFIG
+    node_config_register(&_config);
+#endif
+    coap_utils_init();
+
     uint8_t addr[IEEE802154_LONG_ADDRESS_LEN];
     char uid[IEEE802154_LONG_ADDRESS_LEN * 2];
     luid_get(addr, IEEE802154_LONG_ADDRESS_LEN);
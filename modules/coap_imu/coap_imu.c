@@ -1,39 +1,189 @@
 #include <inttypes.h>
+#include <stdbool.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <errno.h>
+
+#include "msg.h"
+#include "thread.h"
+#include "xtimer.h"
 
 #include "net/gcoap.h"
 
 #include "saul_reg.h"
 
-#include "debug.h"
 #define ENABLE_DEBUG   (0)
+#include "debug.h"
 
 #include "coap_common.h"
 #include "coap_utils.h"
+#include "coap_imu.h"
+#include "imu_features.h"
+#include "imu_fusion.h"
+#include "imu_capture.h"
+#include "metrics.h"
+#ifdef MODULE_COAP_BURST
+#include "coap_burst.h"
+#endif
+#ifdef MODULE_NODE_CONFIG
+#include "node_config.h"
+#endif
 
-#define IMU_INTERVAL          (200000U)      /* set imu refresh interval to 200 ms */
 #define IMU_QUEUE_SIZE        (8U)
 
+#define IMU_FRAME_NUMOF       (2U)      /* double buffering */
+
+#define IMU_MSG_FRAME         (0x3701)
+#define IMU_MSG_FEATURES      (0x3702)
+#define IMU_MSG_ORIENTATION   (0x3703)
+#define IMU_MSG_CAPTURE       (0x3704)
+
+#ifndef IMU_STACKSIZE
+#define IMU_STACKSIZE         (THREAD_STACKSIZE_DEFAULT)
+#endif
+#ifndef IMU_SEND_STACKSIZE
+#define IMU_SEND_STACKSIZE    (THREAD_STACKSIZE_DEFAULT)
+#endif
+
 static msg_t _imu_msg_queue[IMU_QUEUE_SIZE];
-static char imu_stack[THREAD_STACKSIZE_DEFAULT];
+static char imu_stack[IMU_STACKSIZE];
+
+static msg_t _imu_send_msg_queue[IMU_QUEUE_SIZE];
+static char imu_send_stack[IMU_SEND_STACKSIZE];
+static kernel_pid_t imu_send_pid = KERNEL_PID_UNDEF;
+
+/* SAUL handles are looked up once at init */
+static saul_reg_t *acc_dev = NULL;
+static saul_reg_t *gyr_dev = NULL;
 
 static phydat_t data[2];
 static uint8_t response[128];
 
+static char push_msg[320];
+
+static imu_frame_t frames[IMU_FRAME_NUMOF];
+static volatile bool frame_busy[IMU_FRAME_NUMOF];
+static uint8_t frame_seq = 0;
+static unsigned samples_dropped = 0;
+
+static volatile imu_mode_t imu_mode = IMU_MODE_DEFAULT;
+static volatile uint16_t imu_rate = IMU_SAMPLE_RATE;
+static volatile uint32_t orientation_interval = IMU_ORIENTATION_INTERVAL;
+
+void imu_set_mode(imu_mode_t mode)
+{
+    imu_mode = mode;
+}
+
+imu_mode_t imu_get_mode(void)
+{
+    return imu_mode;
+}
+
+int imu_set_rate(uint16_t rate)
+{
+    if ((rate < IMU_MIN_SAMPLE_RATE) || (rate > IMU_MAX_SAMPLE_RATE)) {
+        return -EINVAL;
+    }
+    /* applied by the sampling thread on its next period */
+    imu_rate = rate;
+    return 0;
+}
+
+uint16_t imu_get_rate(void)
+{
+    return imu_rate;
+}
+
+int imu_set_orientation_interval(uint32_t interval)
+{
+    if (interval > IMU_MAX_ORIENTATION_INTERVAL) {
+        return -EINVAL;
+    }
+    /* applied by the sampling thread on its next period */
+    orientation_interval = interval;
+    return 0;
+}
+
+uint32_t imu_get_orientation_interval(void)
+{
+    return orientation_interval;
+}
+
+#ifdef MODULE_NODE_CONFIG
+static uint32_t _config_rate = IMU_SAMPLE_RATE;
+
+static void _apply_rate(const node_config_entry_t *entry)
+{
+    (void)entry;
+    imu_set_rate(_config_rate);
+}
+
+static node_config_entry_t _config_rate_entry = {
+    .name = "imu_rate",
+    .type = NODE_CONFIG_UINT,
+    .value = &_config_rate,
+    .min = IMU_MIN_SAMPLE_RATE,
+    .max = IMU_MAX_SAMPLE_RATE,
+    .apply = _apply_rate,
+};
+
+static uint32_t _config_orientation = IMU_ORIENTATION_INTERVAL;
+
+static void _apply_orientation(const node_config_entry_t *entry)
+{
+    (void)entry;
+    imu_set_orientation_interval(_config_orientation);
+}
+
+static node_config_entry_t _config_orientation_entry = {
+    .name = "orientation_interval",
+    .type = NODE_CONFIG_UINT,
+    .value = &_config_orientation,
+    .min = 0,
+    .max = IMU_MAX_ORIENTATION_INTERVAL,
+    .apply = _apply_orientation,
+};
+#endif
+
+#ifdef MODULE_COAP_BURST
+static imu_mode_t burst_prev_mode;
+static uint16_t burst_prev_rate;
+
+static void _burst_start(uint16_t rate)
+{
+    burst_prev_mode = imu_mode;
+    burst_prev_rate = imu_rate;
+    imu_set_rate((rate < IMU_MIN_SAMPLE_RATE) ? IMU_MIN_SAMPLE_RATE : rate);
+    imu_set_mode(IMU_MODE_STREAM);
+}
+
+static void _burst_stop(void)
+{
+    imu_set_rate(burst_prev_rate);
+    imu_set_mode(burst_prev_mode);
+}
+
+static coap_burst_source_t _burst_source = {
+    .name = "imu",
+    .max_rate = IMU_MAX_SAMPLE_RATE,
+    .sample_size = sizeof(imu_frame_sample_t) +
+                   (sizeof(imu_frame_hdr_t) + 32) / IMU_FRAME_SAMPLES,
+    .start = _burst_start,
+    .stop = _burst_stop,
+};
+#endif
+
 void read_imu_values(void)
 {
-    /* get sensors */
-    saul_reg_t *acc = saul_reg_find_type(SAUL_SENSE_ACCEL);
-    saul_reg_t *gyr = saul_reg_find_type(SAUL_SENSE_GYRO);
-    if ((acc == NULL) || (gyr == NULL)) {
+    if ((acc_dev == NULL) || (gyr_dev == NULL)) {
         DEBUG("[ERROR] Unable to find sensors\n");
         return;
     }
 
-    saul_reg_read(acc, &data[0]);
-    saul_reg_read(gyr, &data[1]);
+    saul_reg_read(acc_dev, &data[0]);
+    saul_reg_read(gyr_dev, &data[1]);
     return;
 }
 
@@ -41,7 +191,7 @@ ssize_t coap_imu_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx)
 {
     (void)ctx;
     gcoap_resp_init(pdu, buf, len, COAP_CODE_CONTENT);
-    read_imu_values();
+    /* values are refreshed by the sampling thread */
     memset(response, 0, sizeof(response));
     size_t p = 0;
     p += sprintf((char*)&response[p], "imu:");
@@ -55,43 +205,208 @@ ssize_t coap_imu_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx)
     return gcoap_finish(pdu, payload_len, COAP_FORMAT_TEXT);
 }
 
+void *imu_send_thread(void *args)
+{
+    (void)args;
+    msg_t msg;
+
+    msg_init_queue(_imu_send_msg_queue, IMU_QUEUE_SIZE);
+
+    for(;;) {
+        msg_receive(&msg);
+        METRICS_PEAK(IMU_QUEUE, msg_avail() + 1);
+        if (msg.type == IMU_MSG_FEATURES) {
+            /* the windowing and FFTs run here, below the sampling thread */
+            if (!imu_features_process() || !IMU_FEATURES_PUSH ||
+                (imu_mode == IMU_MODE_CAPTURE)) {
+                continue;
+            }
+            imu_features_t features;
+            if (imu_features_get(&features)) {
+                size_t p = 0;
+                p += sprintf(&push_msg[p], "imu_features:");
+                if (imu_features_format(&push_msg[p],
+                                        sizeof(push_msg) - p,
+                                        &features) > 0) {
+                    send_coap_post((uint8_t*)"/server", (uint8_t*)push_msg);
+                }
+            }
+            continue;
+        }
+
+        if (msg.type == IMU_MSG_CAPTURE) {
+            imu_capture_send();
+            continue;
+        }
+
+        if (msg.type == IMU_MSG_ORIENTATION) {
+            imu_orientation_t orientation;
+            imu_fusion_get(&orientation);
+            size_t p = 0;
+            p += sprintf(&push_msg[p], "orientation:");
+            if (imu_fusion_format(&push_msg[p], sizeof(push_msg) - p,
+                                  &orientation) > 0) {
+                send_coap_post((uint8_t*)"/server", (uint8_t*)push_msg);
+            }
+            continue;
+        }
+
+        unsigned idx = msg.content.value;
+        imu_frame_t *frame = &frames[idx];
+        size_t len = sizeof(imu_frame_hdr_t) +
+                     frame->hdr.count * sizeof(imu_frame_sample_t);
+        send_coap_post_raw((uint8_t*)IMU_FRAME_URI, (uint8_t*)frame, len,
+                           COAP_FORMAT_OCTET);
+        frame->hdr.count = 0;
+        frame_busy[idx] = false;
+    }
+    return NULL;
+}
+
 void *imu_thread(void *args)
 {
-        (void)args;
+    (void)args;
+    unsigned idx = 0;
+    unsigned orientation_count = 0;
+    bool capture_notified = false;
+    uint16_t rate = IMU_SAMPLE_RATE;
+    uint32_t interval = US_PER_SEC / IMU_SAMPLE_RATE;
+    uint64_t frame_start = 0;
+    uint64_t last_sample = 0;
+    uint32_t last_wakeup = xtimer_now_usec();
 
     msg_init_queue(_imu_msg_queue, IMU_QUEUE_SIZE);
 
     for(;;) {
-        size_t p = 0;
-        memset(response, strlen((char*)response), 0);
+        imu_frame_t *frame = &frames[idx];
+        uint64_t now = xtimer_now_usec64();
+
+        if (rate != imu_rate) {
+            /* the feature window only holds samples of a single rate */
+            rate = imu_rate;
+            interval = US_PER_SEC / rate;
+            imu_features_init(rate);
+        }
+
         read_imu_values();
-        p += sprintf((char*)&response[p], "imu:");
-        p += sprintf((char*)&response[p],
-                 "[{\"type\":\"acc\",\"values\":[%i,%i,%i]}]",
-                 data[0].val[0], data[0].val[1], data[0].val[2]);
-        response[p] = '\0';
-        send_coap_post((uint8_t*)"/server", response);
-
-        p = 0;
-        memset(response, strlen((char*)response), 0);
-        p += sprintf((char*)&response[p], "imu:");
-        p += sprintf((char*)&response[p],
-                 "[{\"type\":\"gyro\",\"values\":[%i,%i,%i]}]",
-                 data[1].val[0], data[1].val[1], data[1].val[2]);
-        response[p] = '\0';
-        send_coap_post((uint8_t*)"/server", response);
-        /* wait 3 seconds */
-        xtimer_usleep(IMU_INTERVAL);
+
+        imu_fusion_update(&data[0], &data[1],
+                          (last_sample) ? (uint32_t)(now - last_sample) : 0);
+        last_sample = now;
+        /* in capture mode nothing is pushed while the board is idle */
+        uint32_t orientation = orientation_interval;
+        if (orientation && (imu_mode != IMU_MODE_CAPTURE) &&
+            (++orientation_count >= (rate * orientation) / MS_PER_SEC)) {
+            msg_t msg;
+            msg.type = IMU_MSG_ORIENTATION;
+            msg_try_send(&msg, imu_send_pid);
+            orientation_count = 0;
+        }
+
+        if (imu_features_add(&data[0])) {
+            msg_t msg;
+            msg.type = IMU_MSG_FEATURES;
+            msg_try_send(&msg, imu_send_pid);
+        }
+
+        if ((imu_mode != IMU_MODE_STREAM) && !frame_busy[idx]) {
+            /* drop any partially filled stream frame */
+            frame->hdr.count = 0;
+        }
+
+        if (imu_mode == IMU_MODE_CAPTURE) {
+            /* nothing is sent until motion is detected */
+            if (!imu_capture_add((uint32_t)(now / 100), &data[0], &data[1])) {
+                capture_notified = false;
+            }
+            else if (!capture_notified) {
+                /* retried on the next samples while the sender is busy */
+                msg_t msg;
+                msg.type = IMU_MSG_CAPTURE;
+                capture_notified = (msg_try_send(&msg, imu_send_pid) == 1);
+            }
+        }
+        else if (imu_mode != IMU_MODE_STREAM) {
+            /* raw samples are not sent */
+        }
+        else if (!frame_busy[idx]) {
+            if (frame->hdr.count == 0) {
+                frame_start = now;
+                frame->hdr.version = IMU_FRAME_VERSION;
+                frame->hdr.acc_scale = data[0].scale;
+                frame->hdr.gyro_scale = data[1].scale;
+                frame->hdr.timestamp = (uint32_t)(now / US_PER_MS);
+                frame->hdr.flags = 0;
+                frame->hdr.seq = frame_seq++;
+            }
+
+            imu_frame_sample_t *sample = &frame->samples[frame->hdr.count++];
+            sample->offset = (uint16_t)((now - frame_start) / 100);
+            memcpy(sample->acc, data[0].val, sizeof(sample->acc));
+            memcpy(sample->gyro, data[1].val, sizeof(sample->gyro));
+
+            if (frame->hdr.count == IMU_FRAME_SAMPLES) {
+                /* hand the full frame to the sender and switch buffers */
+                msg_t msg;
+                msg.type = IMU_MSG_FRAME;
+                msg.content.value = idx;
+                frame_busy[idx] = true;
+                if (msg_try_send(&msg, imu_send_pid) == 1) {
+                    idx = (idx + 1) % IMU_FRAME_NUMOF;
+                }
+                else {
+                    frame_busy[idx] = false;
+                    frame->hdr.count = 0;
+                    samples_dropped += IMU_FRAME_SAMPLES;
+                    METRICS_ADD(IMU_DROP, IMU_FRAME_SAMPLES);
+                }
+            }
+        }
+        else {
+            /* the sender is still busy with this buffer */
+            samples_dropped++;
+            METRICS_INC(IMU_DROP);
+            DEBUG("[DEBUG] imu: sample dropped (%u)\n", samples_dropped);
+        }
+
+        xtimer_periodic_wakeup(&last_wakeup, interval);
     }
     return NULL;
 }
 
 void init_imu_sender(void)
 {
-    /* create the sensors thread that will send periodic updates to
-       the server */
+    /* get sensors */
+    acc_dev = saul_reg_find_type(SAUL_SENSE_ACCEL);
+    gyr_dev = saul_reg_find_type(SAUL_SENSE_GYRO);
+    if ((acc_dev == NULL) || (gyr_dev == NULL)) {
+        puts("Error: unable to find IMU sensors\n");
+    }
+
+    imu_features_init(IMU_SAMPLE_RATE);
+#ifdef MODULE_NODE_CONFIG
+    node_config_register(&_config_rate_entry);
+    node_config_register(&_config_orientation_entry);
+#endif
+    imu_fusion_init();
+    imu_capture_init();
+#ifdef MODULE_COAP_BURST
+    coap_burst_register(&_burst_source);
+#endif
+
+    imu_send_pid = thread_create(imu_send_stack, sizeof(imu_send_stack),
+                                 THREAD_PRIORITY_MAIN - 1,
+                                 THREAD_CREATE_STACKTEST, imu_send_thread,
+                                 NULL, "IMU send thread");
+    if (imu_send_pid == -EINVAL || imu_send_pid == -EOVERFLOW) {
+        puts("Error: failed to create imu send thread, exiting\n");
+        return;
+    }
+
+    /* create the sampling thread, it runs above the sender so that
+       uplinks do not disturb the sampling period */
     int imu_pid = thread_create(imu_stack, sizeof(imu_stack),
-                                THREAD_PRIORITY_MAIN - 1,
+                                THREAD_PRIORITY_MAIN - 2,
                                 THREAD_CREATE_STACKTEST, imu_thread,
                                 NULL, "IMU thread");
     if (imu_pid == -EINVAL || imu_pid == -EOVERFLOW) {
@@ -9,8 +9,87 @@
 extern "C" {
 #endif
 
+#ifndef IMU_SAMPLE_RATE
+#define IMU_SAMPLE_RATE       (100U)    /* sampling rate in Hz (50-200) */
+#endif
+
+#ifndef IMU_MAX_SAMPLE_RATE
+#define IMU_MAX_SAMPLE_RATE   (200U)    /* upper bound for runtime rate changes */
+#endif
+
+#ifndef IMU_FRAME_SAMPLES
+#define IMU_FRAME_SAMPLES     (12U)     /* number of samples per uplink frame */
+#endif
+
+/* The sample offsets of a frame are 16 bit in 100us, the samples of a frame
+ * must span at most 6.5s: 2 Hz with 12 samples per frame */
+#define IMU_MIN_SAMPLE_RATE   (((IMU_FRAME_SAMPLES - 1) * 10000UL + UINT16_MAX - 1) / \
+                               UINT16_MAX)
+
+typedef enum {
+    IMU_MODE_OFF,           /* no raw samples are sent */
+    IMU_MODE_STREAM,        /* all samples are sent */
+    IMU_MODE_CAPTURE,       /* only motion triggered captures are sent */
+} imu_mode_t;
+
+#ifndef IMU_MODE_DEFAULT
+#define IMU_MODE_DEFAULT      (IMU_MODE_STREAM)
+#endif
+
+#ifndef IMU_FEATURES_PUSH
+#define IMU_FEATURES_PUSH     (0)       /* push features after each window */
+#endif
+
+#ifndef IMU_ORIENTATION_INTERVAL
+#define IMU_ORIENTATION_INTERVAL  (1000U)   /* orientation push interval in ms, 0 to disable */
+#endif
+
+#ifndef IMU_MAX_ORIENTATION_INTERVAL
+#define IMU_MAX_ORIENTATION_INTERVAL  (3600000UL) /* upper bound for runtime changes */
+#endif
+
+#define IMU_FRAME_URI         "/imu"
+#define IMU_FRAME_VERSION     (2U)
+
+#define IMU_FRAME_FLAG_CAPTURE    (0x01)    /* frame belongs to a capture */
+#define IMU_FRAME_FLAG_TRIGGER    (0x02)    /* frame contains the trigger sample */
+#define IMU_FRAME_FLAG_LAST       (0x04)    /* last frame of a capture */
+
+/* Binary uplink frame, all fields are little endian */
+typedef struct __attribute__((packed)) {
+    uint8_t version;        /* IMU_FRAME_VERSION */
+    uint8_t count;          /* number of samples in the frame */
+    int8_t acc_scale;       /* phydat scale of the accelerometer values */
+    int8_t gyro_scale;      /* phydat scale of the gyroscope values */
+    uint32_t timestamp;     /* time of the first sample in ms */
+    uint8_t flags;          /* IMU_FRAME_FLAG_* */
+    uint8_t seq;            /* frame counter, restarts for each capture */
+} imu_frame_hdr_t;
+
+typedef struct __attribute__((packed)) {
+    uint16_t offset;        /* time since frame timestamp in 100us, see
+                               IMU_MIN_SAMPLE_RATE */
+    int16_t acc[3];
+    int16_t gyro[3];
+} imu_frame_sample_t;
+
+typedef struct __attribute__((packed)) {
+    imu_frame_hdr_t hdr;
+    imu_frame_sample_t samples[IMU_FRAME_SAMPLES];
+} imu_frame_t;
+
 void read_imu_values(void);
 
+void imu_set_mode(imu_mode_t mode);
+imu_mode_t imu_get_mode(void);
+
+int imu_set_rate(uint16_t rate);
+uint16_t imu_get_rate(void);
+
+/* Orientation push interval in ms, 0 disables the push */
+int imu_set_orientation_interval(uint32_t interval);
+uint32_t imu_get_orientation_interval(void);
+
 ssize_t coap_imu_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx);
 
 void init_imu_sender(void);
@@ -0,0 +1,319 @@
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#include "irq.h"
+
+#include "net/gcoap.h"
+
+#include "coap_utils.h"
+#include "coap_imu.h"
+#include "imu_capture.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+#define BASELINE_SHIFT        (4U)      /* accelerometer baseline EMA, 1/16 */
+
+typedef struct {
+    uint32_t time;          /* in 100us */
+    int16_t acc[3];
+    int16_t gyro[3];
+} _sample_t;
+
+typedef enum {
+    CAPTURE_ARMED,          /* filling the pre-trigger ring */
+    CAPTURE_RUNNING,        /* collecting post-trigger samples */
+    CAPTURE_READY,          /* waiting to be sent */
+} _state_t;
+
+static imu_capture_config_t _config = {
+    .acc_threshold = IMU_CAPTURE_ACC_THRESHOLD,
+    .gyro_threshold = IMU_CAPTURE_GYRO_THRESHOLD,
+    .pre = IMU_CAPTURE_PRE,
+    .post = IMU_CAPTURE_POST,
+};
+static imu_capture_config_t _pending;
+static volatile bool _pending_update = false;
+
+/* the first `pre` slots are used as a ring until the trigger fires */
+static _sample_t _samples[IMU_CAPTURE_SAMPLES];
+static volatile _state_t _state = CAPTURE_ARMED;
+static uint16_t _len;
+static uint16_t _head;
+static uint16_t _trigger;
+static uint16_t _post_left;
+static int8_t _acc_scale;
+static int8_t _gyro_scale;
+
+static int32_t _baseline[3];
+static bool _baseline_valid = false;
+static unsigned _captures = 0;
+
+static void _reverse(_sample_t *s, uint16_t from, uint16_t to)
+{
+    while ((from + 1) < to) {
+        _sample_t tmp = s[from];
+        s[from++] = s[--to];
+        s[to] = tmp;
+    }
+}
+
+static void _rearm(void)
+{
+    _len = 0;
+    _head = 0;
+    _baseline_valid = false;
+    _state = CAPTURE_ARMED;
+}
+
+static bool _motion(const phydat_t *acc, const phydat_t *gyro)
+{
+    uint32_t acc_dev = 0;
+    uint32_t gyro_mag = 0;
+
+    if (!_baseline_valid) {
+        for (unsigned i = 0; i < 3; i++) {
+            _baseline[i] = acc->val[i] * (1L << BASELINE_SHIFT);
+        }
+        _baseline_valid = true;
+        return false;
+    }
+
+    for (unsigned i = 0; i < 3; i++) {
+        int32_t base = _baseline[i] >> BASELINE_SHIFT;
+        acc_dev += abs(acc->val[i] - base);
+        gyro_mag += abs(gyro->val[i]);
+        _baseline[i] += acc->val[i] - base;
+    }
+
+    return ((_config.acc_threshold && (acc_dev > _config.acc_threshold)) ||
+            (_config.gyro_threshold && (gyro_mag > _config.gyro_threshold)));
+}
+
+static void _store(uint16_t pos, uint32_t time,
+                   const phydat_t *acc, const phydat_t *gyro)
+{
+    _samples[pos].time = time;
+    memcpy(_samples[pos].acc, acc->val, sizeof(_samples[pos].acc));
+    memcpy(_samples[pos].gyro, gyro->val, sizeof(_samples[pos].gyro));
+}
+
+void imu_capture_init(void)
+{
+    _rearm();
+}
+
+int imu_capture_set_config(const imu_capture_config_t *config)
+{
+    if ((config->post == 0) ||
+        ((config->pre + config->post) > IMU_CAPTURE_SAMPLES)) {
+        return -EINVAL;
+    }
+
+    /* applied by the sampling thread on its next sample */
+    unsigned state = irq_disable();
+    _pending = *config;
+    _pending_update = true;
+    irq_restore(state);
+
+    return 0;
+}
+
+void imu_capture_get_config(imu_capture_config_t *config)
+{
+    unsigned state = irq_disable();
+    *config = (_pending_update) ? _pending : _config;
+    irq_restore(state);
+}
+
+bool imu_capture_add(uint32_t time, const phydat_t *acc, const phydat_t *gyro)
+{
+    if (_state == CAPTURE_READY) {
+        /* previous capture is still waiting to be sent */
+        return true;
+    }
+
+    if (_pending_update) {
+        unsigned state = irq_disable();
+        _config = _pending;
+        _pending_update = false;
+        irq_restore(state);
+        _rearm();
+    }
+
+    if (_state == CAPTURE_ARMED) {
+        if (!_motion(acc, gyro)) {
+            if (_config.pre) {
+                _store(_head, time, acc, gyro);
+                _head = (_head + 1) % _config.pre;
+                if (_len < _config.pre) {
+                    _len++;
+                }
+            }
+            return false;
+        }
+
+        /* trigger: unroll the ring so that the oldest sample comes first */
+        if (_len == _config.pre) {
+            _reverse(_samples, 0, _head);
+            _reverse(_samples, _head, _len);
+            _reverse(_samples, 0, _len);
+        }
+        _trigger = _len;
+        _post_left = _config.post;
+        _acc_scale = acc->scale;
+        _gyro_scale = gyro->scale;
+        _state = CAPTURE_RUNNING;
+        DEBUG("[DEBUG] imu: capture triggered with %u pre samples\n", _len);
+    }
+
+    _store(_len++, time, acc, gyro);
+    if (--_post_left) {
+        return false;
+    }
+
+    _state = CAPTURE_READY;
+    _captures++;
+    return true;
+}
+
+void imu_capture_send(void)
+{
+    imu_frame_t frame;
+    uint8_t seq = 0;
+
+    if (_state != CAPTURE_READY) {
+        return;
+    }
+
+    for (uint16_t start = 0; start < _len; start += IMU_FRAME_SAMPLES) {
+        uint16_t count = _len - start;
+        if (count > IMU_FRAME_SAMPLES) {
+            count = IMU_FRAME_SAMPLES;
+        }
+
+        uint32_t t0 = _samples[start].time;
+        frame.hdr.version = IMU_FRAME_VERSION;
+        frame.hdr.count = count;
+        frame.hdr.acc_scale = _acc_scale;
+        frame.hdr.gyro_scale = _gyro_scale;
+        frame.hdr.timestamp = t0 / 10;
+        frame.hdr.flags = IMU_FRAME_FLAG_CAPTURE;
+        frame.hdr.seq = seq++;
+        if ((_trigger >= start) && (_trigger < start + count)) {
+            frame.hdr.flags |= IMU_FRAME_FLAG_TRIGGER;
+        }
+        if (start + count == _len) {
+            frame.hdr.flags |= IMU_FRAME_FLAG_LAST;
+        }
+
+        for (uint16_t i = 0; i < count; i++) {
+            const _sample_t *s = &_samples[start + i];
+            frame.samples[i].offset = (uint16_t)(s->time - t0);
+            memcpy(frame.samples[i].acc, s->acc, sizeof(s->acc));
+            memcpy(frame.samples[i].gyro, s->gyro, sizeof(s->gyro));
+        }
+
+        size_t len = sizeof(imu_frame_hdr_t) + count * sizeof(imu_frame_sample_t);
+        send_coap_post_raw((uint8_t*)IMU_FRAME_URI, (uint8_t*)&frame, len,
+                           COAP_FORMAT_OCTET);
+    }
+
+    _rearm();
+}
+
+static const char *_mode_names[] = { "off", "stream", "capture" };
+
+static int _parse(char *payload, imu_capture_config_t *config, int *mode)
+{
+    char *saveptr = NULL;
+
+    for (char *tok = strtok_r(payload, "&,", &saveptr); tok != NULL;
+         tok = strtok_r(NULL, "&,", &saveptr)) {
+        char *val = strchr(tok, '=');
+        if (val == NULL) {
+            return -EINVAL;
+        }
+        *val++ = '\0';
+
+        if (strcmp(tok, "mode") == 0) {
+            *mode = -1;
+            for (unsigned i = 0; i < sizeof(_mode_names) / sizeof(_mode_names[0]); i++) {
+                if (strcmp(val, _mode_names[i]) == 0) {
+                    *mode = i;
+                }
+            }
+            if (*mode < 0) {
+                return -EINVAL;
+            }
+            continue;
+        }
+
+        long v = strtol(val, NULL, 10);
+        if ((v < 0) || (v > UINT16_MAX)) {
+            return -EINVAL;
+        }
+        if (strcmp(tok, "acc") == 0) {
+            config->acc_threshold = v;
+        }
+        else if (strcmp(tok, "gyro") == 0) {
+            config->gyro_threshold = v;
+        }
+        else if (strcmp(tok, "pre") == 0) {
+            config->pre = v;
+        }
+        else if (strcmp(tok, "post") == 0) {
+            config->post = v;
+        }
+        else {
+            return -EINVAL;
+        }
+    }
+
+    return 0;
+}
+
+ssize_t imu_capture_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx)
+{
+    (void)ctx;
+    imu_capture_config_t config;
+    char payload[64] = { 0 };
+    unsigned method_flag = coap_method2flag(coap_get_code_detail(pdu));
+
+    imu_capture_get_config(&config);
+
+    if (method_flag & (COAP_PUT | COAP_POST)) {
+        int mode = imu_get_mode();
+        if (pdu->payload_len >= sizeof(payload)) {
+            return coap_reply_simple(pdu, COAP_CODE_REQUEST_ENTITY_TOO_LARGE,
+                                     buf, len, COAP_FORMAT_TEXT, NULL, 0);
+        }
+        memcpy(payload, pdu->payload, pdu->payload_len);
+        if ((_parse(payload, &config, &mode) < 0) ||
+            (imu_capture_set_config(&config) < 0)) {
+            DEBUG("[ERROR] imu: invalid capture configuration\n");
+            return coap_reply_simple(pdu, COAP_CODE_BAD_REQUEST, buf, len,
+                                     COAP_FORMAT_TEXT, NULL, 0);
+        }
+        imu_set_mode(mode);
+        return coap_reply_simple(pdu, COAP_CODE_CHANGED, buf, len,
+                                 COAP_FORMAT_TEXT, NULL, 0);
+    }
+
+    gcoap_resp_init(pdu, buf, len, COAP_CODE_CONTENT);
+    int n = snprintf((char*)pdu->payload, pdu->payload_len,
+                     "{\"mode\":\"%s\",\"acc\":%u,\"gyro\":%u,\"pre\":%u,"
+                     "\"post\":%u,\"max\":%u,\"captures\":%u}",
+                     _mode_names[imu_get_mode()],
+                     config.acc_threshold, config.gyro_threshold,
+                     config.pre, config.post, IMU_CAPTURE_SAMPLES, _captures);
+    if ((n < 0) || ((size_t)n >= pdu->payload_len)) {
+        n = 0;
+    }
+
+    return gcoap_finish(pdu, n, COAP_FORMAT_JSON);
+}
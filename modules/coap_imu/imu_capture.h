@@ -0,0 +1,61 @@
+#ifndef IMU_CAPTURE_H
+#define IMU_CAPTURE_H
+
+#include <stdbool.h>
+#include <inttypes.h>
+
+#include "phydat.h"
+#include "net/gcoap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef IMU_CAPTURE_SAMPLES
+#define IMU_CAPTURE_SAMPLES       (128U)    /* max pre + post trigger samples */
+#endif
+
+#ifndef IMU_CAPTURE_PRE
+#define IMU_CAPTURE_PRE           (32U)     /* default pre-trigger samples */
+#endif
+
+#ifndef IMU_CAPTURE_POST
+#define IMU_CAPTURE_POST          (96U)     /* default post-trigger samples */
+#endif
+
+#ifndef IMU_CAPTURE_ACC_THRESHOLD
+#define IMU_CAPTURE_ACC_THRESHOLD (150U)    /* accelerometer deviation, phydat units */
+#endif
+
+#ifndef IMU_CAPTURE_GYRO_THRESHOLD
+#define IMU_CAPTURE_GYRO_THRESHOLD (0U)     /* gyroscope magnitude, 0 to disable */
+#endif
+
+typedef struct {
+    uint16_t acc_threshold;     /* sum of absolute deviations from the
+                                   accelerometer baseline */
+    uint16_t gyro_threshold;    /* sum of absolute gyroscope values */
+    uint16_t pre;               /* samples kept before the trigger */
+    uint16_t post;              /* samples taken from the trigger on */
+} imu_capture_config_t;
+
+void imu_capture_init(void);
+
+int imu_capture_set_config(const imu_capture_config_t *config);
+void imu_capture_get_config(imu_capture_config_t *config);
+
+/* Feed a sample, time is in 100us. Returns true while a complete capture
+   window is pending, it must then be sent with imu_capture_send(). The
+   samples fed meanwhile are dropped. */
+bool imu_capture_add(uint32_t time, const phydat_t *acc, const phydat_t *gyro);
+
+/* Send a complete capture as a sequence of frames and re-arm the trigger */
+void imu_capture_send(void);
+
+ssize_t imu_capture_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IMU_CAPTURE_H */
@@ -0,0 +1,356 @@
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "irq.h"
+#include "mutex.h"
+#include "xtimer.h"
+
+#include "net/gcoap.h"
+
+#include "imu_features.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+#define FFT_TABLE_SIZE      (256U)
+#define FFT_HEADROOM_BITS   (14U)
+
+#if (IMU_FEATURES_WINDOW > FFT_TABLE_SIZE) || \
+    (IMU_FEATURES_WINDOW & (IMU_FEATURES_WINDOW - 1))
+#error "IMU_FEATURES_WINDOW must be a power of 2 <= 256"
+#endif
+
+/* quarter wave of sin(2 * pi * i / 256) in Q15 */
+static const int16_t _sin_table[FFT_TABLE_SIZE / 4 + 1] = {
+        0,   804,  1608,  2411,  3212,  4011,  4808,  5602,
+     6393,  7180,  7962,  8740,  9512, 10279, 11039, 11793,
+    12540, 13279, 14010, 14733, 15447, 16151, 16846, 17531,
+    18205, 18868, 19520, 20160, 20788, 21403, 22006, 22595,
+    23170, 23732, 24279, 24812, 25330, 25833, 26320, 26791,
+    27246, 27684, 28106, 28511, 28899, 29269, 29622, 29957,
+    30274, 30572, 30853, 31114, 31357, 31581, 31786, 31972,
+    32138, 32286, 32413, 32522, 32610, 32679, 32729, 32758,
+    32767,
+};
+
+static const uint16_t _bands[] = IMU_FEATURES_BANDS;
+
+/* RAM is bounded by the window: a window being collected, a completed one
+   and the FFT workspace */
+static int16_t _window[2][3][IMU_FEATURES_WINDOW];
+static int16_t _re[IMU_FEATURES_WINDOW];
+static int16_t _im[IMU_FEATURES_WINDOW];
+static unsigned _count = 0;
+static uint16_t _rate;
+
+/* window being collected, and the completed window waiting for or under
+   processing (-1 if none), shared with the processing thread */
+static unsigned _fill = 0;
+static volatile int _ready = -1;
+static volatile int _busy = -1;
+static uint16_t _ready_rate;
+static int8_t _ready_scale;
+
+static imu_features_t _features;
+static bool _features_valid = false;
+static mutex_t _lock = MUTEX_INIT;
+
+static int16_t _sin_q15(unsigned i)
+{
+    i %= FFT_TABLE_SIZE;
+    if (i <= FFT_TABLE_SIZE / 4) {
+        return _sin_table[i];
+    }
+    if (i <= FFT_TABLE_SIZE / 2) {
+        return _sin_table[FFT_TABLE_SIZE / 2 - i];
+    }
+    if (i <= 3 * FFT_TABLE_SIZE / 4) {
+        return -_sin_table[i - FFT_TABLE_SIZE / 2];
+    }
+    return -_sin_table[FFT_TABLE_SIZE - i];
+}
+
+static int16_t _cos_q15(unsigned i)
+{
+    return _sin_q15(i + FFT_TABLE_SIZE / 4);
+}
+
+static uint32_t _isqrt(uint32_t x)
+{
+    uint32_t res = 0;
+    uint32_t bit = 1UL << 30;
+
+    while (bit > x) {
+        bit >>= 2;
+    }
+    while (bit) {
+        if (x >= res + bit) {
+            x -= res + bit;
+            res = (res >> 1) + bit;
+        }
+        else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+    return res;
+}
+
+/* In-place radix-2 decimation in time FFT. Each stage is scaled by 1/2, so
+   the output is the DFT divided by n. Inputs must fit in FFT_HEADROOM_BITS. */
+static void _fft(int16_t *re, int16_t *im, unsigned n)
+{
+    for (unsigned i = 1, j = 0; i < n; i++) {
+        unsigned bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            int16_t tmp = re[i]; re[i] = re[j]; re[j] = tmp;
+            tmp = im[i]; im[i] = im[j]; im[j] = tmp;
+        }
+    }
+
+    for (unsigned l = 2; l <= n; l <<= 1) {
+        unsigned half = l >> 1;
+        unsigned step = FFT_TABLE_SIZE / l;
+        for (unsigned k = 0; k < half; k++) {
+            int32_t wr = _cos_q15(k * step);
+            int32_t wi = -_sin_q15(k * step);
+            for (unsigned i = k; i < n; i += l) {
+                unsigned j = i + half;
+                int32_t tr = (wr * re[j] - wi * im[j]) >> 15;
+                int32_t ti = (wr * im[j] + wi * re[j]) >> 15;
+                int32_t ur = re[i];
+                int32_t ui = im[i];
+                re[i] = (ur + tr) >> 1;
+                im[i] = (ui + ti) >> 1;
+                re[j] = (ur - tr) >> 1;
+                im[j] = (ui - ti) >> 1;
+            }
+        }
+    }
+}
+
+static inline int32_t _windowed(int32_t dev, unsigned i)
+{
+    int32_t hann = (32767 - _cos_q15(i * (FFT_TABLE_SIZE / IMU_FEATURES_WINDOW))) >> 1;
+    return (dev * hann) >> 15;
+}
+
+static void _process_axis(const int16_t *x, imu_features_t *f, unsigned axis)
+{
+    const unsigned n = IMU_FEATURES_WINDOW;
+
+    int32_t sum = 0;
+    for (unsigned i = 0; i < n; i++) {
+        sum += x[i];
+    }
+    int32_t mean = sum / (int32_t)n;
+
+    /* time domain features */
+    uint64_t sumsq = 0;
+    uint32_t peak = 0;
+    uint32_t max = 0;
+    for (unsigned i = 0; i < n; i++) {
+        int32_t dev = x[i] - mean;
+        uint32_t mag = (dev < 0) ? -dev : dev;
+        sumsq += (uint64_t)mag * mag;
+        if (mag > peak) {
+            peak = mag;
+        }
+        int32_t w = _windowed(dev, i);
+        mag = (w < 0) ? -w : w;
+        if (mag > max) {
+            max = mag;
+        }
+    }
+
+    uint64_t ms = sumsq / n;
+    uint32_t rms = _isqrt((ms > UINT32_MAX) ? UINT32_MAX : (uint32_t)ms);
+    f->rms[axis] = (rms > UINT16_MAX) ? UINT16_MAX : rms;
+    f->peak[axis] = (peak > UINT16_MAX) ? UINT16_MAX : peak;
+    f->crest[axis] = (rms) ? (uint16_t)((peak * 100UL) / rms) : 0;
+
+    /* block floating point: scale the windowed input to use the FFT
+       headroom, the shift is removed again from the band energies */
+    int shift = 0;
+    while ((max << 1) < (1UL << FFT_HEADROOM_BITS) && max && shift < 14) {
+        max <<= 1;
+        shift++;
+    }
+    while (max >= (1UL << FFT_HEADROOM_BITS)) {
+        max >>= 1;
+        shift--;
+    }
+    for (unsigned i = 0; i < n; i++) {
+        int32_t w = _windowed(x[i] - mean, i);
+        _re[i] = (shift >= 0) ? (w * (1L << shift)) : (w >> -shift);
+        _im[i] = 0;
+    }
+
+    _fft(_re, _im, n);
+
+    /* one-sided mean square per band: 2 * |X[k] / n|^2, with the Hann
+       power correction of 8/3 */
+    for (unsigned b = 0; b < IMU_FEATURES_BANDS_NUMOF; b++) {
+        unsigned lo = ((uint32_t)_bands[b] * n) / f->rate;
+        unsigned hi = ((uint32_t)_bands[b + 1] * n) / f->rate;
+        if (lo < 1) {
+            lo = 1;
+        }
+        if (hi > n / 2) {
+            hi = n / 2;
+        }
+        uint64_t acc = 0;
+        for (unsigned k = lo; k < hi; k++) {
+            acc += (uint64_t)((int32_t)_re[k] * _re[k]) +
+                   (uint64_t)((int32_t)_im[k] * _im[k]);
+        }
+        acc = (acc * 16) / 3;
+        acc = (shift >= 0) ? (acc >> (2 * shift)) : (acc << (-2 * shift));
+        f->energy[axis][b] = (acc > UINT32_MAX) ? UINT32_MAX : (uint32_t)acc;
+    }
+}
+
+void imu_features_init(uint16_t rate)
+{
+    mutex_lock(&_lock);
+    _rate = rate;
+    _count = 0;
+    _ready = -1;
+    _features_valid = false;
+    mutex_unlock(&_lock);
+}
+
+bool imu_features_add(const phydat_t *acc)
+{
+    for (unsigned axis = 0; axis < 3; axis++) {
+        _window[_fill][axis][_count] = acc->val[axis];
+    }
+    if (++_count < IMU_FEATURES_WINDOW) {
+        return false;
+    }
+    _count = 0;
+
+    unsigned state = irq_disable();
+    if (_busy == (int)(_fill ^ 1)) {
+        /* the other buffer is still processed, this window is lost */
+        irq_restore(state);
+        DEBUG("[DEBUG] imu: features window dropped\n");
+        return false;
+    }
+    /* a window that was not processed yet is replaced by this one */
+    _ready = _fill;
+    _ready_rate = _rate;
+    _ready_scale = acc->scale;
+    _fill ^= 1;
+    irq_restore(state);
+
+    return true;
+}
+
+bool imu_features_process(void)
+{
+    unsigned state = irq_disable();
+    int idx = _ready;
+    _busy = idx;
+    _ready = -1;
+    imu_features_t features;
+    features.rate = _ready_rate;
+    features.scale = _ready_scale;
+    irq_restore(state);
+
+    if (idx < 0) {
+        return false;
+    }
+
+    /* the sampling thread preempts the processing, compute_time includes
+       its runs */
+    uint32_t start = xtimer_now_usec();
+    for (unsigned axis = 0; axis < 3; axis++) {
+        _process_axis(_window[idx][axis], &features, axis);
+    }
+    uint32_t now = xtimer_now_usec();
+    features.compute_time = now - start;
+    features.timestamp = now / US_PER_MS;
+    DEBUG("[DEBUG] imu: features computed in %" PRIu32 "us\n",
+          features.compute_time);
+
+    mutex_lock(&_lock);
+    memcpy(&_features, &features, sizeof(_features));
+    _features_valid = true;
+    mutex_unlock(&_lock);
+
+    _busy = -1;
+    return true;
+}
+
+bool imu_features_get(imu_features_t *features)
+{
+    mutex_lock(&_lock);
+    bool valid = _features_valid;
+    if (valid) {
+        memcpy(features, &_features, sizeof(_features));
+    }
+    mutex_unlock(&_lock);
+    return valid;
+}
+
+size_t imu_features_format(char *buf, size_t len, const imu_features_t *f)
+{
+    size_t p = 0;
+
+#define _APPEND(...)                                               \
+    do {                                                           \
+        int _n = snprintf(&buf[p], len - p, __VA_ARGS__);          \
+        if ((_n < 0) || ((size_t)_n >= len - p)) {                 \
+            return 0;                                              \
+        }                                                          \
+        p += _n;                                                   \
+    } while (0)
+
+    _APPEND("{\"n\":%u,\"fs\":%u,\"scale\":%i,\"t\":%" PRIu32,
+            IMU_FEATURES_WINDOW, f->rate, f->scale, f->compute_time);
+    _APPEND(",\"rms\":[%u,%u,%u]", f->rms[0], f->rms[1], f->rms[2]);
+    _APPEND(",\"peak\":[%u,%u,%u]", f->peak[0], f->peak[1], f->peak[2]);
+    _APPEND(",\"crest\":[%u,%u,%u]", f->crest[0], f->crest[1], f->crest[2]);
+    _APPEND(",\"bands\":[");
+    for (unsigned b = 0; b <= IMU_FEATURES_BANDS_NUMOF; b++) {
+        _APPEND("%s%u", (b) ? "," : "", _bands[b]);
+    }
+    _APPEND("],\"e\":[");
+    for (unsigned b = 0; b < IMU_FEATURES_BANDS_NUMOF; b++) {
+        _APPEND("%s[%" PRIu32 ",%" PRIu32 ",%" PRIu32 "]", (b) ? "," : "",
+                f->energy[0][b], f->energy[1][b], f->energy[2][b]);
+    }
+    _APPEND("]}");
+
+#undef _APPEND
+
+    return p;
+}
+
+ssize_t imu_features_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx)
+{
+    (void)ctx;
+    imu_features_t features;
+
+    if (!imu_features_get(&features)) {
+        return coap_reply_simple(pdu, COAP_CODE_SERVICE_UNAVAILABLE, buf, len,
+                                 COAP_FORMAT_TEXT, NULL, 0);
+    }
+
+    gcoap_resp_init(pdu, buf, len, COAP_CODE_CONTENT);
+    size_t payload_len = imu_features_format((char*)pdu->payload,
+                                             pdu->payload_len, &features);
+    if (payload_len == 0) {
+        return coap_reply_simple(pdu, COAP_CODE_INTERNAL_SERVER_ERROR, buf, len,
+                                 COAP_FORMAT_TEXT, NULL, 0);
+    }
+
+    return gcoap_finish(pdu, payload_len, COAP_FORMAT_JSON);
+}
@@ -0,0 +1,56 @@
+#ifndef IMU_FEATURES_H
+#define IMU_FEATURES_H
+
+#include <stdbool.h>
+#include <inttypes.h>
+
+#include "phydat.h"
+#include "net/gcoap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef IMU_FEATURES_WINDOW
+#define IMU_FEATURES_WINDOW       (128U)    /* samples per window, power of 2 <= 256 */
+#endif
+
+#ifndef IMU_FEATURES_BANDS
+#define IMU_FEATURES_BANDS        { 0, 5, 10, 20, 50 }  /* band edges in Hz */
+#endif
+
+#define IMU_FEATURES_BANDS_NUMOF  (sizeof((uint16_t[])IMU_FEATURES_BANDS) / \
+                                   sizeof(uint16_t) - 1)
+
+typedef struct {
+    uint32_t timestamp;         /* end of the window in ms */
+    uint32_t compute_time;      /* processing time of the window in us */
+    uint16_t rate;              /* sampling rate of the window in Hz */
+    int8_t scale;               /* phydat scale of rms, peak and energies */
+    uint16_t rms[3];            /* RMS around the window mean */
+    uint16_t peak[3];           /* max deviation from the window mean */
+    uint16_t crest[3];          /* peak / rms, x100 */
+    uint32_t energy[3][IMU_FEATURES_BANDS_NUMOF];   /* mean square per band */
+} imu_features_t;
+
+void imu_features_init(uint16_t rate);
+
+/* Add an accelerometer sample, returns true when a window was completed.
+   The window is then kept aside for imu_features_process() and the next
+   one is collected in a second buffer. */
+bool imu_features_add(const phydat_t *acc);
+
+/* Compute the features of the last completed window, outside of the
+   sampling thread. Returns false when there was no window to process. */
+bool imu_features_process(void);
+
+bool imu_features_get(imu_features_t *features);
+size_t imu_features_format(char *buf, size_t len, const imu_features_t *features);
+
+ssize_t imu_features_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IMU_FEATURES_H */
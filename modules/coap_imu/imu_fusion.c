@@ -0,0 +1,247 @@
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "irq.h"
+#include "xtimer.h"
+
+#include "net/gcoap.h"
+
+#include "imu_fusion.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+/* angles are kept in micro-degrees internally */
+#define UDEG_180              (180000000L)
+#define UDEG_360              (360000000L)
+
+#define CORDIC_ITERATIONS     (20U)
+#define CORDIC_INPUT_BITS     (28U)
+
+/* accelerometer correction is skipped outside 0.5g..1.5g */
+#define ACC_NORM_MIN          (500L)
+#define ACC_NORM_MAX          (1500L)
+
+/* atan(2^-i) in micro-degrees */
+static const int32_t _atan_table[CORDIC_ITERATIONS] = {
+    45000000, 26565051, 14036243, 7125016, 3576334,
+    1789911, 895174, 447614, 223811, 111906,
+    55953, 27976, 13988, 6994, 3497,
+    1749, 874, 437, 219, 109
+};
+
+static int32_t _roll;
+static int32_t _pitch;
+static int32_t _yaw;
+static bool _primed = false;
+static imu_orientation_t _orientation;
+
+static int32_t _to_milli(int16_t val, int8_t scale)
+{
+    int32_t v = val;
+    int e = scale + 3;
+    while (e > 0) {
+        v *= 10;
+        e--;
+    }
+    while (e < 0) {
+        v /= 10;
+        e++;
+    }
+    return v;
+}
+
+static uint32_t _isqrt(uint32_t x)
+{
+    uint32_t res = 0;
+    uint32_t bit = 1UL << 30;
+
+    while (bit > x) {
+        bit >>= 2;
+    }
+    while (bit) {
+        if (x >= res + bit) {
+            x -= res + bit;
+            res = (res >> 1) + bit;
+        }
+        else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+    return res;
+}
+
+static int32_t _wrap(int32_t angle)
+{
+    while (angle > UDEG_180) {
+        angle -= UDEG_360;
+    }
+    while (angle <= -UDEG_180) {
+        angle += UDEG_360;
+    }
+    return angle;
+}
+
+/* CORDIC vectoring mode atan2, result in micro-degrees */
+static int32_t _atan2(int32_t y, int32_t x)
+{
+    int32_t angle = 0;
+
+    if ((x == 0) && (y == 0)) {
+        return 0;
+    }
+
+    /* use the full input range for precision */
+    while ((x < (1L << CORDIC_INPUT_BITS)) && (x > -(1L << CORDIC_INPUT_BITS)) &&
+           (y < (1L << CORDIC_INPUT_BITS)) && (y > -(1L << CORDIC_INPUT_BITS))) {
+        x *= 2;
+        y *= 2;
+    }
+
+    /* rotate into the right half plane */
+    if (x < 0) {
+        angle = (y >= 0) ? UDEG_180 : -UDEG_180;
+        x = -x;
+        y = -y;
+    }
+
+    for (unsigned i = 0; i < CORDIC_ITERATIONS; i++) {
+        int32_t xn;
+        if (y > 0) {
+            xn = x + (y >> i);
+            y = y - (x >> i);
+            angle += _atan_table[i];
+        }
+        else {
+            xn = x - (y >> i);
+            y = y + (x >> i);
+            angle -= _atan_table[i];
+        }
+        x = xn;
+    }
+
+    return _wrap(angle);
+}
+
+static int32_t _integrate(int32_t angle, int32_t rate, uint32_t dt)
+{
+    /* rate in milli-degrees per second, dt in us */
+    return _wrap(angle + (int32_t)(((int64_t)rate * dt) / 1000));
+}
+
+static int32_t _correct(int32_t angle, int32_t measured)
+{
+    int32_t err = _wrap(measured - angle);
+    return _wrap(angle + (int32_t)(((int64_t)err * IMU_FUSION_ALPHA) >> 15));
+}
+
+void imu_fusion_init(void)
+{
+    _roll = 0;
+    _pitch = 0;
+    _yaw = 0;
+    _primed = false;
+    memset(&_orientation, 0, sizeof(_orientation));
+}
+
+void imu_fusion_update(const phydat_t *acc, const phydat_t *gyro, uint32_t dt)
+{
+    int32_t ax = _to_milli(acc->val[0], acc->scale);
+    int32_t ay = _to_milli(acc->val[1], acc->scale);
+    int32_t az = _to_milli(acc->val[2], acc->scale);
+    uint32_t ayz = _isqrt((uint32_t)(ay * ay) + (uint32_t)(az * az));
+    uint32_t norm = _isqrt((uint32_t)(ax * ax) + ayz * ayz);
+
+    int32_t acc_roll = _atan2(ay, az);
+    int32_t acc_pitch = _atan2(-ax, (int32_t)ayz);
+
+    if (!_primed) {
+        /* start from the accelerometer attitude */
+        _roll = acc_roll;
+        _pitch = acc_pitch;
+        _primed = true;
+    }
+    else {
+        _roll = _integrate(_roll, _to_milli(gyro->val[0], gyro->scale), dt);
+        _pitch = _integrate(_pitch, _to_milli(gyro->val[1], gyro->scale), dt);
+        _yaw = _integrate(_yaw, _to_milli(gyro->val[2], gyro->scale), dt);
+
+        if ((norm > ACC_NORM_MIN) && (norm < ACC_NORM_MAX)) {
+            _roll = _correct(_roll, acc_roll);
+            _pitch = _correct(_pitch, acc_pitch);
+        }
+    }
+
+    imu_orientation_t orientation = {
+        .roll = _roll / 1000,
+        .pitch = _pitch / 1000,
+        .yaw = _yaw / 1000,
+        .timestamp = xtimer_now_usec() / US_PER_MS,
+    };
+
+    unsigned state = irq_disable();
+    _orientation = orientation;
+    irq_restore(state);
+}
+
+void imu_fusion_get(imu_orientation_t *orientation)
+{
+    unsigned state = irq_disable();
+    *orientation = _orientation;
+    irq_restore(state);
+}
+
+static size_t _format_angle(char *buf, size_t len, int32_t angle)
+{
+    bool negative = (angle < 0);
+    if (negative) {
+        angle = -angle;
+    }
+    int n = snprintf(buf, len, "%s%" PRId32 ".%02" PRId32,
+                     (negative) ? "-" : "", angle / 1000, (angle % 1000) / 10);
+    return ((n < 0) || ((size_t)n >= len)) ? 0 : (size_t)n;
+}
+
+size_t imu_fusion_format(char *buf, size_t len, const imu_orientation_t *o)
+{
+    const char *keys[] = { "{\"roll\":", ",\"pitch\":", ",\"yaw\":" };
+    const int32_t values[] = { o->roll, o->pitch, o->yaw };
+    size_t p = 0;
+
+    for (unsigned i = 0; i < 3; i++) {
+        size_t n = strlen(keys[i]);
+        if (p + n >= len) {
+            return 0;
+        }
+        memcpy(&buf[p], keys[i], n);
+        p += n;
+        n = _format_angle(&buf[p], len - p, values[i]);
+        if (n == 0) {
+            return 0;
+        }
+        p += n;
+    }
+    if (p + 2 > len) {
+        return 0;
+    }
+    buf[p++] = '}';
+    buf[p] = '\0';
+
+    return p;
+}
+
+ssize_t imu_orientation_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx)
+{
+    (void)ctx;
+    imu_orientation_t orientation;
+
+    imu_fusion_get(&orientation);
+    gcoap_resp_init(pdu, buf, len, COAP_CODE_CONTENT);
+    size_t payload_len = imu_fusion_format((char*)pdu->payload,
+                                           pdu->payload_len, &orientation);
+
+    return gcoap_finish(pdu, payload_len, COAP_FORMAT_JSON);
+}
@@ -0,0 +1,40 @@
+#ifndef IMU_FUSION_H
+#define IMU_FUSION_H
+
+#include <inttypes.h>
+
+#include "phydat.h"
+#include "net/gcoap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef IMU_FUSION_ALPHA
+#define IMU_FUSION_ALPHA      (655)     /* accelerometer weight per update, Q15 */
+#endif
+
+/* Orientation in milli-degrees, yaw is only integrated from the gyroscope */
+typedef struct {
+    int32_t roll;
+    int32_t pitch;
+    int32_t yaw;
+    uint32_t timestamp;     /* time of the last update in ms */
+} imu_orientation_t;
+
+void imu_fusion_init(void);
+
+/* Fuse one accelerometer/gyroscope sample, dt is the time since the
+   previous sample in us */
+void imu_fusion_update(const phydat_t *acc, const phydat_t *gyro, uint32_t dt);
+
+void imu_fusion_get(imu_orientation_t *orientation);
+size_t imu_fusion_format(char *buf, size_t len, const imu_orientation_t *orientation);
+
+ssize_t imu_orientation_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IMU_FUSION_H */
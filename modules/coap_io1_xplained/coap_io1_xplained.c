@@ -22,8 +22,12 @@
 
 #define IO1_XPLAINED_QUEUE_SIZE    (8)
 
+#ifndef IO1_XPLAINED_STACKSIZE
+#define IO1_XPLAINED_STACKSIZE     (THREAD_STACKSIZE_DEFAULT)
+#endif
+
 static msg_t _io1_xplained_msg_queue[IO1_XPLAINED_QUEUE_SIZE];
-static char io1_xplained_stack[THREAD_STACKSIZE_DEFAULT];
+static char io1_xplained_stack[IO1_XPLAINED_STACKSIZE];
 
 static char response[64];
 
@@ -44,17 +48,9 @@ ssize_t io1_xplained_temperature_handler(coap_pkt_t* pdu, uint8_t *buf, size_t l
     return gcoap_finish(pdu, payload_len, COAP_FORMAT_TEXT);
 }
 
-void read_io1_xplained_temperature(int16_t *temperature)
+int16_t io1_xplained_temperature_convert(const uint8_t *raw)
 {
-    char buffer[2] = { 0 };
-    /* read temperature register on I2C bus */
-    if (i2c_read_bytes(I2C_INTERFACE, SENSOR_ADDR, buffer, 2, 0) < 0) {
-        printf("Error: cannot read at address %i on I2C interface %i\n",
-               SENSOR_ADDR, I2C_INTERFACE);
-        return;
-    }
-    
-    uint16_t data = (buffer[0] << 8) | buffer[1];
+    uint16_t data = (raw[0] << 8) | raw[1];
     int8_t sign = 1;
     /* Check if negative and clear sign bit. */
     if (data & (1 << 15)) {
@@ -63,7 +59,20 @@ void read_io1_xplained_temperature(int16_t *temperature)
     }
     /* Convert to temperature */
     data = (data >> 5);
-    *temperature = data * sign * 0.125;
+    return data * sign * 0.125;
+}
+
+void read_io1_xplained_temperature(int16_t *temperature)
+{
+    uint8_t buffer[2] = { 0 };
+    /* read temperature register on I2C bus */
+    if (i2c_read_bytes(I2C_INTERFACE, SENSOR_ADDR, buffer, 2, 0) < 0) {
+        printf("Error: cannot read at address %i on I2C interface %i\n",
+               SENSOR_ADDR, I2C_INTERFACE);
+        return;
+    }
+
+    *temperature = io1_xplained_temperature_convert(buffer);
 
     return;
 }
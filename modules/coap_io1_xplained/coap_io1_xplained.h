@@ -13,6 +13,10 @@ ssize_t io1_xplained_temperature_handler(coap_pkt_t* pdu, uint8_t *buf, size_t l
 
 void read_io1_xplained_temperature(int16_t* temperature);
 
+/* Temperature in °C of the two bytes of the temperature register, the
+ * sign bit comes first and the 1/8 °C fraction in the low bits */
+int16_t io1_xplained_temperature_convert(const uint8_t *raw);
+
 void init_io1_xplained_temperature_sender(void);
 
 #ifdef __cplusplus
@@ -0,0 +1,274 @@
+#include <ctype.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "irq.h"
+#include "phydat.h"
+#include "saul_reg.h"
+
+#include "net/gcoap.h"
+
+#include "coap_utils.h"
+#include "sensor_bus.h"
+#include "metrics.h"
+#include "trace.h"
+#include "coap_saul.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+#define COAP_SAUL_NAME_LEN    (16U)
+#define COAP_SAUL_PATH_LEN    (24U)
+#define COAP_SAUL_CAT_MASK    (0xc0)
+
+typedef struct {
+    saul_reg_t *reg;
+    char key[COAP_SAUL_PATH_LEN];   /* "name" or "name/index" */
+    char path[COAP_SAUL_PATH_LEN];  /* "/" key */
+    phydat_t cache;
+    uint8_t dim;                    /* 0 until the first read */
+    bool sensor;
+} coap_saul_entry_t;
+
+/* keep the resource names of the dedicated modules */
+static const struct {
+    uint8_t type;
+    const char *name;
+} _names[] = {
+    { SAUL_SENSE_TEMP, "temperature" },
+    { SAUL_SENSE_HUM, "humidity" },
+    { SAUL_SENSE_PRESS, "pressure" },
+    { SAUL_SENSE_LIGHT, "illuminance" },
+    { SAUL_SENSE_CO2, "eco2" },
+    { SAUL_SENSE_TVOC, "tvoc" },
+};
+
+static coap_saul_entry_t _entries[COAP_SAUL_NUMOF];
+static unsigned _numof = 0;
+static coap_batch_t batch;
+static uint8_t response[64];
+
+static coap_resource_t _resources[COAP_SAUL_NUMOF];
+static gcoap_listener_t _listener = { &_resources[0], 0, NULL };
+
+static void _class_name(uint8_t type, char *name)
+{
+    for (unsigned i = 0; i < sizeof(_names) / sizeof(_names[0]); i++) {
+        if (_names[i].type == type) {
+            strncpy(name, _names[i].name, COAP_SAUL_NAME_LEN - 1);
+            return;
+        }
+    }
+
+    /* "SENSE_ACCEL" becomes "accel" */
+    const char *str = saul_class_to_str(type);
+    const char *sep = (str) ? strchr(str, '_') : NULL;
+    str = (sep) ? sep + 1 : "saul";
+    unsigned i = 0;
+    for (; (str[i] != '\0') && (i < COAP_SAUL_NAME_LEN - 1); i++) {
+        name[i] = tolower((unsigned char)str[i]);
+    }
+    name[i] = '\0';
+}
+
+static size_t _format_val(char *buf, int16_t val, int8_t scale)
+{
+    int32_t v = val;
+    if (scale >= 0) {
+        for (int i = 0; (i < scale) && (i < 4); i++) {
+            v *= 10;
+        }
+        return sprintf(buf, "%" PRIi32, v);
+    }
+
+    int digits = (-scale < 5) ? -scale : 5;
+    int32_t div = 1;
+    for (int i = 0; i < digits; i++) {
+        div *= 10;
+    }
+    bool negative = (v < 0);
+    if (negative) {
+        v = -v;
+    }
+    return sprintf(buf, "%s%" PRIi32 ".%0*" PRIi32, (negative) ? "-" : "",
+                   v / div, digits, v % div);
+}
+
+/* "21.50°C", or "[1,-2,998]mg" for multi dimensional values */
+static size_t _format(char *buf, const phydat_t *data, uint8_t dim)
+{
+    size_t p = 0;
+    if (dim > 1) {
+        buf[p++] = '[';
+    }
+    for (uint8_t i = 0; i < dim; i++) {
+        if (i > 0) {
+            buf[p++] = ',';
+        }
+        p += _format_val(&buf[p], data->val[i], data->scale);
+    }
+    if (dim > 1) {
+        buf[p++] = ']';
+    }
+    const char *unit = phydat_unit_to_str(data->unit);
+    if (unit == NULL) {
+        unit = "";
+    }
+    p += sprintf(&buf[p], "%s", unit);
+    return p;
+}
+
+static ssize_t _saul_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx)
+{
+    coap_saul_entry_t *entry = ctx;
+    unsigned method_flag = coap_method2flag(coap_get_code_detail(pdu));
+
+    if (method_flag & COAP_PUT) {
+        char payload[8] = { 0 };
+        if (entry->sensor || (pdu->payload_len >= sizeof(payload))) {
+            return coap_reply_simple(pdu, COAP_CODE_BAD_REQUEST, buf, len,
+                                     COAP_FORMAT_TEXT, NULL, 0);
+        }
+        memcpy(payload, pdu->payload, pdu->payload_len);
+        phydat_t data;
+        memset(&data, 0, sizeof(data));
+        data.val[0] = atoi(payload);
+        data.unit = UNIT_NONE;
+        unsigned code = (saul_reg_write(entry->reg, &data) < 0)
+                        ? COAP_CODE_INTERNAL_SERVER_ERROR : COAP_CODE_CHANGED;
+        return coap_reply_simple(pdu, code, buf, len, COAP_FORMAT_TEXT, NULL, 0);
+    }
+
+    METRICS_START(t);
+    TRACE_REQUEST(coap_get_id(pdu));
+    TRACE_BEGIN(HANDLER);
+    phydat_t data;
+    unsigned state = irq_disable();
+    data = entry->cache;
+    int dim = entry->dim;
+    irq_restore(state);
+    if (dim == 0) {
+        /* not sampled yet, or an actuator */
+        TRACE_BEGIN(SENSOR);
+        dim = saul_reg_read(entry->reg, &data);
+        TRACE_END(SENSOR);
+        if (dim <= 0) {
+            TRACE_END(HANDLER);
+            return coap_reply_simple(pdu, COAP_CODE_INTERNAL_SERVER_ERROR, buf,
+                                     len, COAP_FORMAT_TEXT, NULL, 0);
+        }
+    }
+
+    gcoap_resp_init(pdu, buf, len, COAP_CODE_CONTENT);
+    size_t payload_len = _format((char*)response, &data, dim);
+    memcpy(pdu->payload, response, payload_len);
+
+    ssize_t res = gcoap_finish(pdu, payload_len, COAP_FORMAT_TEXT);
+    TRACE_END(HANDLER);
+    METRICS_STOP(HANDLER, t);
+    return res;
+}
+
+static int _bus_read(void *arg)
+{
+    (void)arg;
+    int res = -1;
+    for (unsigned i = 0; i < _numof; i++) {
+        coap_saul_entry_t *entry = &_entries[i];
+        phydat_t data;
+        if (!entry->sensor) {
+            continue;
+        }
+        int dim = saul_reg_read(entry->reg, &data);
+        if (dim <= 0) {
+            DEBUG("[DEBUG] saul: failed to read %s\n", entry->reg->name);
+            continue;
+        }
+        unsigned state = irq_disable();
+        entry->cache = data;
+        entry->dim = dim;
+        irq_restore(state);
+        res = 0;
+    }
+    return res;
+}
+
+static void _bus_report(void *arg)
+{
+    (void)arg;
+    for (unsigned i = 0; i < _numof; i++) {
+        coap_saul_entry_t *entry = &_entries[i];
+        if (entry->sensor && entry->dim) {
+            char *out = coap_batch_key(&batch, entry->key, COAP_BATCH_NO_INDEX);
+            coap_batch_add(&batch, _format(out, &entry->cache, entry->dim));
+        }
+    }
+    coap_batch_send(&batch);
+}
+
+static sensor_bus_dev_t _bus_dev = {
+    .name = "saul",
+    .read = _bus_read,
+    .report = _bus_report,
+};
+
+void init_saul_sender(void)
+{
+    unsigned sensors = 0;
+
+    /* one entry per device, indexed within its class when needed */
+    for (saul_reg_t *reg = saul_reg; reg != NULL; reg = reg->next) {
+        if (_numof == COAP_SAUL_NUMOF) {
+            puts("[Error] Too many SAUL devices, increase COAP_SAUL_NUMOF");
+            break;
+        }
+        coap_saul_entry_t *entry = &_entries[_numof++];
+        uint8_t type = reg->driver->type;
+        unsigned idx = 0;
+        unsigned count = 0;
+        for (saul_reg_t *r = saul_reg; r != NULL; r = r->next) {
+            if (r->driver->type != type) {
+                continue;
+            }
+            if (r == reg) {
+                idx = count;
+            }
+            count++;
+        }
+
+        char name[COAP_SAUL_NAME_LEN];
+        _class_name(type, name);
+        if (count > 1) {
+            snprintf(entry->key, sizeof(entry->key), "%s/%u", name, idx);
+        }
+        else {
+            snprintf(entry->key, sizeof(entry->key), "%s", name);
+        }
+        snprintf(entry->path, sizeof(entry->path), "/%s", entry->key);
+        entry->reg = reg;
+        entry->dim = 0;
+        entry->sensor = ((type & COAP_SAUL_CAT_MASK) ==
+                         (SAUL_SENSE_ANY & COAP_SAUL_CAT_MASK));
+        sensors += entry->sensor;
+
+        coap_resource_t *resource = &_resources[_listener.resources_len++];
+        resource->path = entry->path;
+        resource->methods = (entry->sensor) ? COAP_GET : (COAP_GET | COAP_PUT);
+        resource->handler = _saul_handler;
+        resource->context = entry;
+        printf("SAUL device %s on %s\n", reg->name, entry->path);
+    }
+
+    /* the listener also feeds /.well-known/core */
+    sort_coap_resources(_resources, _listener.resources_len);
+    gcoap_register_listener(&_listener);
+
+    /* periodic updates to the server are sent by the bus scheduler */
+    coap_batch_init(&batch, sensors);
+    if (sensors) {
+        sensor_bus_register(&_bus_dev);
+    }
+}
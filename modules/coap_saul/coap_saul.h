@@ -0,0 +1,26 @@
+#ifndef COAP_SAUL_H
+#define COAP_SAUL_H
+
+#include <inttypes.h>
+
+#include "net/gcoap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef COAP_SAUL_NUMOF
+#define COAP_SAUL_NUMOF       (16U)     /* max number of SAUL devices exposed */
+#endif
+
+/* Expose every SAUL device as a CoAP resource and report sensor values
+ * through the sensor bus. Resources are named after the device class,
+ * e.g. /temperature, and indexed when a class has several devices,
+ * e.g. /temperature/0 and /temperature/1. Actuators accept PUT. */
+void init_saul_sender(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* COAP_SAUL_H */
@@ -4,9 +4,6 @@
 #include <stdio.h>
 #include <string.h>
 
-#include "msg.h"
-#include "thread.h"
-#include "xtimer.h"
 #include "periph/i2c.h"
 
 #include "tsl2561_params.h"
@@ -17,81 +14,316 @@
 #include "board.h"
 
 #include "coap_utils.h"
+#include "sensor_filter.h"
+#include "sensor_bus.h"
+#include "telemetry.h"
+#include "metrics.h"
+#include "trace.h"
 #include "coap_tsl2561.h"
+#ifdef MODULE_COAP_BURST
+#include "coap_burst.h"
+#endif
 
 #define ENABLE_DEBUG (0)
 #include "debug.h"
 
-#define SEND_INTERVAL        (5000000UL)    /* set updates interval to 5 seconds */
+#ifndef TSL2561_FILTER_MEDIAN
+#define TSL2561_FILTER_MEDIAN       (3U)    /* median-of-N spike rejection, 0 to disable */
+#endif
+#ifndef TSL2561_FILTER_EMA_SHIFT
+#define TSL2561_FILTER_EMA_SHIFT    (1U)    /* EMA smoothing, alpha = 1/2^N, 0 to disable */
+#endif
 
-#define TSL2561_QUEUE_SIZE    (8)
+/* The driver powers the sensor up for each read, waits for the integration
+   and powers it down again: the read has no separate start step, so the
+   integration cannot overlap the conversions of the other bus devices */
+#define TSL2561_ACTIVE_UA           (240U)  /* typical current while integrating */
+#define TSL2561_POWER_DOWN_UA       (4U)    /* typical current when powered down */
+
+#ifndef TSL2561_AUTO_RANGE
+#define TSL2561_AUTO_RANGE          (1)     /* pick gain and integration from the last value */
+#endif
+#ifndef TSL2561_RANGE_MIN_COUNTS
+#define TSL2561_RANGE_MIN_COUNTS    (100U)  /* channel 0 counts for 1% resolution */
+#endif
+#define TSL2561_RANGE_HEADROOM      (80U)   /* % of full scale used before saturation */
 
 /* TSL2561 sensor */
 #define I2C_DEVICE (0)
 
-static msg_t _tsl2561_msg_queue[TSL2561_QUEUE_SIZE];
-static char tsl2561_stack[THREAD_STACKSIZE_DEFAULT];
+typedef struct {
+    uint8_t gain;
+    uint8_t integration;
+    uint32_t ulx_per_count;     /* channel 0 resolution in micro lux */
+    uint16_t max_counts;        /* channel 0 full scale */
+    const char *name;
+} tsl2561_range_t;
+
+/* shortest integration first, and the higher gain first for each */
+static const tsl2561_range_t _ranges[] = {
+    { TSL2561_GAIN_16X, TSL2561_INTEGRATIONTIME_13MS, 55700, 5047, "16x/13ms" },
+    { TSL2561_GAIN_1X, TSL2561_INTEGRATIONTIME_13MS, 891000, 5047, "1x/13ms" },
+    { TSL2561_GAIN_16X, TSL2561_INTEGRATIONTIME_101MS, 7560, 37177, "16x/101ms" },
+    { TSL2561_GAIN_1X, TSL2561_INTEGRATIONTIME_101MS, 121000, 37177, "1x/101ms" },
+    { TSL2561_GAIN_16X, TSL2561_INTEGRATIONTIME_402MS, 1900, 65535, "16x/402ms" },
+    { TSL2561_GAIN_1X, TSL2561_INTEGRATIONTIME_402MS, 30400, 65535, "1x/402ms" },
+};
+
+#define TSL2561_RANGE_NUMOF         (sizeof(_ranges) / sizeof(_ranges[0]))
+#define TSL2561_RANGE_DARK          (4U)    /* most sensitive */
+#define TSL2561_RANGE_BRIGHT        (1U)    /* widest */
+
+#define TSL2561_NUMOF               (sizeof(tsl2561_params) / sizeof(tsl2561_params[0]))
+#define TSL2561_CHANNELS            (2U)    /* value and range */
+#define TSL2561_PATH_LEN            (24U)
 
-static tsl2561_t tsl2561_dev;
+typedef struct {
+    tsl2561_t dev;
+    tsl2561_params_t conf;
+    sensor_filter_t illuminance_filter;
+    unsigned range;
+    bool range_changed;
+} tsl2561_instance_t;
+
+static tsl2561_instance_t instances[TSL2561_NUMOF];
 static uint8_t response[64] = { 0 };
 
+/* "/illuminance/<index>[/range]" resources of each instance */
+static char _paths[TSL2561_NUMOF * TSL2561_CHANNELS][TSL2561_PATH_LEN];
+static coap_resource_t _resources[TSL2561_NUMOF * TSL2561_CHANNELS];
+static gcoap_listener_t _listener = { &_resources[0], 0, NULL };
+
+#ifdef MODULE_COAP_BURST
+/* burst samples are raw, they bypass the filter chain, only the first
+   instance can be sampled */
+static size_t _burst_read_illuminance(char *buf, size_t len)
+{
+    sensor_bus_lock();
+    uint16_t illuminance = tsl2561_read_illuminance(&instances[0].dev);
+    sensor_bus_unlock();
+    return snprintf(buf, len, "%ilx", (int)illuminance);
+}
+
+static coap_burst_source_t _burst_illuminance = {
+    .name = "illuminance",
+    .max_rate = TSL2561_BURST_MAX_RATE,
+    .sample_size = BURST_VALUE_LEN,
+    .read = _burst_read_illuminance,
+};
+#endif
+
+/* the context of indexed resources is their instance, the plain resources
+   registered by the application serve the first one */
+static tsl2561_instance_t *_instance(void *ctx)
+{
+    return (ctx) ? ctx : &instances[0];
+}
+
 ssize_t tsl2561_illuminance_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx)
 {
-    (void)ctx;
+    METRICS_START(t);
+    TRACE_REQUEST(coap_get_id(pdu));
+    TRACE_BEGIN(HANDLER);
+    tsl2561_instance_t *inst = _instance(ctx);
     gcoap_resp_init(pdu, buf, len, COAP_CODE_CONTENT);
     memset(response, 0, sizeof(response));
-    sprintf((char*)response, "%ilx", (int)tsl2561_read_illuminance(&tsl2561_dev));
-    size_t payload_len = sizeof(response);
+    int32_t illuminance;
+    if (!sensor_filter_get(&inst->illuminance_filter, &illuminance)) {
+        TRACE_BEGIN(SENSOR);
+        sensor_bus_lock();
+        illuminance = tsl2561_read_illuminance(&inst->dev);
+        sensor_bus_unlock();
+        TRACE_END(SENSOR);
+    }
+    sprintf((char*)response, "%ilx", (int)illuminance);
+    size_t payload_len = strlen((char*)response);
     memcpy(pdu->payload, response, payload_len);
 
-    return gcoap_finish(pdu, payload_len, COAP_FORMAT_TEXT);
+    ssize_t res = gcoap_finish(pdu, payload_len, COAP_FORMAT_TEXT);
+    TRACE_END(HANDLER);
+    METRICS_STOP(HANDLER, t);
+    return res;
 }
 
-void *tsl2561_thread(void *args)
+static bool _range_fits(unsigned idx, uint16_t lux,
+                        unsigned min_counts, unsigned headroom)
 {
-    (void)args;
-    msg_init_queue(_tsl2561_msg_queue, TSL2561_QUEUE_SIZE);
-
-    for(;;) {
-        size_t p = 0;
-        p += sprintf((char*)&response[p], "illuminance:");
-        p += sprintf((char*)&response[p],
-                     "%ilx", (int)tsl2561_read_illuminance(&tsl2561_dev));
-        response[p] = '\0';
-        send_coap_post((uint8_t*)"/server", response);
-
-        /* wait 5 seconds */
-        xtimer_usleep(SEND_INTERVAL);
+    uint64_t counts = ((uint64_t)lux * 1000000) / _ranges[idx].ulx_per_count;
+    return (counts >= min_counts) &&
+           (counts <= ((uint32_t)_ranges[idx].max_counts * headroom) / 100);
+}
+
+/* shortest integration that gives enough counts without saturating */
+static unsigned _select_range(uint16_t lux)
+{
+    for (unsigned i = 0; i < TSL2561_RANGE_NUMOF; i++) {
+        if (_range_fits(i, lux, TSL2561_RANGE_MIN_COUNTS,
+                        TSL2561_RANGE_HEADROOM)) {
+            return i;
+        }
+    }
+    if (_range_fits(TSL2561_RANGE_DARK, lux, 0, TSL2561_RANGE_HEADROOM)) {
+        return TSL2561_RANGE_DARK;
     }
+    return TSL2561_RANGE_BRIGHT;
+}
 
-    return NULL;
+static void _set_range(tsl2561_instance_t *inst, unsigned idx)
+{
+    inst->conf.gain = _ranges[idx].gain;
+    inst->conf.integration = _ranges[idx].integration;
+    if (tsl2561_init(&inst->dev, &inst->conf) == TSL2561_OK) {
+        inst->range = idx;
+        inst->range_changed = true;
+        DEBUG("[DEBUG] tsl2561: range %s\n", _ranges[idx].name);
+    }
 }
 
-void init_tsl2561_sender(void)
+static void _update_range(tsl2561_instance_t *inst, uint16_t lux)
 {
-    /* Initialize the TSL2561 sensor */
-    printf("+------------Initializing TSL2561 sensor ------------+\n");
-    int result = tsl2561_init(&tsl2561_dev, &tsl2561_params[0]);
-    if (result == -1) {
-        puts("[Error] The given i2c is not enabled");
+    unsigned next = _select_range(lux);
+    /* only move to a longer integration once the current range is clearly
+       out of bounds, so that values near a boundary do not toggle */
+    if ((next > inst->range) &&
+        _range_fits(inst->range, lux, (TSL2561_RANGE_MIN_COUNTS * 3) / 4,
+                    (TSL2561_RANGE_HEADROOM + 100) / 2)) {
+        next = inst->range;
     }
-    else if (result == -2) {
-        puts("[Error] The sensor did not answer correctly on the given address");
+    if (next != inst->range) {
+        _set_range(inst, next);
     }
-    else {
-        printf("Initialization successful\n\n");
+}
+
+ssize_t tsl2561_range_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx)
+{
+    tsl2561_instance_t *inst = _instance(ctx);
+    gcoap_resp_init(pdu, buf, len, COAP_CODE_CONTENT);
+    size_t payload_len = strlen(_ranges[inst->range].name);
+    memcpy(pdu->payload, _ranges[inst->range].name, payload_len);
+
+    return gcoap_finish(pdu, payload_len, COAP_FORMAT_TEXT);
+}
+
+static int _bus_read(void *arg)
+{
+    (void)arg;
+    for (unsigned i = 0; i < TSL2561_NUMOF; i++) {
+        tsl2561_instance_t *inst = &instances[i];
+        uint16_t lux = tsl2561_read_illuminance(&inst->dev);
+        sensor_filter_update(&inst->illuminance_filter, lux);
+        if (TSL2561_AUTO_RANGE) {
+            _update_range(inst, lux);
+        }
+    }
+    return 0;
+}
+
+static void _bus_report(void *arg)
+{
+    (void)arg;
+    int32_t illuminance;
+
+    for (unsigned i = 0; i < TSL2561_NUMOF; i++) {
+        tsl2561_instance_t *inst = &instances[i];
+        unsigned idx = (TSL2561_NUMOF > 1) ? i : TELEMETRY_NO_INDEX;
+        if (sensor_filter_get(&inst->illuminance_filter, &illuminance)) {
+            telemetry_sample_t sample = {
+                .name = "illuminance", .idx = idx,
+                .value = illuminance, .unit = "lx",
+            };
+            telemetry_publish(&sample);
+        }
+
+        if (inst->range_changed) {
+            telemetry_sample_t sample = {
+                .name = "illuminance_range", .idx = idx,
+                .str = _ranges[inst->range].name,
+            };
+            telemetry_publish(&sample);
+            inst->range_changed = false;
+        }
     }
+    telemetry_flush();
+}
+
+static sensor_bus_dev_t _bus_dev = {
+    .name = "tsl2561",
+    .read = _bus_read,
+    .report = _bus_report,
+};
+
+static void _add_resource(const char *fmt, unsigned idx, coap_handler_t handler)
+{
+    unsigned n = _listener.resources_len++;
+    snprintf(_paths[n], TSL2561_PATH_LEN, fmt, idx);
+    _resources[n].path = _paths[n];
+    _resources[n].methods = COAP_GET;
+    _resources[n].handler = handler;
+    _resources[n].context = &instances[idx];
+}
+
+static int _init_instance(unsigned idx)
+{
+    tsl2561_instance_t *inst = &instances[idx];
+
+    sensor_filter_setup(&inst->illuminance_filter,
+                        TSL2561_FILTER_MEDIAN, TSL2561_FILTER_EMA_SHIFT);
 
-    /* create the sensors thread that will send periodic updates to
-       the server */
-    int tsl2561_pid = thread_create(tsl2561_stack, sizeof(tsl2561_stack),
-                                    THREAD_PRIORITY_MAIN - 1,
-                                    THREAD_CREATE_STACKTEST, tsl2561_thread,
-                                    NULL, "tsl2561 thread");
-    if (tsl2561_pid == -EINVAL || tsl2561_pid == -EOVERFLOW) {
-        puts("Error: failed to create tsl2561 thread, exiting\n");
+    _add_resource("/illuminance/%u", idx, tsl2561_illuminance_handler);
+    _add_resource("/illuminance/%u/range", idx, tsl2561_range_handler);
+
+    inst->conf = tsl2561_params[idx];
+    inst->range = TSL2561_RANGE_BRIGHT;
+    inst->range_changed = true;
+    if (TSL2561_AUTO_RANGE) {
+        /* start wide and fast, the first value picks the range */
+        inst->conf.gain = _ranges[inst->range].gain;
+        inst->conf.integration = _ranges[inst->range].integration;
     }
     else {
-        puts("Successfuly created tsl2561 thread !\n");
+        for (unsigned i = 0; i < TSL2561_RANGE_NUMOF; i++) {
+            if ((_ranges[i].gain == inst->conf.gain) &&
+                (_ranges[i].integration == inst->conf.integration)) {
+                inst->range = i;
+            }
+        }
+    }
+    return tsl2561_init(&inst->dev, &inst->conf);
+}
+
+void init_tsl2561_sender(void)
+{
+    telemetry_init();
+
+    /* Initialize the TSL2561 sensors */
+    for (unsigned i = 0; i < TSL2561_NUMOF; i++) {
+        printf("+------------Initializing TSL2561 sensor %u ------------+\n", i);
+        int result = _init_instance(i);
+        if (result == -1) {
+            puts("[Error] The given i2c is not enabled");
+        }
+        else if (result == -2) {
+            puts("[Error] The sensor did not answer correctly on the given address");
+        }
+        else {
+            printf("Initialization successful\n\n");
+        }
     }
+
+    sort_coap_resources(_resources, _listener.resources_len);
+    gcoap_register_listener(&_listener);
+#ifdef MODULE_TELEMETRY_OBSERVE
+    telemetry_observe_listener(&_listener);
+#endif
+
+#ifdef MODULE_COAP_BURST
+    coap_burst_register(&_burst_illuminance);
+#endif
+
+    /* periodic updates to the server are sent by the bus scheduler, the
+       instances are read one after the other while the others sleep */
+    _bus_dev.active_ua = TSL2561_ACTIVE_UA +
+                         (TSL2561_NUMOF - 1) * TSL2561_POWER_DOWN_UA;
+    _bus_dev.idle_ua = TSL2561_NUMOF * TSL2561_POWER_DOWN_UA;
+    sensor_bus_register(&_bus_dev);
 }
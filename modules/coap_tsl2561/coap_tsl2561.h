@@ -9,7 +9,12 @@
 extern "C" {
 #endif
 
+#ifndef TSL2561_BURST_MAX_RATE
+#define TSL2561_BURST_MAX_RATE      (2U)    /* max burst rate in Hz, bounded by the integration time */
+#endif
+
 ssize_t tsl2561_illuminance_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx);
+ssize_t tsl2561_range_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx);
 
 void init_tsl2561_sender(void);
 
@@ -1,29 +1,78 @@
 #include <inttypes.h>
 #include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
 
 #include "net/gcoap.h"
+#include "net/ipv6/addr.h"
 #include "coap_utils.h"
+#include "metrics.h"
+#include "trace.h"
+#include "tlog.h"
+#ifdef MODULE_NODE_CONFIG
+#include "node_config.h"
+#endif
 
 #define ENABLE_DEBUG (0)
 #include "debug.h"
 
 static sock_udp_t coap_sock;
 
-void send_coap_post(uint8_t* uri_path, uint8_t *data)
+static char broker_addr[IPV6_ADDR_MAX_STR_LEN] = BROKER_ADDR;
+static uint32_t broker_port = BROKER_PORT;
+
+#ifdef MODULE_NODE_CONFIG
+static node_config_entry_t _config_addr = {
+    .name = "broker_addr",
+    .type = NODE_CONFIG_STR,
+    .value = broker_addr,
+    .max = sizeof(broker_addr),
+};
+
+static node_config_entry_t _config_port = {
+    .name = "broker_port",
+    .type = NODE_CONFIG_UINT,
+    .value = &broker_port,
+    .min = 1,
+    .max = UINT16_MAX,
+};
+#endif
+
+void coap_utils_init(void)
 {
+#ifdef MODULE_NODE_CONFIG
+    node_config_register(&_config_addr);
+    node_config_register(&_config_port);
+#endif
+}
+
+int send_coap_post_raw(uint8_t *uri_path, const uint8_t *data, size_t data_len,
+                       unsigned format)
+{
+    METRICS_START(t);
+    TRACE_BEGIN(SEND);
+
     /* format destination address from string */
     ipv6_addr_t remote_addr;
-    if (ipv6_addr_from_str(&remote_addr, BROKER_ADDR) == NULL) {
-        DEBUG("[ERROR]: address not valid '%s'\n", BROKER_ADDR);
-        return;
+    /* broker_addr and the payloads are RAM buffers that tlog cannot
+       decode: their length, or the end of the parsed address, are logged
+       instead. URI paths are constant strings */
+    if (ipv6_addr_from_str(&remote_addr, broker_addr) == NULL) {
+        TLOG("[ERROR]: address not valid (%u chars)\n",
+             (unsigned)strlen(broker_addr));
+        METRICS_INC(COAP_TX_ERR);
+        TRACE_END(SEND);
+        return -1;
     }
 
-    DEBUG("[DEBUG] utils: sending to '%s'\n", BROKER_ADDR);
+    TLOG("[DEBUG] utils: sending to ...:%02x%02x:%02x%02x\n",
+         remote_addr.u8[12], remote_addr.u8[13],
+         remote_addr.u8[14], remote_addr.u8[15]);
     sock_udp_ep_t remote;
 
     remote.family = AF_INET6;
     remote.netif  = SOCK_ADDR_ANY_NETIF;
-    remote.port   = BROKER_PORT;
+    remote.port   = broker_port;
 
     memcpy(&remote.addr.ipv6[0], &remote_addr.u8[0], sizeof(remote_addr.u8));
 
@@ -31,10 +80,90 @@ void send_coap_post(uint8_t* uri_path, uint8_t *data)
     coap_pkt_t pdu;
     size_t len;
     gcoap_req_init(&pdu, &buf[0], GCOAP_PDU_BUF_SIZE, COAP_METHOD_POST, (char*)uri_path);
-    memcpy(pdu.payload, (char*)data, strlen((char*)data));
-    len = gcoap_finish(&pdu, strlen((char*)data) , COAP_FORMAT_TEXT);
+    if (data_len > pdu.payload_len) {
+        TLOG("[ERROR] utils: payload too large (%u > %u)\n",
+             (unsigned)data_len, (unsigned)pdu.payload_len);
+        METRICS_INC(COAP_TX_ERR);
+        TRACE_END(SEND);
+        return -1;
+    }
+    memcpy(pdu.payload, data, data_len);
+    len = gcoap_finish(&pdu, data_len, format);
+
+    TLOG("[INFO] Sending %u bytes to port %i%s\n",
+         (unsigned)data_len, (int)broker_port, uri_path);
+
+    if (sock_udp_send(&coap_sock, buf, len, &remote) < 0) {
+        METRICS_INC(COAP_TX_ERR);
+        TRACE_END(SEND);
+        return -1;
+    }
+    METRICS_STOP(SEND, t);
+    TRACE_END(SEND);
+    METRICS_INC(COAP_TX);
+    METRICS_ADD(COAP_TX_BYTES, len);
+
+    return 0;
+}
+
+void send_coap_post(uint8_t* uri_path, uint8_t *data)
+{
+    TLOG("[INFO] Sending %u chars\n", (unsigned)strlen((char *)data));
+    send_coap_post_raw(uri_path, data, strlen((char*)data), COAP_FORMAT_TEXT);
+}
+
+void coap_batch_init(coap_batch_t *batch, unsigned numof)
+{
+    batch->len = 0;
+    batch->numof = numof;
+}
 
-    DEBUG("[INFO] Sending '%s' to '%s:%i%s'\n", data, BROKER_ADDR, BROKER_PORT, uri_path);
+char *coap_batch_key(coap_batch_t *batch, const char *name, unsigned idx)
+{
+    /* key, index, separators and the terminating null byte */
+    size_t need = strlen(name) + 8 + COAP_BATCH_VALUE_MAX;
+    if (batch->len + need > sizeof(batch->buf)) {
+        coap_batch_send(batch);
+    }
+    if ((batch->numof > 1) && (idx != COAP_BATCH_NO_INDEX)) {
+        batch->len += sprintf(&batch->buf[batch->len], "%s/%u:", name, idx);
+    }
+    else {
+        batch->len += sprintf(&batch->buf[batch->len], "%s:", name);
+    }
+    return &batch->buf[batch->len];
+}
+
+void coap_batch_add(coap_batch_t *batch, size_t value_len)
+{
+    batch->len += value_len;
+    if (batch->numof <= 1) {
+        coap_batch_send(batch);
+        return;
+    }
+    batch->buf[batch->len++] = '\n';
+}
 
-    sock_udp_send(&coap_sock, buf, len, &remote);
+void coap_batch_send(coap_batch_t *batch)
+{
+    if (batch->len == 0) {
+        return;
+    }
+    if (batch->buf[batch->len - 1] == '\n') {
+        batch->len--;
+    }
+    batch->buf[batch->len] = '\0';
+    send_coap_post((uint8_t*)"/server", (uint8_t*)batch->buf);
+    batch->len = 0;
+}
+
+static int _resource_cmp(const void *a, const void *b)
+{
+    return strcmp(((const coap_resource_t *)a)->path,
+                  ((const coap_resource_t *)b)->path);
+}
+
+void sort_coap_resources(coap_resource_t *resources, size_t numof)
+{
+    qsort(resources, numof, sizeof(coap_resource_t), _resource_cmp);
 }
@@ -2,13 +2,46 @@
 #define COAP_UTILS_H
 
 #include <inttypes.h>
+#include <limits.h>
 #include <stdlib.h>
 
+#include "net/gcoap.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#ifndef COAP_BATCH_LEN
+#define COAP_BATCH_LEN          (192U)  /* uplink buffer for batched values */
+#endif
+#define COAP_BATCH_VALUE_MAX    (24U)   /* max length of a formatted value */
+#define COAP_BATCH_NO_INDEX     (UINT_MAX)  /* name already identifies the value */
+
+/* Values of several sensor instances are sent to the broker as
+ * "<name>/<index>:<value>" lines in a single POST. With a single instance
+ * the name is not indexed and each value is sent on its own, as before. */
+typedef struct {
+    char buf[COAP_BATCH_LEN];
+    size_t len;
+    unsigned numof;
+} coap_batch_t;
+
+/* Registers the broker address and port settings */
+void coap_utils_init(void);
+
 void send_coap_post(uint8_t* uri_path, uint8_t *data);
+int send_coap_post_raw(uint8_t *uri_path, const uint8_t *data, size_t data_len,
+                       unsigned format);
+
+void coap_batch_init(coap_batch_t *batch, unsigned numof);
+/* Writes the key and returns where the value must be written, at most
+ * COAP_BATCH_VALUE_MAX bytes */
+char *coap_batch_key(coap_batch_t *batch, const char *name, unsigned idx);
+void coap_batch_add(coap_batch_t *batch, size_t value_len);
+void coap_batch_send(coap_batch_t *batch);
+
+/* Sort a resource table built at runtime, gcoap expects it in order */
+void sort_coap_resources(coap_resource_t *resources, size_t numof);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,285 @@
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "irq.h"
+#include "sched.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#if defined(MODULE_NETSTATS_L2) && defined(MODULE_GNRC_NETIF)
+#include "net/gnrc/netif.h"
+#endif
+#ifdef MODULE_SENSOR_BUS
+#include "sensor_bus.h"
+#endif
+
+#include "energy.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+#define ENERGY_TX_BYTES     (0)
+#define ENERGY_TX_FRAMES    (1)
+#define ENERGY_RX_BYTES     (2)
+#define ENERGY_RX_FRAMES    (3)
+#define ENERGY_COUNTERS     (4)
+
+#ifdef MODULE_PM_LAYERED
+/* blockers of pm_layered, kept up to date by pm_block() and pm_unblock() */
+extern volatile pm_blocker_t pm_blocker;
+
+static const uint32_t _pm_ua[] = ENERGY_MCU_PM_UA;
+#endif
+
+static xtimer_t _timer;
+static kernel_pid_t _idle_pid = KERNEL_PID_UNDEF;
+static uint64_t _idle_ticks = 0;        /* idle thread run time accounted */
+static uint64_t _sleep[ENERGY_SLEEP_MODES];
+static uint64_t _since = 0;
+
+/* totals at the last reset */
+static uint32_t _base[ENERGY_COUNTERS];
+static uint32_t _base_conversions = 0;
+static uint64_t _base_charge = 0;
+
+/* the power mode the idle thread enters, as chosen by pm_set_lowest() */
+static unsigned _mode(void)
+{
+#ifdef MODULE_PM_LAYERED
+    pm_blocker_t blocker;
+    blocker.val_u32 = pm_blocker.val_u32;
+    unsigned mode = PM_NUM_MODES;
+    while (mode && !blocker.val_u8[mode - 1]) {
+        mode--;
+    }
+    return mode;
+#else
+    return 0;
+#endif
+}
+
+static uint32_t _sleep_ua(unsigned mode)
+{
+#ifdef MODULE_PM_LAYERED
+    if (mode < sizeof(_pm_ua) / sizeof(_pm_ua[0]) && mode < PM_NUM_MODES) {
+        return _pm_ua[mode];
+    }
+#else
+    (void)mode;
+#endif
+    return ENERGY_MCU_IDLE_UA;
+}
+
+/* The idle thread only runs to sleep: its run time since the last call is
+ * counted in the mode it can enter now. Sampling often enough keeps the
+ * split close when the blockers change. */
+static void _account(void)
+{
+    if (_idle_pid == KERNEL_PID_UNDEF) {
+        return;
+    }
+    unsigned state = irq_disable();
+    uint64_t ticks = sched_pidlist[_idle_pid].runtime_ticks;
+    xtimer_ticks64_t delta = { ticks - _idle_ticks };
+    _idle_ticks = ticks;
+    _sleep[_mode()] += xtimer_usec_from_ticks64(delta);
+    irq_restore(state);
+}
+
+static void _sample(void *arg)
+{
+    (void)arg;
+    _account();
+    xtimer_set(&_timer, ENERGY_SAMPLE_INTERVAL);
+}
+
+static void _radio_totals(uint32_t *counters)
+{
+    memset(counters, 0, ENERGY_COUNTERS * sizeof(uint32_t));
+#if defined(MODULE_NETSTATS_L2) && defined(MODULE_GNRC_NETIF)
+    gnrc_netif_t *netif = NULL;
+    while ((netif = gnrc_netif_iter(netif)) != NULL) {
+        const netstats_t *stats = &netif->dev->stats;
+        counters[ENERGY_TX_BYTES] += stats->tx_bytes;
+        counters[ENERGY_TX_FRAMES] += stats->tx_unicast_count +
+                                      stats->tx_mcast_count;
+        counters[ENERGY_RX_BYTES] += stats->rx_bytes;
+        counters[ENERGY_RX_FRAMES] += stats->rx_count;
+    }
+#endif
+}
+
+static void _sensor_totals(uint32_t *conversions, uint64_t *charge)
+{
+#ifdef MODULE_SENSOR_BUS
+    sensor_bus_get_usage(conversions, charge);
+#else
+    *conversions = 0;
+    *charge = 0;
+#endif
+}
+
+void energy_reset(void)
+{
+    _account();
+    unsigned state = irq_disable();
+    memset(_sleep, 0, sizeof(_sleep));
+    _since = xtimer_now_usec64();
+    irq_restore(state);
+    _radio_totals(_base);
+    _sensor_totals(&_base_conversions, &_base_charge);
+}
+
+void energy_init(void)
+{
+    for (kernel_pid_t pid = KERNEL_PID_FIRST; pid <= KERNEL_PID_LAST; pid++) {
+        thread_t *thread = (thread_t *)thread_get(pid);
+        if (thread && thread->priority == THREAD_PRIORITY_IDLE) {
+            _idle_pid = pid;
+            _idle_ticks = sched_pidlist[pid].runtime_ticks;
+            break;
+        }
+    }
+    energy_reset();
+
+    _timer.callback = _sample;
+    xtimer_set(&_timer, ENERGY_SAMPLE_INTERVAL);
+}
+
+void energy_get(energy_t *energy)
+{
+    memset(energy, 0, sizeof(*energy));
+    _account();
+
+    unsigned state = irq_disable();
+    energy->elapsed = xtimer_now_usec64() - _since;
+    memcpy(energy->sleep, _sleep, sizeof(_sleep));
+    irq_restore(state);
+
+    uint64_t elapsed = energy->elapsed;
+    if (elapsed == 0) {
+        return;
+    }
+
+    /* the MCU runs whenever it does not sleep */
+    uint64_t charge = 0;
+    uint64_t sleep = 0;
+    for (unsigned mode = 0; mode < ENERGY_SLEEP_MODES; mode++) {
+        sleep += energy->sleep[mode];
+        charge += energy->sleep[mode] * _sleep_ua(mode);
+    }
+    energy->active = (sleep < elapsed) ? elapsed - sleep : 0;
+    charge += energy->active * ENERGY_MCU_ACTIVE_UA;
+    energy->mcu_ua = charge / elapsed;
+
+    /* the radio listens when it does not send */
+    uint32_t counters[ENERGY_COUNTERS];
+    _radio_totals(counters);
+    energy->tx_bytes = counters[ENERGY_TX_BYTES] - _base[ENERGY_TX_BYTES];
+    energy->tx_frames = counters[ENERGY_TX_FRAMES] - _base[ENERGY_TX_FRAMES];
+    energy->rx_bytes = counters[ENERGY_RX_BYTES] - _base[ENERGY_RX_BYTES];
+    energy->rx_frames = counters[ENERGY_RX_FRAMES] - _base[ENERGY_RX_FRAMES];
+    uint64_t tx = ((uint64_t)energy->tx_bytes +
+                   (uint64_t)energy->tx_frames * ENERGY_RADIO_FRAME_OVERHEAD) *
+                  ENERGY_RADIO_US_PER_BYTE;
+    if (tx > elapsed) {
+        tx = elapsed;
+    }
+    energy->radio_ua = (tx * ENERGY_RADIO_TX_UA +
+                        (elapsed - tx) * ENERGY_RADIO_RX_UA) / elapsed;
+
+    uint32_t conversions;
+    uint64_t sensor_charge;
+    _sensor_totals(&conversions, &sensor_charge);
+    energy->conversions = conversions - _base_conversions;
+    energy->sensor_ua = (sensor_charge - _base_charge) / elapsed;
+
+    energy->avg_ua = energy->mcu_ua + energy->radio_ua + energy->sensor_ua;
+    if (energy->avg_ua) {
+        energy->life_h = (uint64_t)ENERGY_BATTERY_MAH * 1000 / energy->avg_ua;
+    }
+}
+
+static uint64_t _ms(uint64_t us)
+{
+    return us / US_PER_MS;
+}
+
+ssize_t energy_format(char *buf, size_t len)
+{
+    energy_t e;
+    energy_get(&e);
+
+    uint64_t sleep = 0;
+    for (unsigned mode = 0; mode < ENERGY_SLEEP_MODES; mode++) {
+        sleep += e.sleep[mode];
+    }
+
+    int n = snprintf(buf, len,
+                     "uptime=%" PRIu32 "&tx_bytes=%" PRIu32
+                     "&tx_frames=%" PRIu32 "&rx_bytes=%" PRIu32
+                     "&rx_frames=%" PRIu32 "&active_ms=%" PRIu32
+                     "&sleep_ms=%" PRIu32 "&conversions=%" PRIu32
+                     "&mcu_ua=%" PRIu32 "&radio_ua=%" PRIu32
+                     "&sensor_ua=%" PRIu32 "&avg_ua=%" PRIu32
+                     "&life_h=%" PRIu32,
+                     (uint32_t)(e.elapsed / US_PER_SEC), e.tx_bytes,
+                     e.tx_frames, e.rx_bytes, e.rx_frames,
+                     (uint32_t)_ms(e.active), (uint32_t)_ms(sleep),
+                     e.conversions, e.mcu_ua, e.radio_ua, e.sensor_ua,
+                     e.avg_ua, e.life_h);
+    if ((n < 0) || ((size_t)n >= len)) {
+        return -ENOSPC;
+    }
+
+    return n;
+}
+
+int energy_cmd(int argc, char **argv)
+{
+    if ((argc > 1) && (strcmp(argv[1], "reset") == 0)) {
+        energy_reset();
+        return 0;
+    }
+    if (argc > 1) {
+        printf("usage: %s [reset]\n", argv[0]);
+        return 1;
+    }
+
+    energy_t e;
+    energy_get(&e);
+
+    printf("over %" PRIu32 " s\n", (uint32_t)(e.elapsed / US_PER_SEC));
+    printf("radio: tx %" PRIu32 " bytes in %" PRIu32 " frames, "
+           "rx %" PRIu32 " bytes in %" PRIu32 " frames\n",
+           e.tx_bytes, e.tx_frames, e.rx_bytes, e.rx_frames);
+    printf("mcu: active %" PRIu32 " ms", (uint32_t)_ms(e.active));
+    for (unsigned mode = 0; mode < ENERGY_SLEEP_MODES; mode++) {
+        if (mode == ENERGY_SLEEP_MODES - 1) {
+            printf(", idle %" PRIu32 " ms", (uint32_t)_ms(e.sleep[mode]));
+        }
+        else {
+            printf(", mode %u %" PRIu32 " ms", mode,
+                   (uint32_t)_ms(e.sleep[mode]));
+        }
+    }
+    puts("");
+    printf("sensors: %" PRIu32 " conversions\n", e.conversions);
+#ifdef MODULE_SENSOR_BUS
+    /* since boot, the device counters are not reset */
+    for (const sensor_bus_dev_t *dev = sensor_bus_iter(NULL); dev != NULL;
+         dev = sensor_bus_iter(dev)) {
+        printf("  %s: %" PRIu32 " uA since boot\n",
+               dev->name, sensor_bus_avg_current(dev));
+    }
+#endif
+    printf("current: mcu %" PRIu32 " uA, radio %" PRIu32 " uA, "
+           "sensors %" PRIu32 " uA, total %" PRIu32 " uA\n",
+           e.mcu_ua, e.radio_ua, e.sensor_ua, e.avg_ua);
+    printf("battery: %" PRIu32 " h on %u mAh\n", e.life_h,
+           (unsigned)ENERGY_BATTERY_MAH);
+
+    return 0;
+}
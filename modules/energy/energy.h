@@ -0,0 +1,68 @@
+#ifndef ENERGY_H
+#define ENERGY_H
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <sys/types.h>
+
+#ifdef MODULE_PM_LAYERED
+#include "pm_layered.h"
+#endif
+
+#include "energy_params.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ENERGY_URI                  "/energy"
+
+#ifndef ENERGY_SAMPLE_INTERVAL
+#define ENERGY_SAMPLE_INTERVAL      (10000000UL)    /* idle time split in us */
+#endif
+
+/* Sleep time is counted per power mode, the last one is sleeping with all
+ * modes blocked */
+#ifdef MODULE_PM_LAYERED
+#define ENERGY_SLEEP_MODES          (PM_NUM_MODES + 1)
+#else
+#define ENERGY_SLEEP_MODES          (1U)
+#endif
+
+typedef struct {
+    uint64_t elapsed;                       /* us since boot or reset */
+    uint32_t tx_bytes;
+    uint32_t tx_frames;
+    uint32_t rx_bytes;
+    uint32_t rx_frames;
+    uint64_t active;                        /* MCU running in us */
+    uint64_t sleep[ENERGY_SLEEP_MODES];     /* MCU sleeping in us */
+    uint32_t conversions;                   /* sensor bus reads */
+    uint32_t mcu_ua;                        /* average currents */
+    uint32_t radio_ua;
+    uint32_t sensor_ua;
+    uint32_t avg_ua;
+    uint32_t life_h;                        /* on ENERGY_BATTERY_MAH */
+} energy_t;
+
+/* Starts the accounting, done by init_energy_handler() */
+void energy_init(void);
+
+void energy_get(energy_t *energy);
+void energy_reset(void);
+
+/* "name=value&..." summary of energy_get(), returns -ENOSPC if the buffer
+ * is too small */
+ssize_t energy_format(char *buf, size_t len);
+
+/* Registers /energy, a GET returns the summary and a DELETE resets it */
+void init_energy_handler(void);
+
+/* "energy [reset]" shell command */
+int energy_cmd(int argc, char **argv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ENERGY_H */
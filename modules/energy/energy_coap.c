@@ -0,0 +1,56 @@
+#ifdef MODULE_GCOAP
+
+#include <inttypes.h>
+#include <string.h>
+
+#include "net/gcoap.h"
+
+#include "energy.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+static ssize_t _energy_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx);
+
+static const coap_resource_t _resources[] = {
+    { ENERGY_URI, COAP_GET | COAP_DELETE, _energy_handler, NULL },
+};
+
+static gcoap_listener_t _listener = {
+    (coap_resource_t *)&_resources[0],
+    sizeof(_resources) / sizeof(_resources[0]),
+    NULL
+};
+
+static ssize_t _energy_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx)
+{
+    (void)ctx;
+    unsigned method_flag = coap_method2flag(coap_get_code_detail(pdu));
+
+    if (method_flag & COAP_DELETE) {
+        energy_reset();
+        return coap_reply_simple(pdu, COAP_CODE_DELETED, buf, len,
+                                 COAP_FORMAT_TEXT, NULL, 0);
+    }
+
+    gcoap_resp_init(pdu, buf, len, COAP_CODE_CONTENT);
+    ssize_t n = energy_format((char *)pdu->payload, pdu->payload_len);
+    if (n < 0) {
+        DEBUG("[ERROR] energy: summary does not fit in %u bytes\n",
+              (unsigned)pdu->payload_len);
+        return coap_reply_simple(pdu, COAP_CODE_INTERNAL_SERVER_ERROR, buf, len,
+                                 COAP_FORMAT_TEXT, NULL, 0);
+    }
+
+    return gcoap_finish(pdu, n, COAP_FORMAT_TEXT);
+}
+
+void init_energy_handler(void)
+{
+    energy_init();
+    gcoap_register_listener(&_listener);
+}
+
+#else
+typedef int dont_be_pedantic;
+#endif /* MODULE_GCOAP */
@@ -0,0 +1,60 @@
+#ifndef ENERGY_PARAMS_H
+#define ENERGY_PARAMS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Typical currents in uA from the MCU and radio datasheets, the power
+ * modes are listed from the deepest one. They are estimates to compare
+ * firmwares and settings, calibrate them against a measured board. */
+#if defined(BOARD_SAMR21_XPRO)
+/* SAM R21 at 48MHz and its AT86RF233 */
+#define ENERGY_MCU_ACTIVE_UA        (6600)
+#define ENERGY_MCU_IDLE_UA          (2400)
+#define ENERGY_MCU_PM_UA            { 4, 1300, 1800 }   /* standby, idle 2, idle 1 */
+#define ENERGY_RADIO_TX_UA          (13800)
+#define ENERGY_RADIO_RX_UA          (11800)
+#elif defined(BOARD_IOTLAB_M3) || defined(BOARD_IOTLAB_A8_M3)
+/* STM32F103 at 72MHz and its AT86RF231 */
+#define ENERGY_MCU_ACTIVE_UA        (36000)
+#define ENERGY_MCU_IDLE_UA          (14000)
+#define ENERGY_MCU_PM_UA            { 2, 24 }           /* standby, stop */
+#define ENERGY_RADIO_TX_UA          (14000)
+#define ENERGY_RADIO_RX_UA          (12300)
+#endif
+
+/* Other boards, and native, use the SAM R21 figures */
+#ifndef ENERGY_MCU_ACTIVE_UA
+#define ENERGY_MCU_ACTIVE_UA        (6600)
+#endif
+#ifndef ENERGY_MCU_IDLE_UA
+#define ENERGY_MCU_IDLE_UA          (2400)      /* sleeping without a power mode */
+#endif
+#ifndef ENERGY_MCU_PM_UA
+#define ENERGY_MCU_PM_UA            { 4, 1300, 1800 }
+#endif
+#ifndef ENERGY_RADIO_TX_UA
+#define ENERGY_RADIO_TX_UA          (13800)
+#endif
+#ifndef ENERGY_RADIO_RX_UA
+#define ENERGY_RADIO_RX_UA          (11800)     /* receiving, and listening */
+#endif
+
+/* IEEE 802.15.4 at 250kbit/s, each frame adds its preamble, SFD and PHR */
+#ifndef ENERGY_RADIO_US_PER_BYTE
+#define ENERGY_RADIO_US_PER_BYTE    (32U)
+#endif
+#ifndef ENERGY_RADIO_FRAME_OVERHEAD
+#define ENERGY_RADIO_FRAME_OVERHEAD (6U)
+#endif
+
+#ifndef ENERGY_BATTERY_MAH
+#define ENERGY_BATTERY_MAH          (2400U)     /* two AA cells */
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ENERGY_PARAMS_H */
@@ -0,0 +1,283 @@
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "irq.h"
+#include "xtimer.h"
+
+#include "metrics.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+#define METRICS_COST_LOOPS      (1000U)
+
+#define METRICS_NAME(id, name)  name,
+
+static const char *_counter_names[] = { METRICS_COUNTERS(METRICS_NAME) };
+static const char *_peak_names[] = { METRICS_PEAKS(METRICS_NAME) };
+static const char *_latency_names[] = { METRICS_LATENCIES(METRICS_NAME) };
+
+static uint32_t _counters[METRICS_COUNTER_NUMOF];
+static uint32_t _peaks[METRICS_PEAK_NUMOF];
+static metrics_hist_t _latencies[METRICS_LATENCY_NUMOF];
+static uint64_t _since = 0;
+
+/* the counters are updated from several threads, an irq lock is cheaper
+   than a mutex on these few instructions */
+static void _add(uint32_t *counter, uint32_t n)
+{
+    unsigned state = irq_disable();
+    *counter += n;
+    irq_restore(state);
+}
+
+static void _record(metrics_hist_t *hist, uint32_t us)
+{
+    unsigned bucket = 0;
+    for (uint32_t v = us >> 4; v && (bucket < METRICS_BUCKETS - 1); v >>= 2) {
+        bucket++;
+    }
+
+    unsigned state = irq_disable();
+    hist->count++;
+    hist->sum += us;
+    if (us > hist->max) {
+        hist->max = us;
+    }
+    hist->buckets[bucket]++;
+    irq_restore(state);
+}
+
+void metrics_add(metrics_counter_t id, uint32_t n)
+{
+    _add(&_counters[id], n);
+}
+
+void metrics_peak(metrics_peak_t id, uint32_t value)
+{
+    unsigned state = irq_disable();
+    if (value > _peaks[id]) {
+        _peaks[id] = value;
+    }
+    irq_restore(state);
+}
+
+void metrics_latency(metrics_latency_t id, uint32_t us)
+{
+    _record(&_latencies[id], us);
+}
+
+uint32_t metrics_get_counter(metrics_counter_t id)
+{
+    return _counters[id];
+}
+
+uint32_t metrics_get_peak(metrics_peak_t id)
+{
+    return _peaks[id];
+}
+
+void metrics_get_latency(metrics_latency_t id, metrics_hist_t *hist)
+{
+    unsigned state = irq_disable();
+    *hist = _latencies[id];
+    irq_restore(state);
+}
+
+void metrics_reset(void)
+{
+    unsigned state = irq_disable();
+    memset(_counters, 0, sizeof(_counters));
+    memset(_peaks, 0, sizeof(_peaks));
+    memset(_latencies, 0, sizeof(_latencies));
+    irq_restore(state);
+    _since = xtimer_now_usec64();
+}
+
+/* Minimal CBOR writer, only what the reports need: maps, arrays, text
+ * strings and unsigned integers */
+typedef struct {
+    uint8_t *buf;
+    size_t len;
+    size_t pos;
+} _cbor_t;
+
+static void _cbor_head(_cbor_t *c, uint8_t major, uint64_t value)
+{
+    uint8_t head[9];
+    size_t n;
+
+    if (value < 24) {
+        head[0] = (major << 5) | value;
+        n = 1;
+    }
+    else {
+        unsigned size = (value <= UINT8_MAX) ? 1 : (value <= UINT16_MAX) ? 2 :
+                        (value <= UINT32_MAX) ? 4 : 8;
+        /* additional information 24 to 27 for 1 to 8 bytes */
+        head[0] = (major << 5) | (24 + ((size == 8) ? 3 : size / 2));
+        for (unsigned i = 0; i < size; i++) {
+            head[size - i] = (uint8_t)(value >> (8 * i));
+        }
+        n = size + 1;
+    }
+
+    if (c->pos + n <= c->len) {
+        memcpy(&c->buf[c->pos], head, n);
+    }
+    c->pos += n;
+}
+
+static void _cbor_uint(_cbor_t *c, uint64_t value)
+{
+    _cbor_head(c, 0, value);
+}
+
+static void _cbor_text(_cbor_t *c, const char *str)
+{
+    size_t n = strlen(str);
+    _cbor_head(c, 3, n);
+    if (c->pos + n <= c->len) {
+        memcpy(&c->buf[c->pos], str, n);
+    }
+    c->pos += n;
+}
+
+static void _cbor_array(_cbor_t *c, size_t numof)
+{
+    _cbor_head(c, 4, numof);
+}
+
+static void _cbor_map(_cbor_t *c, size_t numof)
+{
+    _cbor_head(c, 5, numof);
+}
+
+static ssize_t _cbor_end(const _cbor_t *c)
+{
+    return (c->pos <= c->len) ? (ssize_t)c->pos : -ENOSPC;
+}
+
+ssize_t metrics_encode(uint8_t *buf, size_t len)
+{
+    _cbor_t c = { buf, len, 0 };
+
+    _cbor_map(&c, 3);
+    _cbor_text(&c, "uptime");
+    _cbor_uint(&c, (xtimer_now_usec64() - _since) / US_PER_SEC);
+
+    _cbor_text(&c, "counters");
+    _cbor_map(&c, METRICS_COUNTER_NUMOF);
+    for (unsigned i = 0; i < METRICS_COUNTER_NUMOF; i++) {
+        _cbor_text(&c, _counter_names[i]);
+        _cbor_uint(&c, _counters[i]);
+    }
+
+    _cbor_text(&c, "peaks");
+    _cbor_map(&c, METRICS_PEAK_NUMOF);
+    for (unsigned i = 0; i < METRICS_PEAK_NUMOF; i++) {
+        _cbor_text(&c, _peak_names[i]);
+        _cbor_uint(&c, _peaks[i]);
+    }
+
+    return _cbor_end(&c);
+}
+
+ssize_t metrics_encode_latency(uint8_t *buf, size_t len)
+{
+    _cbor_t c = { buf, len, 0 };
+
+    _cbor_map(&c, METRICS_LATENCY_NUMOF);
+    for (unsigned i = 0; i < METRICS_LATENCY_NUMOF; i++) {
+        metrics_hist_t hist;
+        metrics_get_latency(i, &hist);
+
+        /* trailing empty buckets are left out */
+        unsigned numof = METRICS_BUCKETS;
+        while (numof && (hist.buckets[numof - 1] == 0)) {
+            numof--;
+        }
+
+        _cbor_text(&c, _latency_names[i]);
+        _cbor_array(&c, 4);
+        _cbor_uint(&c, hist.count);
+        _cbor_uint(&c, hist.sum);
+        _cbor_uint(&c, hist.max);
+        _cbor_array(&c, numof);
+        for (unsigned b = 0; b < numof; b++) {
+            _cbor_uint(&c, hist.buckets[b]);
+        }
+    }
+
+    return _cbor_end(&c);
+}
+
+/* time taken by the instrumentation itself, with the same code paths as
+   the real counters */
+static void _print_cost(void)
+{
+    uint32_t counter = 0;
+    metrics_hist_t hist;
+    memset(&hist, 0, sizeof(hist));
+
+    uint32_t begin = xtimer_now_usec();
+    for (unsigned i = 0; i < METRICS_COST_LOOPS; i++) {
+        _add(&counter, 1);
+    }
+    uint32_t add = xtimer_now_usec() - begin;
+
+    begin = xtimer_now_usec();
+    for (unsigned i = 0; i < METRICS_COST_LOOPS; i++) {
+        uint32_t t = xtimer_now_usec();
+        _record(&hist, xtimer_now_usec() - t);
+    }
+    uint32_t latency = xtimer_now_usec() - begin;
+
+    printf("counter: %" PRIu32 " ns\n",
+           (uint32_t)(((uint64_t)add * 1000) / METRICS_COST_LOOPS));
+    printf("latency: %" PRIu32 " ns (timestamps included)\n",
+           (uint32_t)(((uint64_t)latency * 1000) / METRICS_COST_LOOPS));
+}
+
+int metrics_cmd(int argc, char **argv)
+{
+    if ((argc > 1) && (strcmp(argv[1], "reset") == 0)) {
+        metrics_reset();
+        return 0;
+    }
+    if ((argc > 1) && (strcmp(argv[1], "cost") == 0)) {
+        _print_cost();
+        return 0;
+    }
+    if (argc > 1) {
+        printf("usage: %s [reset|cost]\n", argv[0]);
+        return 1;
+    }
+
+    printf("uptime: %" PRIu32 " s\n",
+           (uint32_t)((xtimer_now_usec64() - _since) / US_PER_SEC));
+    for (unsigned i = 0; i < METRICS_COUNTER_NUMOF; i++) {
+        printf("%-14s %" PRIu32 "\n", _counter_names[i], _counters[i]);
+    }
+    for (unsigned i = 0; i < METRICS_PEAK_NUMOF; i++) {
+        printf("%-14s %" PRIu32 " (peak)\n", _peak_names[i], _peaks[i]);
+    }
+
+    puts("latency        count   avg us   max us  <16 <64 <256 <1m <4m <16m <65m more");
+    for (unsigned i = 0; i < METRICS_LATENCY_NUMOF; i++) {
+        metrics_hist_t hist;
+        metrics_get_latency(i, &hist);
+        printf("%-14s %5" PRIu32 " %8" PRIu32 " %8" PRIu32 " ",
+               _latency_names[i], hist.count,
+               (hist.count) ? (uint32_t)(hist.sum / hist.count) : 0, hist.max);
+        for (unsigned b = 0; b < METRICS_BUCKETS; b++) {
+            printf(" %" PRIu32, hist.buckets[b]);
+        }
+        puts("");
+    }
+
+    return 0;
+}
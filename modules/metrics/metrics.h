@@ -0,0 +1,101 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <sys/types.h>
+
+#ifdef MODULE_METRICS
+#include "xtimer.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define METRICS_URI             "/metrics"
+#define METRICS_LATENCY_URI     "/metrics/latency"
+
+/* Latencies are counted in buckets growing by 4: <16us, <64us, ... <65ms
+ * and above */
+#define METRICS_BUCKETS         (8U)
+
+/* Event counters */
+#define METRICS_COUNTERS(X) \
+    X(COAP_TX, "coap_tx") \
+    X(COAP_TX_ERR, "coap_tx_err") \
+    X(COAP_TX_BYTES, "coap_tx_bytes") \
+    X(MQTT_TX, "mqtt_tx") \
+    X(MQTT_TX_ERR, "mqtt_tx_err") \
+    X(SENSOR_ERR, "sensor_err") \
+    X(IMU_DROP, "imu_drop")
+
+/* High-water marks, e.g. of message queues */
+#define METRICS_PEAKS(X) \
+    X(BUS_QUEUE, "bus_queue") \
+    X(IMU_QUEUE, "imu_queue")
+
+/* Latencies: CoAP handlers, sensor reads, value formatting and uplinks */
+#define METRICS_LATENCIES(X) \
+    X(HANDLER, "handler") \
+    X(SENSOR, "sensor") \
+    X(ENCODE, "encode") \
+    X(SEND, "send")
+
+#define METRICS_ID(id, name)    METRICS_##id,
+
+typedef enum { METRICS_COUNTERS(METRICS_ID) METRICS_COUNTER_NUMOF } metrics_counter_t;
+typedef enum { METRICS_PEAKS(METRICS_ID) METRICS_PEAK_NUMOF } metrics_peak_t;
+typedef enum { METRICS_LATENCIES(METRICS_ID) METRICS_LATENCY_NUMOF } metrics_latency_t;
+
+typedef struct {
+    uint32_t count;
+    uint32_t max;               /* us */
+    uint64_t sum;               /* us */
+    uint32_t buckets[METRICS_BUCKETS];
+} metrics_hist_t;
+
+/* The instrumentation points use these macros, they compile to nothing
+ * without the metrics module */
+#ifdef MODULE_METRICS
+#define METRICS_INC(id)             metrics_add(METRICS_##id, 1)
+#define METRICS_ADD(id, n)          metrics_add(METRICS_##id, (n))
+#define METRICS_PEAK(id, v)         metrics_peak(METRICS_##id, (v))
+#define METRICS_START(t)            uint32_t t = xtimer_now_usec()
+#define METRICS_STOP(id, t)         metrics_latency(METRICS_##id, xtimer_now_usec() - (t))
+#define METRICS_RECORD(id, us)      metrics_latency(METRICS_##id, (us))
+#else
+#define METRICS_INC(id)
+#define METRICS_ADD(id, n)
+#define METRICS_PEAK(id, v)
+#define METRICS_START(t)
+#define METRICS_STOP(id, t)
+#define METRICS_RECORD(id, us)
+#endif
+
+void metrics_add(metrics_counter_t id, uint32_t n);
+void metrics_peak(metrics_peak_t id, uint32_t value);
+void metrics_latency(metrics_latency_t id, uint32_t us);
+
+uint32_t metrics_get_counter(metrics_counter_t id);
+uint32_t metrics_get_peak(metrics_peak_t id);
+void metrics_get_latency(metrics_latency_t id, metrics_hist_t *hist);
+void metrics_reset(void);
+
+/* CBOR encoding of the counters and peaks ({"uptime": s, "counters":
+ * {name: n}, "peaks": {name: n}}) and of the latencies ({name: [count,
+ * sum, max, [buckets]]}), return -ENOSPC if the buffer is too small */
+ssize_t metrics_encode(uint8_t *buf, size_t len);
+ssize_t metrics_encode_latency(uint8_t *buf, size_t len);
+
+/* Registers /metrics (GET, DELETE resets) and /metrics/latency */
+void init_metrics_handler(void);
+
+/* "metrics [reset|cost]" shell command */
+int metrics_cmd(int argc, char **argv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* METRICS_H */
@@ -0,0 +1,330 @@
+/* Generated by tools/imu_fusion_trace.py --rate 50 --duration 6 --seed 1,
+ * do not edit. Accelerometer in mg, gyroscope body rates in 1/100
+ * dps, true roll and pitch in 1/100 degrees. */
+
+#ifndef IMU_FUSION_TRACE_H
+#define IMU_FUSION_TRACE_H
+
+#include <inttypes.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define IMU_FUSION_TRACE_DT     (20000U)  /* us between samples */
+
+typedef struct {
+    int16_t acc[3];
+    int16_t gyro[3];
+    int16_t roll;
+    int16_t pitch;
+} imu_fusion_trace_t;
+
+static const imu_fusion_trace_t imu_fusion_trace[] = {
+    { { -270, 22, 958 }, { 4450, 2200, 978 }, 0, 1683 },
+    { { -312, -6, 958 }, { 4467, 2115, 913 }, 94, 1727 },
+    { { -304, 30, 930 }, { 4466, 1970, 980 }, 188, 1767 },
+    { { -307, 45, 968 }, { 4438, 1846, 870 }, 282, 1805 },
+    { { -312, 78, 957 }, { 4414, 1640, 872 }, 376, 1840 },
+    { { -320, 88, 947 }, { 4416, 1522, 849 }, 469, 1871 },
+    { { -315, 76, 935 }, { 4339, 1431, 829 }, 562, 1899 },
+    { { -320, 117, 934 }, { 4273, 1247, 815 }, 654, 1923 },
+    { { -322, 103, 928 }, { 4319, 1105, 789 }, 746, 1945 },
+    { { -356, 136, 943 }, { 4244, 914, 805 }, 837, 1963 },
+    { { -329, 168, 922 }, { 4151, 724, 869 }, 927, 1977 },
+    { { -366, 165, 911 }, { 4140, 581, 865 }, 1016, 1988 },
+    { { -319, 186, 943 }, { 4086, 416, 899 }, 1104, 1995 },
+    { { -384, 193, 922 }, { 3996, 286, 900 }, 1191, 1999 },
+    { { -379, 205, 902 }, { 3956, 109, 988 }, 1277, 2000 },
+    { { -340, 221, 919 }, { 3853, -6, 958 }, 1362, 1997 },
+    { { -334, 218, 896 }, { 3827, -141, 1055 }, 1445, 1990 },
+    { { -348, 244, 890 }, { 3766, -368, 1105 }, 1527, 1980 },
+    { { -357, 256, 892 }, { 3671, -481, 1140 }, 1607, 1967 },
+    { { -325, 291, 919 }, { 3573, -635, 1140 }, 1686, 1950 },
+    { { -331, 315, 897 }, { 3521, -792, 1255 }, 1763, 1929 },
+    { { -326, 287, 913 }, { 3474, -946, 1328 }, 1839, 1905 },
+    { { -312, 326, 900 }, { 3380, -1088, 1354 }, 1912, 1878 },
+    { { -324, 337, 907 }, { 3272, -1233, 1465 }, 1984, 1848 },
+    { { -286, 354, 880 }, { 3173, -1391, 1494 }, 2054, 1814 },
+    { { -302, 345, 902 }, { 3115, -1451, 1642 }, 2121, 1777 },
+    { { -307, 339, 893 }, { 3058, -1590, 1644 }, 2187, 1737 },
+    { { -288, 388, 868 }, { 2899, -1738, 1794 }, 2250, 1694 },
+    { { -272, 381, 912 }, { 2758, -1856, 1889 }, 2312, 1648 },
+    { { -289, 419, 880 }, { 2632, -1946, 1915 }, 2370, 1599 },
+    { { -264, 393, 895 }, { 2483, -2069, 1981 }, 2427, 1548 },
+    { { -230, 376, 872 }, { 2407, -2174, 2086 }, 2481, 1493 },
+    { { -242, 436, 867 }, { 2335, -2215, 2170 }, 2533, 1436 },
+    { { -243, 440, 860 }, { 2265, -2337, 2214 }, 2582, 1377 },
+    { { -223, 444, 899 }, { 2088, -2440, 2309 }, 2629, 1315 },
+    { { -230, 414, 884 }, { 1961, -2477, 2331 }, 2673, 1251 },
+    { { -249, 451, 873 }, { 1899, -2572, 2440 }, 2714, 1184 },
+    { { -185, 448, 871 }, { 1687, -2644, 2473 }, 2753, 1116 },
+    { { -188, 471, 883 }, { 1573, -2666, 2542 }, 2789, 1045 },
+    { { -156, 480, 872 }, { 1482, -2735, 2646 }, 2823, 973 },
+    { { -150, 444, 857 }, { 1385, -2840, 2646 }, 2853, 899 },
+    { { -153, 472, 877 }, { 1233, -2868, 2702 }, 2881, 823 },
+    { { -115, 474, 862 }, { 1144, -2943, 2770 }, 2906, 746 },
+    { { -119, 480, 890 }, { 1003, -2967, 2823 }, 2928, 668 },
+    { { -87, 488, 873 }, { 843, -3024, 2905 }, 2947, 588 },
+    { { -62, 512, 837 }, { 754, -3038, 2875 }, 2963, 508 },
+    { { -75, 512, 883 }, { 592, -3083, 2918 }, 2976, 426 },
+    { { -48, 496, 852 }, { 415, -3115, 2950 }, 2987, 344 },
+    { { -12, 478, 873 }, { 298, -3121, 2999 }, 2994, 261 },
+    { { -12, 497, 857 }, { 126, -3146, 3008 }, 2999, 178 },
+    { { -20, 510, 877 }, { 45, -3121, 2975 }, 3000, 94 },
+    { { -14, 482, 880 }, { -111, -3168, 3005 }, 2999, 11 },
+    { { 1, 526, 876 }, { -249, -3177, 3008 }, 2994, -73 },
+    { { 10, 488, 867 }, { -360, -3153, 2978 }, 2987, -157 },
+    { { 36, 494, 886 }, { -479, -3157, 3003 }, 2976, -240 },
+    { { 26, 495, 878 }, { -602, -3126, 2920 }, 2963, -323 },
+    { { 79, 488, 876 }, { -848, -3099, 2883 }, 2947, -405 },
+    { { 99, 498, 880 }, { -905, -3073, 2866 }, 2928, -487 },
+    { { 102, 481, 857 }, { -964, -3036, 2779 }, 2906, -568 },
+    { { 126, 458, 867 }, { -1169, -3040, 2808 }, 2881, -648 },
+    { { 122, 452, 871 }, { -1269, -2932, 2743 }, 2853, -726 },
+    { { 122, 463, 882 }, { -1433, -2963, 2723 }, 2823, -804 },
+    { { 153, 466, 864 }, { -1557, -2902, 2649 }, 2789, -880 },
+    { { 161, 462, 883 }, { -1639, -2824, 2570 }, 2753, -954 },
+    { { 161, 461, 876 }, { -1775, -2814, 2529 }, 2714, -1027 },
+    { { 181, 429, 867 }, { -1944, -2713, 2507 }, 2673, -1098 },
+    { { 192, 435, 862 }, { -1998, -2590, 2368 }, 2629, -1167 },
+    { { 210, 447, 885 }, { -2132, -2633, 2331 }, 2582, -1234 },
+    { { 239, 438, 890 }, { -2268, -2513, 2209 }, 2533, -1299 },
+    { { 219, 425, 880 }, { -2404, -2368, 2140 }, 2481, -1361 },
+    { { 264, 394, 889 }, { -2454, -2310, 2153 }, 2427, -1421 },
+    { { 256, 384, 875 }, { -2626, -2244, 2068 }, 2370, -1479 },
+    { { 277, 399, 928 }, { -2668, -2108, 1922 }, 2312, -1534 },
+    { { 270, 401, 897 }, { -2797, -2009, 1828 }, 2250, -1587 },
+    { { 269, 338, 858 }, { -2871, -1879, 1802 }, 2187, -1636 },
+    { { 295, 331, 899 }, { -2970, -1747, 1778 }, 2121, -1683 },
+    { { 304, 333, 882 }, { -3107, -1656, 1673 }, 2054, -1727 },
+    { { 304, 348, 906 }, { -3181, -1556, 1584 }, 1984, -1767 },
+    { { 296, 297, 904 }, { -3289, -1431, 1546 }, 1912, -1805 },
+    { { 313, 319, 900 }, { -3312, -1277, 1386 }, 1839, -1840 },
+    { { 339, 284, 873 }, { -3438, -1150, 1333 }, 1763, -1871 },
+    { { 316, 283, 926 }, { -3488, -978, 1340 }, 1686, -1899 },
+    { { 292, 251, 910 }, { -3680, -848, 1272 }, 1607, -1923 },
+    { { 321, 243, 896 }, { -3674, -726, 1187 }, 1527, -1945 },
+    { { 321, 241, 907 }, { -3715, -567, 1089 }, 1445, -1963 },
+    { { 317, 223, 907 }, { -3796, -400, 1084 }, 1362, -1977 },
+    { { 315, 190, 926 }, { -3905, -237, 1036 }, 1277, -1988 },
+    { { 349, 181, 918 }, { -4022, -121, 1016 }, 1191, -1995 },
+    { { 328, 167, 922 }, { -3988, 18, 984 }, 1104, -1999 },
+    { { 317, 183, 904 }, { -4067, 240, 904 }, 1016, -2000 },
+    { { 317, 153, 914 }, { -4124, 338, 887 }, 927, -1997 },
+    { { 326, 121, 954 }, { -4155, 547, 848 }, 837, -1990 },
+    { { 347, 103, 926 }, { -4157, 661, 817 }, 746, -1980 },
+    { { 328, 105, 944 }, { -4242, 826, 870 }, 654, -1967 },
+    { { 309, 91, 926 }, { -4232, 989, 862 }, 562, -1950 },
+    { { 294, 76, 935 }, { -4302, 1133, 832 }, 469, -1929 },
+    { { 329, 72, 952 }, { -4314, 1353, 905 }, 376, -1905 },
+    { { 308, 45, 921 }, { -4323, 1475, 933 }, 282, -1878 },
+    { { 311, 4, 945 }, { -4295, 1607, 954 }, 188, -1848 },
+    { { 324, 39, 959 }, { -4369, 1762, 1017 }, 94, -1814 },
+    { { 297, -28, 984 }, { -4345, 1872, 954 }, 0, -1777 },
+    { { 275, -5, 956 }, { -4380, 2016, 996 }, -94, -1737 },
+    { { 307, -34, 977 }, { -4387, 2145, 1035 }, -188, -1694 },
+    { { 276, -49, 973 }, { -4321, 2260, 1133 }, -282, -1648 },
+    { { 277, -39, 957 }, { -4375, 2440, 1163 }, -376, -1599 },
+    { { 260, -79, 962 }, { -4328, 2484, 1161 }, -469, -1548 },
+    { { 259, -91, 954 }, { -4374, 2689, 1245 }, -562, -1493 },
+    { { 232, -86, 979 }, { -4270, 2780, 1332 }, -654, -1436 },
+    { { 223, -126, 968 }, { -4257, 2871, 1347 }, -746, -1377 },
+    { { 218, -147, 960 }, { -4274, 2896, 1406 }, -837, -1315 },
+    { { 221, -157, 972 }, { -4272, 3026, 1537 }, -927, -1251 },
+    { { 176, -189, 938 }, { -4142, 3121, 1562 }, -1016, -1184 },
+    { { 196, -189, 977 }, { -4103, 3222, 1659 }, -1104, -1116 },
+    { { 193, -191, 980 }, { -4149, 3272, 1722 }, -1191, -1045 },
+    { { 171, -222, 960 }, { -4030, 3327, 1794 }, -1277, -973 },
+    { { 140, -251, 949 }, { -4046, 3359, 1836 }, -1362, -899 },
+    { { 116, -276, 951 }, { -3954, 3485, 1957 }, -1445, -823 },
+    { { 118, -269, 941 }, { -3900, 3447, 1999 }, -1527, -746 },
+    { { 107, -263, 964 }, { -3754, 3450, 2088 }, -1607, -668 },
+    { { 97, -313, 947 }, { -3794, 3512, 2215 }, -1686, -588 },
+    { { 108, -274, 967 }, { -3720, 3542, 2201 }, -1763, -508 },
+    { { 81, -330, 917 }, { -3536, 3575, 2266 }, -1839, -426 },
+    { { 53, -324, 925 }, { -3492, 3547, 2310 }, -1912, -344 },
+    { { 39, -340, 942 }, { -3451, 3566, 2375 }, -1984, -261 },
+    { { 30, -364, 954 }, { -3315, 3547, 2364 }, -2054, -178 },
+    { { 11, -347, 933 }, { -3227, 3496, 2490 }, -2121, -94 },
+    { { 10, -409, 922 }, { -3181, 3466, 2481 }, -2187, -11 },
+    { { 11, -385, 936 }, { -3119, 3392, 2532 }, -2250, 73 },
+    { { -21, -403, 927 }, { -2957, 3405, 2577 }, -2312, 157 },
+    { { -53, -385, 941 }, { -2865, 3361, 2585 }, -2370, 240 },
+    { { -61, -397, 899 }, { -2732, 3291, 2629 }, -2427, 323 },
+    { { -51, -392, 899 }, { -2646, 3350, 2682 }, -2481, 405 },
+    { { -118, -422, 936 }, { -2595, 3243, 2596 }, -2533, 487 },
+    { { -75, -446, 908 }, { -2420, 3068, 2622 }, -2582, 568 },
+    { { -108, -463, 891 }, { -2361, 3123, 2651 }, -2629, 648 },
+    { { -140, -437, 904 }, { -2221, 3018, 2676 }, -2673, 726 },
+    { { -147, -470, 889 }, { -2107, 2890, 2677 }, -2714, 804 },
+    { { -146, -455, 865 }, { -1981, 2867, 2650 }, -2753, 880 },
+    { { -178, -475, 877 }, { -1845, 2788, 2579 }, -2789, 954 },
+    { { -164, -439, 881 }, { -1721, 2699, 2548 }, -2823, 1027 },
+    { { -197, -438, 838 }, { -1631, 2602, 2535 }, -2853, 1098 },
+    { { -211, -489, 883 }, { -1485, 2471, 2463 }, -2881, 1167 },
+    { { -202, -475, 861 }, { -1288, 2382, 2439 }, -2906, 1234 },
+    { { -240, -475, 870 }, { -1239, 2265, 2423 }, -2928, 1299 },
+    { { -226, -491, 851 }, { -1045, 2162, 2373 }, -2947, 1361 },
+    { { -236, -471, 861 }, { -965, 2089, 2313 }, -2963, 1421 },
+    { { -272, -488, 821 }, { -802, 1968, 2191 }, -2976, 1479 },
+    { { -282, -469, 832 }, { -634, 1780, 2193 }, -2987, 1534 },
+    { { -312, -493, 845 }, { -483, 1749, 2125 }, -2994, 1587 },
+    { { -295, -485, 802 }, { -339, 1612, 2028 }, -2999, 1636 },
+    { { -262, -499, 837 }, { -264, 1399, 1992 }, -3000, 1683 },
+    { { -314, -459, 814 }, { -96, 1309, 1908 }, -2999, 1727 },
+    { { -313, -463, 835 }, { 44, 1189, 1883 }, -2994, 1767 },
+    { { -320, -480, 836 }, { 183, 1012, 1738 }, -2987, 1805 },
+    { { -321, -486, 827 }, { 291, 918, 1626 }, -2976, 1840 },
+    { { -297, -473, 830 }, { 475, 810, 1571 }, -2963, 1871 },
+    { { -314, -463, 787 }, { 617, 611, 1519 }, -2947, 1899 },
+    { { -326, -467, 786 }, { 684, 474, 1394 }, -2928, 1923 },
+    { { -354, -428, 831 }, { 886, 337, 1309 }, -2906, 1945 },
+    { { -339, -461, 824 }, { 1053, 170, 1241 }, -2881, 1963 },
+    { { -322, -470, 824 }, { 1156, 43, 1178 }, -2853, 1977 },
+    { { -345, -428, 835 }, { 1298, -61, 1055 }, -2823, 1988 },
+    { { -366, -418, 836 }, { 1478, -272, 1016 }, -2789, 1995 },
+    { { -330, -435, 801 }, { 1583, -387, 898 }, -2753, 1999 },
+    { { -341, -442, 834 }, { 1715, -473, 823 }, -2714, 2000 },
+    { { -306, -440, 837 }, { 1885, -715, 770 }, -2673, 1997 },
+    { { -334, -425, 839 }, { 2026, -833, 687 }, -2629, 1990 },
+    { { -332, -392, 816 }, { 2066, -1011, 602 }, -2582, 1980 },
+    { { -327, -390, 847 }, { 2284, -1125, 565 }, -2533, 1967 },
+    { { -345, -383, 845 }, { 2400, -1248, 539 }, -2481, 1950 },
+    { { -337, -405, 873 }, { 2499, -1441, 386 }, -2427, 1929 },
+    { { -314, -409, 858 }, { 2644, -1583, 387 }, -2370, 1905 },
+    { { -315, -363, 887 }, { 2751, -1737, 289 }, -2312, 1878 },
+    { { -321, -373, 882 }, { 2886, -1850, 262 }, -2250, 1848 },
+    { { -308, -354, 875 }, { 3003, -2002, 256 }, -2187, 1814 },
+    { { -324, -384, 877 }, { 3111, -2172, 212 }, -2121, 1777 },
+    { { -303, -328, 894 }, { 3238, -2312, 178 }, -2054, 1737 },
+    { { -270, -313, 910 }, { 3309, -2449, 174 }, -1984, 1694 },
+    { { -276, -313, 878 }, { 3439, -2600, 132 }, -1912, 1648 },
+    { { -281, -314, 899 }, { 3495, -2693, 130 }, -1839, 1599 },
+    { { -260, -312, 930 }, { 3561, -2829, 113 }, -1763, 1548 },
+    { { -267, -299, 906 }, { 3683, -3006, 130 }, -1686, 1493 },
+    { { -231, -281, 926 }, { 3778, -3118, 143 }, -1607, 1436 },
+    { { -235, -240, 926 }, { 3862, -3222, 193 }, -1527, 1377 },
+    { { -243, -240, 954 }, { 3970, -3351, 144 }, -1445, 1315 },
+    { { -244, -238, 945 }, { 3987, -3412, 204 }, -1362, 1251 },
+    { { -209, -224, 962 }, { 4100, -3523, 214 }, -1277, 1184 },
+    { { -178, -227, 944 }, { 4235, -3603, 311 }, -1191, 1116 },
+    { { -193, -177, 980 }, { 4278, -3729, 345 }, -1104, 1045 },
+    { { -163, -193, 1007 }, { 4319, -3769, 324 }, -1016, 973 },
+    { { -170, -146, 987 }, { 4353, -3875, 352 }, -927, 899 },
+    { { -174, -128, 962 }, { 4454, -3919, 455 }, -837, 823 },
+    { { -107, -123, 988 }, { 4485, -4000, 509 }, -746, 746 },
+    { { -130, -114, 981 }, { 4618, -4029, 533 }, -654, 668 },
+    { { -94, -124, 991 }, { 4631, -4109, 656 }, -562, 588 },
+    { { -94, -75, 998 }, { 4550, -4174, 738 }, -469, 508 },
+    { { -87, -47, 1021 }, { 4650, -4149, 758 }, -376, 426 },
+    { { -69, -40, 1004 }, { 4652, -4214, 773 }, -282, 344 },
+    { { -51, -33, 984 }, { 4652, -4193, 920 }, -188, 261 },
+    { { -45, -15, 989 }, { 4650, -4155, 959 }, -94, 178 },
+    { { -38, 19, 1011 }, { 4788, -4192, 1036 }, 0, 94 },
+    { { 20, 12, 1003 }, { 4726, -4236, 1095 }, 94, 11 },
+    { { 16, 9, 1005 }, { 4796, -4219, 1147 }, 188, -73 },
+    { { 53, 36, 1007 }, { 4792, -4146, 1228 }, 282, -157 },
+    { { 50, 70, 999 }, { 4723, -4107, 1266 }, 376, -240 },
+    { { 79, 115, 1012 }, { 4696, -4038, 1357 }, 469, -323 },
+    { { 54, 79, 1009 }, { 4730, -4017, 1416 }, 562, -405 },
+    { { 99, 73, 1008 }, { 4709, -3965, 1491 }, 654, -487 },
+    { { 104, 95, 996 }, { 4709, -3914, 1510 }, 746, -568 },
+    { { 89, 156, 1005 }, { 4669, -3820, 1536 }, 837, -648 },
+    { { 116, 145, 979 }, { 4710, -3690, 1657 }, 927, -726 },
+    { { 125, 187, 964 }, { 4597, -3609, 1668 }, 1016, -804 },
+    { { 190, 192, 965 }, { 4607, -3568, 1731 }, 1104, -880 },
+    { { 189, 202, 957 }, { 4574, -3462, 1756 }, 1191, -954 },
+    { { 170, 222, 948 }, { 4510, -3301, 1827 }, 1277, -1027 },
+    { { 185, 238, 928 }, { 4416, -3194, 1757 }, 1362, -1098 },
+    { { 201, 231, 956 }, { 4400, -3094, 1837 }, 1445, -1167 },
+    { { 205, 259, 950 }, { 4337, -2935, 1882 }, 1527, -1234 },
+    { { 215, 267, 909 }, { 4280, -2855, 1820 }, 1607, -1299 },
+    { { 228, 288, 926 }, { 4174, -2682, 1830 }, 1686, -1361 },
+    { { 245, 279, 916 }, { 4071, -2519, 1864 }, 1763, -1421 },
+    { { 265, 310, 908 }, { 4045, -2447, 1752 }, 1839, -1479 },
+    { { 247, 338, 915 }, { 3992, -2274, 1842 }, 1912, -1534 },
+    { { 297, 341, 909 }, { 3891, -2116, 1843 }, 1984, -1587 },
+    { { 264, 325, 899 }, { 3744, -1897, 1784 }, 2054, -1636 },
+    { { 279, 371, 913 }, { 3660, -1747, 1767 }, 2121, -1683 },
+    { { 289, 347, 891 }, { 3607, -1589, 1739 }, 2187, -1727 },
+    { { 296, 338, 855 }, { 3515, -1445, 1686 }, 2250, -1767 },
+    { { 310, 375, 882 }, { 3378, -1313, 1573 }, 2312, -1805 },
+    { { 295, 384, 866 }, { 3296, -1186, 1490 }, 2370, -1840 },
+    { { 291, 389, 889 }, { 3130, -1012, 1504 }, 2427, -1871 },
+    { { 348, 413, 871 }, { 3052, -836, 1433 }, 2481, -1899 },
+    { { 336, 431, 820 }, { 2888, -652, 1357 }, 2533, -1923 },
+    { { 331, 407, 834 }, { 2797, -461, 1284 }, 2582, -1945 },
+    { { 342, 434, 835 }, { 2653, -375, 1269 }, 2629, -1963 },
+    { { 364, 420, 870 }, { 2553, -228, 1160 }, 2673, -1977 },
+    { { 344, 437, 847 }, { 2383, 24, 1076 }, 2714, -1988 },
+    { { 370, 433, 796 }, { 2320, 168, 930 }, 2753, -1995 },
+    { { 333, 428, 845 }, { 2108, 347, 887 }, 2789, -1999 },
+    { { 356, 435, 810 }, { 2006, 465, 833 }, 2823, -2000 },
+    { { 317, 433, 821 }, { 1907, 642, 680 }, 2853, -1997 },
+    { { 293, 481, 829 }, { 1667, 817, 669 }, 2881, -1990 },
+    { { 371, 460, 815 }, { 1585, 902, 543 }, 2906, -1980 },
+    { { 322, 452, 802 }, { 1371, 1063, 480 }, 2928, -1967 },
+    { { 334, 463, 828 }, { 1289, 1262, 443 }, 2947, -1950 },
+    { { 335, 472, 813 }, { 1150, 1440, 205 }, 2963, -1929 },
+    { { 339, 453, 826 }, { 970, 1507, 168 }, 2976, -1905 },
+    { { 318, 511, 802 }, { 803, 1681, 116 }, 2987, -1878 },
+    { { 334, 504, 821 }, { 675, 1822, 89 }, 2994, -1848 },
+    { { 311, 485, 820 }, { 543, 1970, -64 }, 2999, -1814 },
+    { { 334, 447, 827 }, { 345, 2082, -53 }, 3000, -1777 },
+    { { 304, 471, 813 }, { 211, 2244, -198 }, 2999, -1737 },
+    { { 281, 500, 832 }, { 40, 2338, -285 }, 2994, -1694 },
+    { { 295, 466, 841 }, { -113, 2517, -319 }, 2987, -1648 },
+    { { 269, 473, 833 }, { -245, 2702, -368 }, 2976, -1599 },
+    { { 247, 510, 836 }, { -441, 2756, -456 }, 2963, -1548 },
+    { { 262, 475, 841 }, { -537, 2922, -507 }, 2947, -1493 },
+    { { 272, 488, 863 }, { -722, 2992, -536 }, 2928, -1436 },
+    { { 224, 473, 832 }, { -857, 3104, -589 }, 2906, -1377 },
+    { { 222, 458, 868 }, { -1050, 3199, -647 }, 2881, -1315 },
+    { { 224, 467, 842 }, { -1221, 3339, -693 }, 2853, -1251 },
+    { { 202, 450, 876 }, { -1327, 3391, -766 }, 2823, -1184 },
+    { { 221, 451, 850 }, { -1506, 3467, -740 }, 2789, -1116 },
+    { { 173, 437, 882 }, { -1666, 3536, -749 }, 2753, -1045 },
+    { { 161, 433, 852 }, { -1809, 3658, -787 }, 2714, -973 },
+    { { 149, 463, 898 }, { -1924, 3773, -795 }, 2673, -899 },
+    { { 121, 446, 908 }, { -2098, 3810, -804 }, 2629, -823 },
+    { { 110, 440, 876 }, { -2178, 3950, -778 }, 2582, -746 },
+    { { 116, 412, 911 }, { -2356, 3919, -800 }, 2533, -668 },
+    { { 110, 410, 910 }, { -2489, 4064, -760 }, 2481, -588 },
+    { { 104, 426, 928 }, { -2642, 4081, -661 }, 2427, -508 },
+    { { 71, 392, 915 }, { -2799, 4093, -725 }, 2370, -426 },
+    { { 56, 407, 902 }, { -2899, 4165, -691 }, 2312, -344 },
+    { { 57, 416, 907 }, { -3047, 4174, -663 }, 2250, -261 },
+    { { 23, 379, 954 }, { -3071, 4212, -668 }, 2187, -178 },
+    { { 40, 362, 926 }, { -3233, 4229, -569 }, 2121, -94 },
+    { { -11, 365, 949 }, { -3409, 4227, -476 }, 2054, -11 },
+    { { -24, 333, 929 }, { -3505, 4273, -458 }, 1984, 73 },
+    { { -12, 336, 914 }, { -3609, 4242, -453 }, 1912, 157 },
+    { { -30, 314, 941 }, { -3700, 4260, -322 }, 1839, 240 },
+    { { -64, 302, 988 }, { -3858, 4214, -280 }, 1763, 323 },
+    { { -48, 299, 958 }, { -3927, 4222, -213 }, 1686, 405 },
+    { { -86, 278, 968 }, { -4013, 4157, -124 }, 1607, 487 },
+    { { -110, 259, 961 }, { -4085, 4123, -92 }, 1527, 568 },
+    { { -128, 242, 955 }, { -4166, 4075, -5 }, 1445, 648 },
+    { { -143, 214, 966 }, { -4257, 4008, 57 }, 1362, 726 },
+    { { -131, 189, 983 }, { -4309, 3935, 145 }, 1277, 804 },
+    { { -156, 217, 953 }, { -4445, 3867, 168 }, 1191, 880 },
+    { { -158, 196, 968 }, { -4512, 3824, 267 }, 1104, 954 },
+    { { -176, 186, 968 }, { -4531, 3682, 362 }, 1016, 1027 },
+    { { -191, 168, 959 }, { -4595, 3615, 394 }, 927, 1098 },
+    { { -225, 123, 957 }, { -4657, 3480, 550 }, 837, 1167 },
+    { { -190, 104, 963 }, { -4737, 3414, 584 }, 746, 1234 },
+    { { -211, 99, 999 }, { -4807, 3247, 596 }, 654, 1299 },
+    { { -249, 99, 954 }, { -4794, 3135, 688 }, 562, 1361 },
+    { { -236, 96, 982 }, { -4884, 3006, 772 }, 469, 1421 },
+    { { -261, 58, 983 }, { -4861, 2851, 843 }, 376, 1479 },
+    { { -251, 74, 957 }, { -4877, 2642, 832 }, 282, 1534 },
+    { { -248, 17, 959 }, { -4937, 2565, 932 }, 188, 1587 },
+    { { -258, 14, 964 }, { -4915, 2429, 931 }, 94, 1636 },
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IMU_FUSION_TRACE_H */
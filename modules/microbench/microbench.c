@@ -0,0 +1,437 @@
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xtimer.h"
+
+#include "microbench.h"
+#ifdef MODULE_TELEMETRY
+#include "telemetry.h"
+#endif
+#ifdef MODULE_COAP_UTILS
+#include "coap_utils.h"
+#endif
+#ifdef MODULE_COAP_IO1_XPLAINED
+#include "coap_io1_xplained.h"
+#endif
+#ifdef MODULE_SENSOR_FILTER
+#include "sensor_filter.h"
+#endif
+#ifdef MODULE_COAP_IMU
+#include "imu_fusion.h"
+#include "imu_fusion_trace.h"
+#endif
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+/* Cycle counter of the CPU when there is one: the TSC on native, the DWT
+ * counter on Cortex-M3 and above */
+#if defined(BOARD_NATIVE) && (defined(__i386__) || defined(__x86_64__))
+#include <x86intrin.h>
+#define MICROBENCH_CYCLES
+static void _cycles_init(void) {}
+static uint32_t _cycles(void)
+{
+    return (uint32_t)__rdtsc();
+}
+#elif defined(CPU_ARCH_CORTEX_M3) || defined(CPU_ARCH_CORTEX_M4) || \
+      defined(CPU_ARCH_CORTEX_M4F) || defined(CPU_ARCH_CORTEX_M7)
+#include "cpu.h"
+#define MICROBENCH_CYCLES
+static void _cycles_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+static uint32_t _cycles(void)
+{
+    return DWT->CYCCNT;
+}
+#endif
+
+typedef struct {
+    const char *name;
+    bool (*check)(void);        /* runs the operation once, checks its result */
+    void (*run)(void);          /* the timed operation */
+} microbench_case_t;
+
+/* results are stored so that the operations are not optimized out */
+static volatile int32_t _sink;
+static char _text[64];
+
+/* the timestamp taken by every instrumentation point */
+static void _now_run(void)
+{
+    _sink = xtimer_now_usec();
+}
+
+static bool _now_check(void)
+{
+    return true;
+}
+
+#ifdef MODULE_TELEMETRY
+static const telemetry_sample_t _sample = {
+    .name = "temperature",
+    .idx = TELEMETRY_NO_INDEX,
+    .value = -2345,
+    .scale = -2,
+    .digits = 1,
+    .unit = "°C",
+};
+
+static void _format_run(void)
+{
+    _sink = telemetry_format(_text, &_sample);
+}
+
+static bool _format_check(void)
+{
+    _format_run();
+    return strcmp(_text, "-23.4°C") == 0;
+}
+#endif
+
+#ifdef MODULE_COAP_UTILS
+static coap_batch_t _batch;
+
+/* a report of three instances, small enough not to be sent */
+static void _batch_run(void)
+{
+    coap_batch_init(&_batch, 3);
+    for (unsigned i = 0; i < 3; i++) {
+        char *value = coap_batch_key(&_batch, "temperature", i);
+        memcpy(value, "23.4°C", sizeof("23.4°C") - 1);
+        coap_batch_add(&_batch, sizeof("23.4°C") - 1);
+    }
+    _sink = _batch.len;
+}
+
+static bool _batch_check(void)
+{
+    static const char expected[] = "temperature/0:23.4°C\n"
+                                   "temperature/1:23.4°C\n"
+                                   "temperature/2:23.4°C\n";
+    _batch_run();
+    return (_batch.len == sizeof(expected) - 1) &&
+           (memcmp(_batch.buf, expected, _batch.len) == 0);
+}
+#endif
+
+#ifdef MODULE_GCOAP
+static const gcoap_listener_t *_listener = NULL;
+static const char *_path = MICROBENCH_PATH;
+static uint8_t _buf[GCOAP_PDU_BUF_SIZE];
+static uint8_t _request[GCOAP_PDU_BUF_SIZE];
+static size_t _request_len;
+static ssize_t _result;
+static coap_pkt_t _pdu;
+
+/* the encoding of send_coap_post_raw(), without the socket */
+static void _post_run(void)
+{
+    gcoap_req_init(&_pdu, _buf, sizeof(_buf), COAP_METHOD_POST, "/server");
+    memcpy(_pdu.payload, "temperature:23.4°C", sizeof("temperature:23.4°C") - 1);
+    _result = gcoap_finish(&_pdu, sizeof("temperature:23.4°C") - 1,
+                           COAP_FORMAT_TEXT);
+    _sink = _result;
+}
+
+static bool _post_check(void)
+{
+    _post_run();
+    return (_result > 0) &&
+           (coap_parse(&_pdu, _buf, _result) == 0) &&
+           (strcmp((char *)_pdu.url, "/server") == 0);
+}
+
+/* a request is parsed and matched against the resources as gcoap does,
+ * then handled */
+static void _dispatch_run(void)
+{
+    memcpy(_buf, _request, _request_len);
+    _result = -1;
+    if (coap_parse(&_pdu, _buf, _request_len) < 0) {
+        return;
+    }
+    unsigned method = coap_method2flag(coap_get_code_detail(&_pdu));
+    for (size_t i = 0; i < _listener->resources_len; i++) {
+        const coap_resource_t *resource = &_listener->resources[i];
+        if ((strcmp((char *)_pdu.url, resource->path) == 0) &&
+            (resource->methods & method)) {
+            _result = resource->handler(&_pdu, _buf, sizeof(_buf),
+                                        resource->context);
+            break;
+        }
+    }
+    _sink = _result;
+}
+
+static bool _dispatch_check(void)
+{
+    if (_listener == NULL) {
+        puts("dispatch: no resources, see microbench_init()");
+        return false;
+    }
+    gcoap_req_init(&_pdu, _request, sizeof(_request), COAP_METHOD_GET, _path);
+    _request_len = gcoap_finish(&_pdu, 0, COAP_FORMAT_NONE);
+    _dispatch_run();
+    return (_result > 0) && (coap_get_code_class(&_pdu) == 2);
+}
+
+void microbench_init(const gcoap_listener_t *listener)
+{
+    _listener = listener;
+}
+#endif
+
+#ifdef MODULE_COAP_IO1_XPLAINED
+/* register values: 25 °C, 25.5 °C with the fraction bits set, -12.5 °C */
+static const uint8_t _io1_raw[][2] = { { 0x19, 0x00 }, { 0x19, 0x80 },
+                                       { 0x8c, 0x80 } };
+static const int16_t _io1_expected[] = { 25, 25, -12 };
+static unsigned _io1_next = 0;
+
+static void _io1_run(void)
+{
+    _sink = io1_xplained_temperature_convert(_io1_raw[_io1_next]);
+    _io1_next = (_io1_next + 1) % 3;
+}
+
+static bool _io1_check(void)
+{
+    for (unsigned i = 0; i < 3; i++) {
+        if (io1_xplained_temperature_convert(_io1_raw[i]) != _io1_expected[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
+#ifdef MODULE_SENSOR_FILTER
+static sensor_filter_t _filter;
+/* a pressure in Pa that drifts by a few Pa, with a spike */
+static const int32_t _filter_in[] = { 101325, 101327, 101324, 101326,
+                                      101900, 101325, 101323, 101325 };
+#define FILTER_NUMOF    (sizeof(_filter_in) / sizeof(_filter_in[0]))
+static unsigned _filter_next = 0;
+
+static void _filter_run(void)
+{
+    _sink = sensor_filter_update(&_filter, _filter_in[_filter_next]);
+    _filter_next = (_filter_next + 1) % FILTER_NUMOF;
+}
+
+/* feeds the samples to the new filter, checks each output */
+static bool _filter_check(const int32_t *expected)
+{
+    for (unsigned i = 0; i < FILTER_NUMOF; i++) {
+        if (sensor_filter_update(&_filter, _filter_in[i]) != expected[i]) {
+            return false;
+        }
+    }
+    _filter_next = 0;
+    return true;
+}
+
+static bool _median_check(void)
+{
+    static const int32_t expected[] = { 101325, 101325, 101325, 101325,
+                                        101326, 101326, 101325, 101325 };
+    sensor_filter_init(&_filter);
+    sensor_filter_add_median(&_filter, 5);
+    return _filter_check(expected);
+}
+
+/* the largest shift, the accumulator needs more than 32 bits */
+static bool _ema_check(void)
+{
+    static const int32_t expected[] = { 101325, 101325, 101325, 101325,
+                                        101325, 101325, 101325, 101325 };
+    sensor_filter_init(&_filter);
+    sensor_filter_add_ema(&_filter, 15);
+    return _filter_check(expected);
+}
+
+/* y = x / 4 + x[n-1] / 4 + y[n-1] / 2 */
+static bool _iir_check(void)
+{
+    static const int32_t expected[] = { 101325, 101326, 101326, 101326,
+                                        101470, 101541, 101433, 101379 };
+    sensor_filter_init(&_filter);
+    sensor_filter_add_iir(&_filter, 8192, 8192, -16384);
+    return _filter_check(expected);
+}
+#endif
+
+#ifdef MODULE_COAP_IMU
+#define FUSION_NUMOF        (sizeof(imu_fusion_trace) / sizeof(imu_fusion_trace[0]))
+/* mean error of the roll and pitch above which the case fails, in 1/1000
+ * degree */
+#define FUSION_ERROR_MAX    (3000U)
+static unsigned _fusion_next = 0;
+
+static void _fusion_update(const imu_fusion_trace_t *sample)
+{
+    phydat_t acc = {
+        .val = { sample->acc[0], sample->acc[1], sample->acc[2] },
+        .unit = UNIT_G,
+        .scale = -3,
+    };
+    phydat_t gyro = {
+        .val = { sample->gyro[0], sample->gyro[1], sample->gyro[2] },
+        .unit = UNIT_DPS,
+        .scale = -2,
+    };
+    imu_fusion_update(&acc, &gyro, IMU_FUSION_TRACE_DT);
+}
+
+static void _fusion_run(void)
+{
+    _fusion_update(&imu_fusion_trace[_fusion_next]);
+    _fusion_next = (_fusion_next + 1) % FUSION_NUMOF;
+}
+
+/* replays the trace from the start and prints the error of the roll and
+ * pitch against the true angles, the yaw has no reference */
+static bool _fusion_check(void)
+{
+    uint64_t sum = 0;
+    uint32_t max = 0;
+
+    imu_fusion_init();
+    for (unsigned i = 0; i < FUSION_NUMOF; i++) {
+        const imu_fusion_trace_t *sample = &imu_fusion_trace[i];
+        imu_orientation_t orientation;
+
+        _fusion_update(sample);
+        imu_fusion_get(&orientation);
+        int32_t errors[] = { orientation.roll - sample->roll * 10,
+                             orientation.pitch - sample->pitch * 10 };
+        for (unsigned j = 0; j < 2; j++) {
+            uint32_t error = abs(errors[j]);
+            sum += error;
+            if (error > max) {
+                max = error;
+            }
+        }
+    }
+    _fusion_next = 0;
+
+    uint32_t mean = sum / (2 * FUSION_NUMOF);
+    printf("%-12s error mean %" PRIu32 " max %" PRIu32 " mdeg\n", "fusion",
+           mean, max);
+    return mean < FUSION_ERROR_MAX;
+}
+#endif
+
+static const microbench_case_t _cases[] = {
+    { "xtimer_now", _now_check, _now_run },
+#ifdef MODULE_TELEMETRY
+    { "format", _format_check, _format_run },
+#endif
+#ifdef MODULE_COAP_UTILS
+    { "batch", _batch_check, _batch_run },
+#endif
+#ifdef MODULE_GCOAP
+    { "coap_post", _post_check, _post_run },
+    { "dispatch", _dispatch_check, _dispatch_run },
+#endif
+#ifdef MODULE_COAP_IO1_XPLAINED
+    { "io1_convert", _io1_check, _io1_run },
+#endif
+#ifdef MODULE_SENSOR_FILTER
+    { "median", _median_check, _filter_run },
+    { "ema", _ema_check, _filter_run },
+    { "iir", _iir_check, _filter_run },
+#endif
+#ifdef MODULE_COAP_IMU
+    { "fusion", _fusion_check, _fusion_run },
+#endif
+};
+
+#define MICROBENCH_NUMOF    (sizeof(_cases) / sizeof(_cases[0]))
+
+static void _empty(void) {}
+
+/* time of `loops` operations in us and in cycles */
+static void _time(void (*run)(void), unsigned loops, uint32_t *us,
+                  uint32_t *cycles)
+{
+    *cycles = 0;
+#ifdef MICROBENCH_CYCLES
+    uint32_t c = _cycles();
+#endif
+    uint32_t begin = xtimer_now_usec();
+    for (unsigned i = 0; i < loops; i++) {
+        run();
+    }
+    *us = xtimer_now_usec() - begin;
+#ifdef MICROBENCH_CYCLES
+    *cycles = _cycles() - c;
+#endif
+}
+
+static bool _bench(const microbench_case_t *c, unsigned loops)
+{
+    if (!c->check()) {
+        printf("%-12s FAILED\n", c->name);
+        return false;
+    }
+
+    /* the loop and call overhead is measured apart and left out */
+    uint32_t us, cycles, base_us, base_cycles;
+    _time(_empty, loops, &base_us, &base_cycles);
+    _time(c->run, loops, &us, &cycles);
+    us = (us > base_us) ? us - base_us : 0;
+    cycles = (cycles > base_cycles) ? cycles - base_cycles : 0;
+
+    printf("%-12s %6u %8" PRIu32, c->name, loops,
+           (uint32_t)(((uint64_t)us * 1000) / loops));
+#ifdef MICROBENCH_CYCLES
+    printf(" %9" PRIu32 "\n", cycles / loops);
+#else
+    (void)cycles;
+    printf(" %9s\n", "-");
+#endif
+    return true;
+}
+
+int microbench_cmd(int argc, char **argv)
+{
+    const char *name = (argc > 1) ? argv[1] : "all";
+    unsigned loops = (argc > 2) ? strtoul(argv[2], NULL, 10) : MICROBENCH_LOOPS;
+    bool all = (strcmp(name, "all") == 0);
+    bool found = false;
+    int res = 0;
+
+    if ((argc > 4) || (loops == 0)) {
+        printf("usage: %s [<case>|all [loops [path]]]\n", argv[0]);
+        return 1;
+    }
+#ifdef MODULE_GCOAP
+    _path = (argc > 3) ? argv[3] : MICROBENCH_PATH;
+#endif
+#ifdef MICROBENCH_CYCLES
+    _cycles_init();
+#endif
+
+    printf("%-12s %6s %8s %9s\n", "case", "loops", "ns/op", "cycles/op");
+    for (unsigned i = 0; i < MICROBENCH_NUMOF; i++) {
+        if (all || (strcmp(name, _cases[i].name) == 0)) {
+            found = true;
+            if (!_bench(&_cases[i], loops)) {
+                res = 1;
+            }
+        }
+    }
+    if (!found) {
+        printf("unknown case '%s'\n", name);
+        return 1;
+    }
+    return res;
+}
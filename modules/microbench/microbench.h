@@ -0,0 +1,38 @@
+#ifndef MICROBENCH_H
+#define MICROBENCH_H
+
+#include <inttypes.h>
+
+#ifdef MODULE_GCOAP
+#include "net/gcoap.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Operations timed by each case, the time of one is the average */
+#ifndef MICROBENCH_LOOPS
+#define MICROBENCH_LOOPS        (1000U)
+#endif
+
+/* Resource requested by the dispatch case unless another is given */
+#ifndef MICROBENCH_PATH
+#define MICROBENCH_PATH         "/name"
+#endif
+
+#ifdef MODULE_GCOAP
+/* Resources of the application, for the dispatch case. Their handlers are
+ * called from the shell with fake requests. */
+void microbench_init(const gcoap_listener_t *listener);
+#endif
+
+/* "bench [<case>|all [loops [path]]]" shell command: each case is run once
+ * and its result checked, then timed over `loops` operations */
+int microbench_cmd(int argc, char **argv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MICROBENCH_H */
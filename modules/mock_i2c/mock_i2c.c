@@ -0,0 +1,207 @@
+/* I2C peripheral of native: the devices of the firmwares are answered from
+ * a table, with the register pointer of each device set by the last write
+ * as on the real bus. Values come from mock_sensors. */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
+
+#include "mutex.h"
+#include "periph/i2c.h"
+
+#include "mock_sensors.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+/* temperature sensor of the IO1 Xplained extension (AT30TSE758) */
+#define MOCK_I2C_AT30TSE_ADDR       (0x48 | 0x07)
+#define MOCK_I2C_AT30TSE_REG_TEMP   (0x00)
+/* BMX280 on either address, its reads are served by the driver mock */
+#define MOCK_I2C_BMX280_ADDR_1      (0x76)
+#define MOCK_I2C_BMX280_ADDR_2      (0x77)
+
+typedef struct {
+    uint16_t addr;
+    /* read or write len bytes from the register, 0 or a negative errno */
+    int (*read)(uint8_t reg, uint8_t *data, size_t len);
+    int (*write)(uint8_t reg, const uint8_t *data, size_t len);
+} mock_i2c_dev_t;
+
+/* Temperature register, sign and magnitude in 1/8 °C left aligned on 16
+ * bits */
+static int _at30tse_read(uint8_t reg, uint8_t *data, size_t len)
+{
+    if ((reg != MOCK_I2C_AT30TSE_REG_TEMP) || (len > 2)) {
+        return -EIO;
+    }
+
+    int32_t milli;
+    if (mock_sensors_read(MOCK_TEMPERATURE, 0, &milli) < 0) {
+        return -EIO;
+    }
+    uint16_t raw = ((abs(milli) / 125) & 0x3ff) << 5;
+    if (milli < 0) {
+        raw |= 1 << 15;
+    }
+    data[0] = raw >> 8;
+    if (len > 1) {
+        data[1] = raw & 0xff;
+    }
+    return 0;
+}
+
+/* Register writes (e.g. the start of a forced measurement) are accepted, the
+ * conversion is waited by the caller and read through mock_bmx280 */
+static int _bmx280_write(uint8_t reg, const uint8_t *data, size_t len)
+{
+    (void)reg;
+    (void)data;
+    (void)len;
+    return 0;
+}
+
+static const mock_i2c_dev_t _devs[] = {
+    { MOCK_I2C_AT30TSE_ADDR, _at30tse_read, NULL },
+    { MOCK_I2C_BMX280_ADDR_1, NULL, _bmx280_write },
+    { MOCK_I2C_BMX280_ADDR_2, NULL, _bmx280_write },
+};
+
+#define MOCK_I2C_NUMOF   (sizeof(_devs) / sizeof(_devs[0]))
+
+static uint8_t _pointers[MOCK_I2C_NUMOF];
+static mutex_t _lock = MUTEX_INIT;
+
+static int _find(uint16_t addr, uint8_t flags)
+{
+    if (flags & I2C_ADDR10) {
+        return -ENXIO;
+    }
+    for (unsigned i = 0; i < MOCK_I2C_NUMOF; i++) {
+        if (_devs[i].addr == addr) {
+            return i;
+        }
+    }
+    DEBUG("[mock_i2c] no device at 0x%02x\n", addr);
+    return -ENXIO;
+}
+
+static int _read(uint16_t addr, void *data, size_t len, uint8_t flags)
+{
+    int i = _find(addr, flags);
+    if (i < 0) {
+        return i;
+    }
+    if (_devs[i].read == NULL) {
+        return -EIO;
+    }
+    return _devs[i].read(_pointers[i], data, len);
+}
+
+static int _write(uint16_t addr, const void *data, size_t len, uint8_t flags)
+{
+    int i = _find(addr, flags);
+    if (i < 0) {
+        return i;
+    }
+    if (len == 0) {
+        return 0;
+    }
+    /* the first byte sets the register pointer */
+    const uint8_t *buf = data;
+    _pointers[i] = buf[0];
+    if ((len == 1) || (_devs[i].write == NULL)) {
+        return 0;
+    }
+    return _devs[i].write(_pointers[i], buf + 1, len - 1);
+}
+
+static int _set_reg(uint16_t addr, uint16_t reg, uint8_t flags)
+{
+    if (flags & I2C_REG16) {
+        return -EINVAL;
+    }
+    uint8_t pointer = reg;
+    return _write(addr, &pointer, 1, flags);
+}
+
+void i2c_init(i2c_t dev)
+{
+    (void)dev;
+}
+
+int i2c_acquire(i2c_t dev)
+{
+    (void)dev;
+    mutex_lock(&_lock);
+    return 0;
+}
+
+int i2c_release(i2c_t dev)
+{
+    (void)dev;
+    mutex_unlock(&_lock);
+    return 0;
+}
+
+int i2c_read_bytes(i2c_t dev, uint16_t addr, void *data, size_t len,
+                   uint8_t flags)
+{
+    (void)dev;
+    return _read(addr, data, len, flags);
+}
+
+int i2c_read_byte(i2c_t dev, uint16_t addr, void *data, uint8_t flags)
+{
+    return i2c_read_bytes(dev, addr, data, 1, flags);
+}
+
+int i2c_read_regs(i2c_t dev, uint16_t addr, uint16_t reg, void *data,
+                  size_t len, uint8_t flags)
+{
+    (void)dev;
+    int res = _set_reg(addr, reg, flags);
+    if (res < 0) {
+        return res;
+    }
+    return _read(addr, data, len, flags);
+}
+
+int i2c_read_reg(i2c_t dev, uint16_t addr, uint16_t reg, void *data,
+                 uint8_t flags)
+{
+    return i2c_read_regs(dev, addr, reg, data, 1, flags);
+}
+
+int i2c_write_bytes(i2c_t dev, uint16_t addr, const void *data, size_t len,
+                    uint8_t flags)
+{
+    (void)dev;
+    return _write(addr, data, len, flags);
+}
+
+int i2c_write_byte(i2c_t dev, uint16_t addr, uint8_t data, uint8_t flags)
+{
+    return i2c_write_bytes(dev, addr, &data, 1, flags);
+}
+
+int i2c_write_regs(i2c_t dev, uint16_t addr, uint16_t reg, const void *data,
+                   size_t len, uint8_t flags)
+{
+    (void)dev;
+    int i = _find(addr, flags);
+    if (i < 0) {
+        return i;
+    }
+    int res = _set_reg(addr, reg, flags);
+    if ((res < 0) || (len == 0) || (_devs[i].write == NULL)) {
+        return res;
+    }
+    return _devs[i].write(_pointers[i], data, len);
+}
+
+int i2c_write_reg(i2c_t dev, uint16_t addr, uint16_t reg, uint8_t data,
+                  uint8_t flags)
+{
+    return i2c_write_regs(dev, addr, reg, &data, 1, flags);
+}
@@ -0,0 +1,79 @@
+#ifdef MODULE_MOCK_BMP180
+
+#include <inttypes.h>
+
+#include "bmp180.h"
+#include "saul.h"
+
+#include "mock_sensors.h"
+
+#define BMP180_TEMPERATURE_US       (4500U)
+
+/* pressure conversion time of each oversampling setting */
+static const uint32_t _pressure_us[] = { 4500, 7500, 13500, 25500 };
+
+int bmp180_init(bmp180_t *dev, const bmp180_params_t *params)
+{
+    dev->params = *params;
+    return 0;
+}
+
+int16_t bmp180_read_temperature(const bmp180_t *dev)
+{
+    (void)dev;
+    int32_t value;
+    if (mock_sensors_read(MOCK_TEMPERATURE, BMP180_TEMPERATURE_US,
+                          &value) < 0) {
+        return 0;
+    }
+    return value / 100;
+}
+
+/* the pressure is compensated with a new temperature conversion */
+uint32_t bmp180_read_pressure(const bmp180_t *dev)
+{
+    unsigned oss = dev->params.oversampling;
+    if (oss >= sizeof(_pressure_us) / sizeof(_pressure_us[0])) {
+        oss = 0;
+    }
+    int32_t value;
+    if (mock_sensors_read(MOCK_PRESSURE,
+                          BMP180_TEMPERATURE_US + _pressure_us[oss],
+                          &value) < 0) {
+        return 0;
+    }
+    return value / 10;
+}
+
+/* SAUL adaption of the driver, registered by auto_init_saul */
+static int _read_temperature(const void *dev, phydat_t *res)
+{
+    res->val[0] = bmp180_read_temperature(dev);
+    res->unit = UNIT_TEMP_C;
+    res->scale = -1;
+    return 1;
+}
+
+static int _read_pressure(const void *dev, phydat_t *res)
+{
+    res->val[0] = bmp180_read_pressure(dev) / 10;
+    res->unit = UNIT_PA;
+    res->scale = 1;
+    return 1;
+}
+
+const saul_driver_t bmp180_temperature_saul_driver = {
+    .read = _read_temperature,
+    .write = saul_notsup,
+    .type = SAUL_SENSE_TEMP,
+};
+
+const saul_driver_t bmp180_pressure_saul_driver = {
+    .read = _read_pressure,
+    .write = saul_notsup,
+    .type = SAUL_SENSE_PRESS,
+};
+
+#else
+typedef int dont_be_pedantic;
+#endif /* MODULE_MOCK_BMP180 */
@@ -0,0 +1,74 @@
+#ifdef MODULE_MOCK_BMX280
+
+#include <inttypes.h>
+
+#include "bmx280.h"
+
+#include "mock_sensors.h"
+
+/* oversampling factor of a setting, 0 when skipped */
+static uint32_t _osrs(bmx280_osrs_t osrs)
+{
+    return (osrs == BMX280_OSRS_SKIPPED) ? 0 : 1U << (osrs - 1);
+}
+
+/* typical measurement time of the datasheet, in forced mode the read waits
+ * for it while in normal mode the last result is read at once. In sleep
+ * mode the caller started the measurement and waited for it already */
+static uint32_t _measurement_us(const bmx280_t *dev)
+{
+    const bmx280_params_t *p = &dev->params;
+    if ((p->run_mode == BMX280_MODE_NORMAL) ||
+        (p->run_mode == BMX280_MODE_SLEEP)) {
+        return 0;
+    }
+    uint32_t us = 1000 + 2000 * _osrs(p->temp_oversample);
+    if (p->press_oversample != BMX280_OSRS_SKIPPED) {
+        us += 2000 * _osrs(p->press_oversample) + 500;
+    }
+#ifdef MODULE_BME280
+    if (p->humid_oversample != BMX280_OSRS_SKIPPED) {
+        us += 2000 * _osrs(p->humid_oversample) + 500;
+    }
+#endif
+    return us;
+}
+
+int bmx280_init(bmx280_t *dev, const bmx280_params_t *params)
+{
+    dev->params = *params;
+    return BMX280_OK;
+}
+
+/* the measurement is started and read by the temperature, pressure and
+ * humidity are compensated from the same registers */
+int16_t bmx280_read_temperature(const bmx280_t *dev)
+{
+    int32_t value;
+    if (mock_sensors_read(MOCK_TEMPERATURE, _measurement_us(dev), &value) < 0) {
+        return INT16_MIN;
+    }
+    return value / 10;
+}
+
+uint32_t bmx280_read_pressure(const bmx280_t *dev)
+{
+    (void)dev;
+    int32_t value;
+    mock_sensors_get(MOCK_PRESSURE, &value);
+    return value / 10;
+}
+
+#ifdef MODULE_BME280
+uint16_t bme280_read_humidity(const bmx280_t *dev)
+{
+    (void)dev;
+    int32_t value;
+    mock_sensors_get(MOCK_HUMIDITY, &value);
+    return value / 10;
+}
+#endif
+
+#else
+typedef int dont_be_pedantic;
+#endif /* MODULE_MOCK_BMX280 */
@@ -0,0 +1,104 @@
+#ifdef MODULE_MOCK_CCS811
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+#include "ccs811.h"
+#include "xtimer.h"
+
+#include "mock_sensors.h"
+
+/* current through the sensor and voltage across it, as raw data */
+#define CCS811_RAW_CURRENT          (10U)       /* uA */
+#define CCS811_RAW_VOLTAGE          (512U)      /* 1.65 V */
+
+/* the algorithm results change once per drive mode period */
+static struct {
+    bool valid;
+    uint32_t time;
+    uint16_t eco2;
+    uint16_t tvoc;
+} _result;
+
+static uint32_t _period_ms(ccs811_mode_t mode)
+{
+    switch (mode) {
+    case CCS811_MODE_250MS:
+        return 250;
+    case CCS811_MODE_10S:
+        return 10 * MS_PER_SEC;
+    case CCS811_MODE_60S:
+        return 60 * MS_PER_SEC;
+    default:
+        return MS_PER_SEC;
+    }
+}
+
+int ccs811_init(ccs811_t *dev, const ccs811_params_t *params)
+{
+    dev->params = *params;
+    _result.valid = false;
+    return CCS811_OK;
+}
+
+int ccs811_set_mode(ccs811_t *dev, ccs811_mode_t mode)
+{
+    dev->params.mode = mode;
+    return CCS811_OK;
+}
+
+int ccs811_read_iaq(const ccs811_t *dev, uint16_t *iaq_tvoc,
+                    uint16_t *iaq_eco2, uint16_t *raw_i, uint16_t *raw_v)
+{
+    int32_t eco2;
+    int32_t tvoc;
+    if (mock_sensors_read(MOCK_ECO2, 0, &eco2) < 0) {
+        return CCS811_ERROR_I2C;
+    }
+    mock_sensors_get(MOCK_TVOC, &tvoc);
+
+    uint32_t now = xtimer_now_usec() / US_PER_MS;
+    if (!_result.valid ||
+        (now - _result.time >= _period_ms(dev->params.mode))) {
+        _result.valid = true;
+        _result.time = now;
+        _result.eco2 = (eco2 < 400000) ? 400 : eco2 / 1000;
+        _result.tvoc = (tvoc < 0) ? 0 : tvoc / 1000;
+    }
+
+    if (iaq_eco2) {
+        *iaq_eco2 = _result.eco2;
+    }
+    if (iaq_tvoc) {
+        *iaq_tvoc = _result.tvoc;
+    }
+    if (raw_i) {
+        *raw_i = CCS811_RAW_CURRENT;
+    }
+    if (raw_v) {
+        *raw_v = CCS811_RAW_VOLTAGE;
+    }
+    return CCS811_OK;
+}
+
+#ifdef MODULE_CCS811_FULL
+int ccs811_set_int_mode(ccs811_t *dev, ccs811_int_mode_t mode)
+{
+    dev->params.int_mode = mode;
+    return CCS811_OK;
+}
+
+int ccs811_set_eco2_thresholds(const ccs811_t *dev,
+                               uint16_t low, uint16_t high, uint8_t hyst)
+{
+    (void)dev;
+    (void)low;
+    (void)high;
+    (void)hyst;
+    return CCS811_OK;
+}
+#endif
+
+#else
+typedef int dont_be_pedantic;
+#endif /* MODULE_MOCK_CCS811 */
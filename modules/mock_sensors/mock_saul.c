@@ -0,0 +1,98 @@
+#ifdef MODULE_MOCK_SAUL
+
+#include <errno.h>
+#include <inttypes.h>
+
+#include "saul.h"
+#include "saul_reg.h"
+
+#include "mock_sensors.h"
+
+/* a device reads its channels in one transfer, values are divided by
+ * `div` to fit phydat_t at the given scale */
+typedef struct {
+    mock_channel_t first;
+    uint8_t dim;
+    uint8_t unit;
+    int8_t scale;
+    int16_t div;
+} mock_saul_dev_t;
+
+static const mock_saul_dev_t _accel = {
+    MOCK_ACCEL_X, 3, UNIT_G, -3, 1
+};
+static const mock_saul_dev_t _gyro = {
+    MOCK_GYRO_X, 3, UNIT_DPS, -2, 10
+};
+static const mock_saul_dev_t _temperature = {
+    MOCK_TEMPERATURE, 1, UNIT_TEMP_C, -2, 10
+};
+static const mock_saul_dev_t _humidity = {
+    MOCK_HUMIDITY, 1, UNIT_PERCENT, -2, 10
+};
+static const mock_saul_dev_t _pressure = {
+    MOCK_PRESSURE, 1, UNIT_PA, 2, 1000
+};
+static const mock_saul_dev_t _light = {
+    MOCK_ILLUMINANCE, 1, UNIT_LUX, 0, 1000
+};
+
+static int _read(const void *dev, phydat_t *res)
+{
+    const mock_saul_dev_t *mock = dev;
+    int32_t value;
+    if (mock_sensors_read(mock->first, 0, &value) < 0) {
+        return -ECANCELED;
+    }
+    res->val[0] = value / mock->div;
+    for (unsigned i = 1; i < mock->dim; i++) {
+        mock_sensors_get(mock->first + i, &value);
+        res->val[i] = value / mock->div;
+    }
+    res->unit = mock->unit;
+    res->scale = mock->scale;
+    return mock->dim;
+}
+
+static const saul_driver_t _accel_driver = {
+    .read = _read, .write = saul_notsup, .type = SAUL_SENSE_ACCEL,
+};
+static const saul_driver_t _gyro_driver = {
+    .read = _read, .write = saul_notsup, .type = SAUL_SENSE_GYRO,
+};
+static const saul_driver_t _temperature_driver = {
+    .read = _read, .write = saul_notsup, .type = SAUL_SENSE_TEMP,
+};
+static const saul_driver_t _humidity_driver = {
+    .read = _read, .write = saul_notsup, .type = SAUL_SENSE_HUM,
+};
+static const saul_driver_t _pressure_driver = {
+    .read = _read, .write = saul_notsup, .type = SAUL_SENSE_PRESS,
+};
+static const saul_driver_t _light_driver = {
+    .read = _read, .write = saul_notsup, .type = SAUL_SENSE_LIGHT,
+};
+
+static saul_reg_t _entries[] = {
+    { .name = "mock accel", .dev = (void *)&_accel, .driver = &_accel_driver },
+    { .name = "mock gyro", .dev = (void *)&_gyro, .driver = &_gyro_driver },
+    { .name = "mock temperature", .dev = (void *)&_temperature,
+      .driver = &_temperature_driver },
+    { .name = "mock humidity", .dev = (void *)&_humidity,
+      .driver = &_humidity_driver },
+    { .name = "mock pressure", .dev = (void *)&_pressure,
+      .driver = &_pressure_driver },
+    { .name = "mock light", .dev = (void *)&_light,
+      .driver = &_light_driver },
+};
+
+void mock_saul_init(void)
+{
+    for (unsigned i = 0; i < sizeof(_entries) / sizeof(_entries[0]); i++) {
+        saul_reg_add(&_entries[i]);
+    }
+}
+
+#else
+typedef int dont_be_pedantic;
+#endif /* MODULE_MOCK_SAUL */
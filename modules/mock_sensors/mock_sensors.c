@@ -0,0 +1,393 @@
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mutex.h"
+#include "xtimer.h"
+
+#if defined(BOARD_NATIVE)
+#include "native_internal.h"
+#endif
+
+#include "mock_sensors.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+#define MOCK_LINE_MAX       (64U)
+
+typedef struct {
+    const char *name;
+    int32_t base;
+    int32_t amplitude;
+    uint32_t period;            /* s */
+    int32_t noise;
+} mock_generator_t;
+
+typedef struct {
+    uint32_t rng;
+    uint16_t fail;              /* 1/1000 */
+    bool pinned;
+    bool traced;
+    int32_t pin;
+    uint32_t reads;
+    uint32_t failures;
+    int32_t last;
+} mock_state_t;
+
+typedef struct {
+    uint32_t time;              /* ms */
+    uint8_t channel;
+    int32_t value;
+} mock_trace_line_t;
+
+#define MOCK_GENERATOR(id, name, base, amplitude, period, noise) \
+    { name, base, amplitude, period, noise },
+static const mock_generator_t _generators[] = {
+    MOCK_CHANNELS(MOCK_GENERATOR)
+};
+#undef MOCK_GENERATOR
+
+static mock_state_t _state[MOCK_CHANNEL_NUMOF];
+static mock_trace_line_t _trace[MOCK_SENSORS_TRACE_LEN];
+static unsigned _trace_len = 0;
+static uint32_t _trace_end = 0;
+static uint32_t _trace_step = 0;    /* the last line lasts as the one before */
+static uint64_t _start = 0;
+
+static mutex_t _lock = MUTEX_INIT;
+/* transfers of different devices share the bus */
+static mutex_t _bus = MUTEX_INIT;
+
+/* xorshift32, one sequence per channel */
+static uint32_t _random(mock_state_t *state)
+{
+    uint32_t x = state->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    state->rng = x;
+    return x;
+}
+
+/* sin() * 1000 of an angle in degrees, Bhaskara's approximation */
+static int32_t _sin(uint32_t deg)
+{
+    int32_t sign = 1;
+    deg %= 360;
+    if (deg >= 180) {
+        deg -= 180;
+        sign = -1;
+    }
+    int32_t p = deg * (180 - deg);
+    return sign * (4000 * p) / (40500 - p);
+}
+
+static int32_t _generate(mock_channel_t channel, uint32_t now)
+{
+    const mock_generator_t *gen = &_generators[channel];
+    int32_t value = gen->base;
+    if (gen->amplitude && gen->period) {
+        uint32_t period = gen->period * MS_PER_SEC;
+        uint32_t deg = (uint64_t)(now % period) * 360 / period;
+        value += (int64_t)gen->amplitude * _sin(deg) / 1000;
+    }
+    if (gen->noise) {
+        value += (int32_t)(_random(&_state[channel]) % (2 * gen->noise + 1)) -
+                 gen->noise;
+    }
+    return value;
+}
+
+/* the value of the last line of the channel at `now`, the trace loops */
+static int32_t _replay(mock_channel_t channel, uint32_t now)
+{
+    now %= _trace_end + _trace_step;
+    int32_t value = 0;
+    bool found = false;
+    for (unsigned i = 0; i < _trace_len; i++) {
+        if (_trace[i].channel != channel) {
+            continue;
+        }
+        if (found && (_trace[i].time > now)) {
+            break;
+        }
+        value = _trace[i].value;
+        found = true;
+    }
+    return value;
+}
+
+static int _channel(const char *name)
+{
+    for (unsigned i = 0; i < MOCK_CHANNEL_NUMOF; i++) {
+        if (strcmp(_generators[i].name, name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* "-12.345" to -12345, at most 3 decimals are kept */
+static int _parse_milli(const char *str, int32_t *value)
+{
+    int32_t sign = 1;
+    int32_t v = 0;
+    unsigned decimals = 0;
+    bool dot = false;
+    bool digits = false;
+
+    if (*str == '-') {
+        sign = -1;
+        str++;
+    }
+    for (; *str && (*str != '\r') && (*str != '\n'); str++) {
+        if ((*str == '.') && !dot) {
+            dot = true;
+        }
+        else if ((*str >= '0') && (*str <= '9')) {
+            if (decimals < 3) {
+                v = v * 10 + (*str - '0');
+                decimals += dot;
+            }
+            digits = true;
+        }
+        else {
+            return -EINVAL;
+        }
+    }
+    if (!digits) {
+        return -EINVAL;
+    }
+    for (; decimals < 3; decimals++) {
+        v *= 10;
+    }
+    *value = sign * v;
+    return 0;
+}
+
+#if defined(BOARD_NATIVE)
+static void _parse_line(char *line)
+{
+    char *name = strchr(line, ',');
+    char *value = name ? strchr(name + 1, ',') : NULL;
+    char *end;
+    if ((value == NULL) || (_trace_len == MOCK_SENSORS_TRACE_LEN)) {
+        return;
+    }
+    *name++ = '\0';
+    *value++ = '\0';
+
+    /* the header and unknown channels are skipped */
+    unsigned long time = strtoul(line, &end, 10);
+    int channel = _channel(name);
+    mock_trace_line_t *entry = &_trace[_trace_len];
+    if ((end == line) || (*end != '\0') || (channel < 0) ||
+        (_parse_milli(value, &entry->value) < 0)) {
+        return;
+    }
+    entry->time = time;
+    entry->channel = channel;
+    if (entry->time > _trace_end) {
+        _trace_step = entry->time - _trace_end;
+        _trace_end = entry->time;
+    }
+    _state[channel].traced = true;
+    _trace_len++;
+}
+
+static void _load_trace(void)
+{
+    char chunk[MOCK_LINE_MAX];
+    char line[MOCK_LINE_MAX];
+    size_t len = 0;
+    size_t n;
+
+    _native_syscall_enter();
+    FILE *f = real_fopen(MOCK_SENSORS_TRACE, "r");
+    if (f != NULL) {
+        while ((n = real_fread(chunk, 1, sizeof(chunk), f)) > 0) {
+            for (size_t i = 0; i < n; i++) {
+                if (chunk[i] == '\n') {
+                    line[len] = '\0';
+                    _parse_line(line);
+                    len = 0;
+                }
+                else if (len < sizeof(line) - 1) {
+                    line[len++] = chunk[i];
+                }
+            }
+        }
+        if (len) {
+            line[len] = '\0';
+            _parse_line(line);
+        }
+        real_fclose(f);
+    }
+    _native_syscall_leave();
+
+    if (_trace_step == 0) {
+        _trace_step = 1;
+    }
+    if (_trace_len) {
+        printf("mock_sensors: %u trace lines over %" PRIu32 " ms from %s\n",
+               _trace_len, _trace_end, MOCK_SENSORS_TRACE);
+    }
+}
+#endif
+
+static void _wait(uint32_t us)
+{
+#if MOCK_SENSORS_LATENCY
+    if (us) {
+        xtimer_usleep(us);
+    }
+#else
+    (void)us;
+#endif
+}
+
+/* called with _lock held */
+static int32_t _value(mock_channel_t channel)
+{
+    uint32_t now = (xtimer_now_usec64() - _start) / US_PER_MS;
+    mock_state_t *state = &_state[channel];
+    int32_t value;
+
+    if (state->pinned) {
+        value = state->pin;
+    }
+    else if (state->traced) {
+        value = _replay(channel, now);
+    }
+    else {
+        value = _generate(channel, now);
+    }
+    state->reads++;
+    state->last = value;
+    return value;
+}
+
+void mock_sensors_get(mock_channel_t channel, int32_t *value)
+{
+    mutex_lock(&_lock);
+    *value = _value(channel);
+    mutex_unlock(&_lock);
+}
+
+int mock_sensors_read(mock_channel_t channel, uint32_t conversion_us,
+                      int32_t *value)
+{
+    _wait(conversion_us);
+    mutex_lock(&_bus);
+    _wait(MOCK_SENSORS_I2C_US);
+    mutex_unlock(&_bus);
+
+    mock_state_t *state = &_state[channel];
+    int res = 0;
+
+    mutex_lock(&_lock);
+    if (state->fail && ((_random(state) % 1000) < state->fail)) {
+        state->failures++;
+        res = -EIO;
+    }
+    else {
+        *value = _value(channel);
+    }
+    mutex_unlock(&_lock);
+
+    DEBUG("[DEBUG] mock_sensors: %s %s\n", _generators[channel].name,
+          res ? "failed" : "read");
+    return res;
+}
+
+void mock_sensors_init(void)
+{
+    for (unsigned i = 0; i < MOCK_CHANNEL_NUMOF; i++) {
+        /* xorshift never leaves 0 */
+        _state[i].rng = (MOCK_SENSORS_SEED + 1) * 2654435761U + i;
+        if (_state[i].rng == 0) {
+            _state[i].rng = 1;
+        }
+        _state[i].fail = MOCK_SENSORS_FAIL;
+    }
+    _start = xtimer_now_usec64();
+#if defined(BOARD_NATIVE)
+    _load_trace();
+#endif
+#ifdef MODULE_MOCK_SAUL
+    mock_saul_init();
+#endif
+}
+
+static void _format_milli(char *buf, size_t len, int32_t value)
+{
+    snprintf(buf, len, "%s%" PRIi32 ".%03" PRIi32, (value < 0) ? "-" : "",
+             abs(value) / 1000, abs(value) % 1000);
+}
+
+static void _list(void)
+{
+    char last[16];
+    printf("%-12s %-6s %12s %5s %8s %8s\n", "channel", "source", "last",
+           "fail", "reads", "failed");
+    for (unsigned i = 0; i < MOCK_CHANNEL_NUMOF; i++) {
+        mock_state_t *state = &_state[i];
+        _format_milli(last, sizeof(last), state->last);
+        printf("%-12s %-6s %12s %4u‰ %8" PRIu32 " %8" PRIu32 "\n",
+               _generators[i].name,
+               state->pinned ? "pinned" : state->traced ? "trace" : "gen",
+               last, state->fail, state->reads, state->failures);
+    }
+}
+
+int mock_sensors_cmd(int argc, char **argv)
+{
+    if (argc == 1) {
+        _list();
+        return 0;
+    }
+
+    int channel = (argc > 2) ? _channel(argv[2]) : -1;
+    bool all = (argc > 2) && (strcmp(argv[2], "all") == 0);
+    int32_t value = 0;
+
+    if ((argc == 4) && (strcmp(argv[1], "set") == 0) && (channel >= 0) &&
+        (_parse_milli(argv[3], &value) == 0)) {
+        mutex_lock(&_lock);
+        _state[channel].pinned = true;
+        _state[channel].pin = value;
+        mutex_unlock(&_lock);
+        return 0;
+    }
+    if ((argc == 4) && (strcmp(argv[1], "fail") == 0) &&
+        ((channel >= 0) || all)) {
+        unsigned long fail = strtoul(argv[3], NULL, 10);
+        mutex_lock(&_lock);
+        for (unsigned i = 0; i < MOCK_CHANNEL_NUMOF; i++) {
+            if (all || ((int)i == channel)) {
+                _state[i].fail = (fail > 1000) ? 1000 : fail;
+            }
+        }
+        mutex_unlock(&_lock);
+        return 0;
+    }
+    if ((argc == 3) && (strcmp(argv[1], "auto") == 0) &&
+        ((channel >= 0) || all)) {
+        mutex_lock(&_lock);
+        for (unsigned i = 0; i < MOCK_CHANNEL_NUMOF; i++) {
+            if (all || ((int)i == channel)) {
+                _state[i].pinned = false;
+            }
+        }
+        mutex_unlock(&_lock);
+        return 0;
+    }
+
+    printf("usage: %s [set <channel> <value> | fail <channel|all> <1/1000> "
+           "| auto <channel|all>]\n", argv[0]);
+    return 1;
+}
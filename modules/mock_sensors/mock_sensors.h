@@ -0,0 +1,95 @@
+#ifndef MOCK_SENSORS_H
+#define MOCK_SENSORS_H
+
+#include <inttypes.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Values are replayed from this file of the working directory when it
+ * exists: "time_ms,channel,value" lines with values in the unit of the
+ * resource (e.g. 23.45 for °C), looped once the last line is reached.
+ * Channels missing from the file keep their generator. */
+#ifndef MOCK_SENSORS_TRACE
+#define MOCK_SENSORS_TRACE          "mock_sensors.csv"
+#endif
+#ifndef MOCK_SENSORS_TRACE_LEN
+#define MOCK_SENSORS_TRACE_LEN      (2048U)     /* lines kept */
+#endif
+
+/* Seed of the noise and of the failures: the same seed gives the same
+ * values and failures for the same sequence of reads of a channel */
+#ifndef MOCK_SENSORS_SEED
+#define MOCK_SENSORS_SEED           (1U)
+#endif
+
+/* Failure ratio of every channel in 1/1000, changed with "mock fail" */
+#ifndef MOCK_SENSORS_FAIL
+#define MOCK_SENSORS_FAIL           (0U)
+#endif
+
+/* Set to 0 to answer at once instead of waiting for the conversions */
+#ifndef MOCK_SENSORS_LATENCY
+#define MOCK_SENSORS_LATENCY        (1)
+#endif
+
+/* Time of a register read on the I2C bus at 100 kHz, reads of different
+ * devices do not overlap */
+#ifndef MOCK_SENSORS_I2C_US
+#define MOCK_SENSORS_I2C_US         (400U)
+#endif
+
+/* Channels with their generator: value at rest, amplitude and period in s
+ * of a sine around it, and uniform noise. Values are in 1/1000 of the unit
+ * of the resource. */
+#define MOCK_CHANNELS(X) \
+    X(TEMPERATURE, "temperature",   21500,   3000, 86400,   50) \
+    X(PRESSURE,    "pressure",    1013250,   2500, 43200,   80) \
+    X(HUMIDITY,    "humidity",      45000,  10000, 86400,  300) \
+    X(ECO2,        "eco2",         600000, 400000,  3600, 5000) \
+    X(TVOC,        "tvoc",          60000,  50000,  3600, 2000) \
+    X(ILLUMINANCE, "illuminance",  300000, 280000, 86400, 1000) \
+    X(ACCEL_X,     "accel_x",           0,     20,    10,    5) \
+    X(ACCEL_Y,     "accel_y",           0,     20,    13,    5) \
+    X(ACCEL_Z,     "accel_z",        1000,      0,     1,    5) \
+    X(GYRO_X,      "gyro_x",            0,   3000,     7,  500) \
+    X(GYRO_Y,      "gyro_y",            0,   3000,    11,  500) \
+    X(GYRO_Z,      "gyro_z",            0,   1000,    17,  500)
+
+#define MOCK_CHANNEL_ENUM(id, name, base, amplitude, period, noise) \
+    MOCK_##id,
+typedef enum {
+    MOCK_CHANNELS(MOCK_CHANNEL_ENUM)
+    MOCK_CHANNEL_NUMOF
+} mock_channel_t;
+#undef MOCK_CHANNEL_ENUM
+
+/* Loads the trace and registers the SAUL devices, before the sensor
+ * modules are initialized */
+void mock_sensors_init(void);
+
+/* Waits for the conversion then the bus transfer and returns the current
+ * value of the channel in 1/1000 of its unit, or -EIO when the read is
+ * chosen to fail */
+int mock_sensors_read(mock_channel_t channel, uint32_t conversion_us,
+                      int32_t *value);
+
+/* Returns the current value of a channel at once, for the other values of
+ * a transfer read with mock_sensors_read() */
+void mock_sensors_get(mock_channel_t channel, int32_t *value);
+
+#ifdef MODULE_MOCK_SAUL
+/* Registers accelerometer, gyroscope and environmental devices */
+void mock_saul_init(void);
+#endif
+
+/* Lists the channels, pins a value, sets a failure ratio or returns to the
+ * generator or trace */
+int mock_sensors_cmd(int argc, char **argv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MOCK_SENSORS_H */
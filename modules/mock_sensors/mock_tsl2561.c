@@ -0,0 +1,56 @@
+#ifdef MODULE_MOCK_TSL2561
+
+#include <inttypes.h>
+
+#include "tsl2561.h"
+
+#include "mock_sensors.h"
+
+/* integration time, full scale and resolution at 1x gain of each setting */
+static const struct {
+    uint32_t us;
+    uint16_t max_counts;
+    uint32_t ulx_per_count;
+} _integrations[] = {
+    [TSL2561_INTEGRATIONTIME_13MS] = { 13700, 5047, 891000 },
+    [TSL2561_INTEGRATIONTIME_101MS] = { 101000, 37177, 121000 },
+    [TSL2561_INTEGRATIONTIME_402MS] = { 402000, 65535, 30400 },
+};
+
+int tsl2561_init(tsl2561_t *dev, const tsl2561_params_t *params)
+{
+    if (params->integration > TSL2561_INTEGRATIONTIME_402MS) {
+        return TSL2561_BADDEV;
+    }
+    dev->params = *params;
+    return TSL2561_OK;
+}
+
+/* the read waits for a full integration, the value is quantized to the
+ * resolution of the range and saturates at its full scale */
+uint16_t tsl2561_read_illuminance(const tsl2561_t *dev)
+{
+    unsigned idx = dev->params.integration;
+    uint32_t ulx = _integrations[idx].ulx_per_count;
+    if (dev->params.gain == TSL2561_GAIN_16X) {
+        ulx /= 16;
+    }
+
+    int32_t value;
+    if (mock_sensors_read(MOCK_ILLUMINANCE, _integrations[idx].us,
+                          &value) < 0) {
+        return 0;
+    }
+    if (value < 0) {
+        return 0;
+    }
+    uint64_t counts = (uint64_t)value * 1000 / ulx;
+    if (counts > _integrations[idx].max_counts) {
+        counts = _integrations[idx].max_counts;
+    }
+    return counts * ulx / 1000000;
+}
+
+#else
+typedef int dont_be_pedantic;
+#endif /* MODULE_MOCK_TSL2561 */
@@ -1,15 +1,15 @@
 #include <inttypes.h>
+#include <stdbool.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
-#include <errno.h>
 
-#include "thread.h"
-#include "xtimer.h"
 #include "periph/i2c.h"
 
 #include "mqtt_bmx280.h"
 #include "mqtt_utils.h"
+#include "sensor_bus.h"
+#include "telemetry.h"
 
 #include "bmx280.h"
 #include "bmx280_params.h"
@@ -21,84 +21,119 @@
 #define APPLICATION_NAME "Node"
 #endif
 
-#define PUBLISH_INTERVAL       (5U)    /* set interval to 5 seconds */
-
-#define PUBLISH_QUEUE_SIZE     (8U)
-static msg_t _publish_msg_queue[PUBLISH_QUEUE_SIZE];
-static char publish_stack[THREAD_STACKSIZE_DEFAULT];
+#define BMX280_ACTIVE_UA       (714U)  /* typical current while measuring */
+#define BMX280_SLEEP_UA        (1U)    /* typical current in sleep mode */
 
 static bmx280_t bmx280_dev;
 
-void get_temperature(char *value) {
-    ssize_t p = 0;
-    int16_t temp = bmx280_read_temperature(&bmx280_dev);
-    bool negative = temp < 0;
-    if (negative) {
-        temp = -temp;
-    }
-    p += sprintf(value, "{\"value\":\"%s%d.%d°C\"}",
-                 negative ? "-" : "",
-                 temp / 100, (temp % 100) / 10);
-    value[p] = '\0';
-    DEBUG("[DEBUG] Get temperature '%s'\n", value);
+/* values of the last read of the bus scheduler */
+static struct {
+    bool ready;
+    int32_t temperature;
+    int32_t pressure;
+#ifdef MODULE_BME280
+    int32_t humidity;
+#endif
+} _last;
+
+/* raw values: centi degrees, Pa and centi percent */
+static const telemetry_sample_t _temperature = {
+    .name = "temperature", .idx = TELEMETRY_NO_INDEX,
+    .scale = -2, .digits = 1, .unit = "°C",
+};
+static const telemetry_sample_t _pressure = {
+    .name = "pressure", .idx = TELEMETRY_NO_INDEX,
+    .scale = -2, .digits = 2, .unit = "hPa",
+};
+#ifdef MODULE_BME280
+static const telemetry_sample_t _humidity = {
+    .name = "humidity", .idx = TELEMETRY_NO_INDEX,
+    .scale = -2, .digits = 2, .unit = "%",
+};
+#endif
+
+static void _get(char *value, const telemetry_sample_t *channel, int32_t raw)
+{
+    telemetry_sample_t sample = *channel;
+    sample.value = raw;
+    size_t p = sprintf(value, "{\"value\":\"");
+    p += telemetry_format(&value[p], &sample);
+    sprintf(&value[p], "\"}");
+    DEBUG("[DEBUG] Get %s '%s'\n", sample.name, value);
 }
 
-void get_pressure(char *value) {
-    ssize_t p = 0;
-    uint32_t pres = bmx280_read_pressure(&bmx280_dev);
-    p += sprintf(value, "{\"value\":\"%lu.%dhPa\"}",
-                 (unsigned long)pres / 100,
-                 (int)pres % 100);
-    value[p] = '\0';
-    DEBUG("[DEBUG] Get pressure '%s'\n", value);
+static void _publish(const telemetry_sample_t *channel, int32_t raw)
+{
+    telemetry_sample_t sample = *channel;
+    sample.value = raw;
+    telemetry_publish(&sample);
 }
 
+/* temperature first: the driver fetches all channels in a single burst
+   and compensates pressure and humidity with it */
+static int _bus_read(void *arg)
+{
+    (void)arg;
+    int16_t temperature = bmx280_read_temperature(&bmx280_dev);
+    if (temperature == INT16_MIN) {
+        return -1;
+    }
+    _last.temperature = temperature;
+    _last.pressure = bmx280_read_pressure(&bmx280_dev);
 #ifdef MODULE_BME280
-void get_humidity(char *value) {
-    ssize_t p = 0;
-    uint16_t hum = bme280_read_humidity(&bmx280_dev);
-    p += sprintf(value, "{\"value\":\"%u.%02u%%\"}",
-                 (unsigned int)(hum / 100),
-                 (unsigned int)(hum % 100));
-    value[p] = '\0';
-    DEBUG("[DEBUG] Get humidity '%s'\n", value);
-}
+    _last.humidity = bme280_read_humidity(&bmx280_dev);
 #endif
+    _last.ready = true;
+    return 0;
+}
 
-void *publish_thread(void *args)
+static void _bus_report(void *arg)
 {
-    (void)args;
-    char topic[64] = { 0 };
-    char payload[64] = { 0 };
-
-    msg_init_queue(_publish_msg_queue, PUBLISH_QUEUE_SIZE);
-    for(;;) {
-        memset(topic, 0, sizeof(topic));
-        sprintf(topic, "node/%s/temperature", NODE_ID);
-        get_temperature(payload);
-        publish((uint8_t*)topic, (uint8_t*)payload);
-
-        xtimer_sleep(1);
-        memset(topic, 0, sizeof(topic));
-        sprintf(topic, "node/%s/pressure", NODE_ID);
-        get_pressure(payload);
-        publish((uint8_t*)topic, (uint8_t*)payload);
-
+    (void)arg;
+    _publish(&_temperature, _last.temperature);
+    _publish(&_pressure, _last.pressure);
 #ifdef MODULE_BME280
-        xtimer_sleep(1);
-        memset(topic, 0, sizeof(topic));
-        sprintf(topic, "node/%s/humidity", NODE_ID);
-        get_humidity(payload);
-        publish((uint8_t*)topic, (uint8_t*)payload);
+    _publish(&_humidity, _last.humidity);
 #endif
-        /* wait 5 seconds */
-        xtimer_sleep(PUBLISH_INTERVAL);
+    telemetry_flush();
+}
+
+static sensor_bus_dev_t _bus_dev = {
+    .name = "bmx280",
+    .read = _bus_read,
+    .report = _bus_report,
+};
+
+/* the getters answer with the last values, the sensor is only read when
+   the bus did not read it yet */
+static void _update(void)
+{
+    if (!_last.ready) {
+        _bus_read(NULL);
     }
-    return NULL;
 }
 
+void get_temperature(char *value) {
+    _update();
+    _get(value, &_temperature, _last.temperature);
+}
+
+void get_pressure(char *value) {
+    _update();
+    _get(value, &_pressure, _last.pressure);
+}
+
+#ifdef MODULE_BME280
+void get_humidity(char *value) {
+    _update();
+    _get(value, &_humidity, _last.humidity);
+}
+#endif
+
 void init_bmx280_mqtt_sender(void)
 {
+    telemetry_init();
+
     /* Initialize the BMX280 sensor */
     DEBUG("+------------Initializing BMX280 sensor ------------+\n");
     int result = bmx280_init(&bmx280_dev, &bmx280_params[0]);
@@ -112,16 +147,9 @@ void init_bmx280_mqtt_sender(void)
         DEBUG("[INFO] Initialization successful\n\n");
     }
 
-    /* create the publish thread that will send periodic measures to
-       the broker */
-    int publish_pid = thread_create(publish_stack, sizeof(publish_stack),
-                                   THREAD_PRIORITY_MAIN - 1,
-                                   THREAD_CREATE_STACKTEST, publish_thread,
-                                   NULL, "Publish thread");
-    if (publish_pid == -EINVAL || publish_pid == -EOVERFLOW) {
-        DEBUG("[ERROR] Failed to create bmx280 sender thread, exiting\n");
-    }
-    else {
-        DEBUG("[ERROR] Successfuly created beaconing thread !\n");
-    }
-}
\ No newline at end of file
+    /* periodic measures are read and published by the bus scheduler, every
+       report_interval */
+    _bus_dev.active_ua = BMX280_ACTIVE_UA;
+    _bus_dev.idle_ua = BMX280_SLEEP_UA;
+    sensor_bus_register(&_bus_dev);
+}
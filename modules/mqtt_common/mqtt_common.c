@@ -9,6 +9,9 @@
 
 #include "mqtt_common.h"
 #include "mqtt_utils.h"
+#ifdef MODULE_NODE_CONFIG
+#include "node_config.h"
+#endif
 
 #define ENABLE_DEBUG (0)
 #include "debug.h"
@@ -17,11 +20,29 @@
 #define APPLICATION_NAME "Node"
 #endif
 
-#define BEACON_INTERVAL       (30000000U)    /* set interval to 30 seconds */
+#define BEACON_INTERVAL       (30U)    /* default interval in seconds */
 
 #define BEACONING_QUEUE_SIZE  (8U)
+
+#ifndef BEACON_STACKSIZE
+#define BEACON_STACKSIZE      (THREAD_STACKSIZE_DEFAULT)
+#endif
+
 static msg_t _beaconing_msg_queue[BEACONING_QUEUE_SIZE];
-static char beaconing_stack[THREAD_STACKSIZE_DEFAULT];
+static char beaconing_stack[BEACON_STACKSIZE];
+
+static uint32_t beacon_interval = BEACON_INTERVAL;
+
+#ifdef MODULE_NODE_CONFIG
+/* read by the beaconing thread before each wait */
+static node_config_entry_t _config = {
+    .name = "beacon_interval",
+    .type = NODE_CONFIG_UINT,
+    .value = &beacon_interval,
+    .min = 1,
+    .max = 24 * 60 * 60,
+};
+#endif
 
 void get_board(char *value) {
     DEBUG("[DEBUG] Get board '%s'\n", RIOT_BOARD);
@@ -52,14 +73,17 @@ void *beaconing_thread(void *args)
         memset(id, 0, sizeof(id));
         sprintf(id, "{\"id\":\"%s\"}", NODE_ID);
         publish((uint8_t*)"node/check", (uint8_t*)id);
-        /* wait 30 seconds */
-        xtimer_usleep(BEACON_INTERVAL);
+        xtimer_sleep(beacon_interval);
     }
     return NULL;
 }
 
 void init_beacon_sender(void)
 {
+#ifdef MODULE_NODE_CONFIG
+    node_config_register(&_config);
+#endif
+
     /* create the beaconning thread that will send periodic messages to
        the broker */
     int beacon_pid = thread_create(beaconing_stack, sizeof(beaconing_stack),
@@ -1,37 +1,122 @@
+#include <errno.h>
 #include <inttypes.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include "thread.h"
 #include "net/emcute.h"
+#include "net/ipv6/addr.h"
 
 #include "mqtt_utils.h"
+#include "metrics.h"
+#include "trace.h"
+#include "tlog.h"
 
 #define ENABLE_DEBUG (0)
 #include "debug.h"
 
+#define MQTT_PORT             (1883U)
+
+#define EMCUTE_PRIO           (THREAD_PRIORITY_MAIN - 1)
+#ifndef EMCUTE_STACKSIZE
+#define EMCUTE_STACKSIZE      (THREAD_STACKSIZE_DEFAULT)
+#endif
+
+static char _emcute_stack[EMCUTE_STACKSIZE];
+static kernel_pid_t _emcute_pid = KERNEL_PID_UNDEF;
+static bool _connected = false;
+
+static void *_emcute_thread(void *arg)
+{
+    (void)arg;
+    emcute_run(MQTT_PORT, NODE_ID);
+    return NULL;    /* should never be reached */
+}
+
+int mqtt_utils_connect(void)
+{
+    if (_connected) {
+        return 0;
+    }
+
+    if (_emcute_pid == KERNEL_PID_UNDEF) {
+        _emcute_pid = thread_create(_emcute_stack, sizeof(_emcute_stack),
+                                    EMCUTE_PRIO, THREAD_CREATE_STACKTEST,
+                                    _emcute_thread, NULL, "emcute");
+        if (_emcute_pid == -EINVAL || _emcute_pid == -EOVERFLOW) {
+            DEBUG("[ERROR] Failed to create the emcute thread\n");
+            _emcute_pid = KERNEL_PID_UNDEF;
+            return -1;
+        }
+    }
+
+    sock_udp_ep_t gw = { .family = AF_INET6, .port = GATEWAY_PORT };
+    if (ipv6_addr_from_str((ipv6_addr_t *)&gw.addr.ipv6, GATEWAY_ADDR) == NULL) {
+        DEBUG("[ERROR] error parsing IPv6 address\n");
+        return -1;
+    }
+
+    if (emcute_con(&gw, true, NULL, NULL, 0, 0) != EMCUTE_OK) {
+        DEBUG("[ERROR] unable to connect to [%s]:%i\n",
+              GATEWAY_ADDR, (int)GATEWAY_PORT);
+        return -1;
+    }
+    DEBUG("[INFO] Successfully connected to gateway at [%s]:%i\n",
+          GATEWAY_ADDR, (int)GATEWAY_PORT);
+    _connected = true;
+
+    return 0;
+}
+
+bool mqtt_utils_connected(void)
+{
+    return _connected;
+}
+
 int publish(uint8_t *topic, uint8_t *payload)
 {
     emcute_topic_t t;
+
+    t.name = (char*)topic;
+    t.id = 0;
+    return publish_topic(&t, (char*)payload);
+}
+
+int publish_topic(emcute_topic_t *topic, const char *payload)
+{
     unsigned flags = EMCUTE_QOS_1;
+    METRICS_START(t);
+    TRACE_BEGIN(SEND);
 
-    DEBUG("[DEBUG] Publish with topic: %s, data: %s and flags: 0x%02x\n",
-          topic, payload, (int)flags);
+    /* topic names built at run time and payloads are RAM buffers that
+       tlog cannot decode, only their lengths and the topic id are logged */
+    TLOG("[DEBUG] Publish %u chars on topic %i (%u chars), flags: 0x%02x\n",
+         (unsigned)strlen(payload), (int)topic->id,
+         (unsigned)strlen(topic->name), (int)flags);
 
-    t.name = (char*)topic;
-    if (emcute_reg(&t) != EMCUTE_OK) {
-        DEBUG("[ERROR] Unable to obtain topic %s\n", t.name);
+    /* 0 is a reserved MQTT-SN topic id, it marks unregistered topics */
+    if ((topic->id == 0) && (emcute_reg(topic) != EMCUTE_OK)) {
+        TLOG("[ERROR] Unable to obtain a topic id (%u chars)\n",
+             (unsigned)strlen(topic->name));
+        METRICS_INC(MQTT_TX_ERR);
+        TRACE_END(SEND);
         return 1;
     }
 
     /* step 2: publish data */
-    if (emcute_pub(&t, (char*)payload,
-                   strlen((char*)payload), flags) != EMCUTE_OK) {
-        DEBUG("[ERROR] Unable to publish data to topic '%s [%i]'\n",
-              t.name, (int)t.id);
+    if (emcute_pub(topic, payload, strlen(payload), flags) != EMCUTE_OK) {
+        TLOG("[ERROR] Unable to publish data to topic %i\n",
+             (int)topic->id);
+        METRICS_INC(MQTT_TX_ERR);
+        TRACE_END(SEND);
         return 1;
     }
+    METRICS_STOP(SEND, t);
+    TRACE_END(SEND);
+    METRICS_INC(MQTT_TX);
 
-    DEBUG("[DEBUG] Published %i bytes to topic '%s [%i]'\n",
-          (int)strlen((char*)payload), t.name, t.id);
+    TLOG("[DEBUG] Published %i bytes to topic %i\n",
+         (int)strlen(payload), (int)topic->id);
 
     return 0;
 }
@@ -2,13 +2,39 @@
 #define MQTT_UTILS_H
 
 #include <inttypes.h>
+#include <stdbool.h>
+
+#include "net/emcute.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#ifndef NODE_ID
+#define NODE_ID "node_id_0"
+#endif
+
+#ifndef GATEWAY_ADDR
+#define GATEWAY_ADDR "2001:660:3207:102::4"
+#endif
+
+#ifndef GATEWAY_PORT
+#define GATEWAY_PORT 1885
+#endif
+
+/* node topics are string literals built at compile time */
+#define MQTT_TOPIC(path)    "node/" NODE_ID "/" path
+
+/* Starts the emcute thread on first use and connects to the MQTT-SN
+ * gateway at GATEWAY_ADDR, returns at once when already connected */
+int mqtt_utils_connect(void);
+bool mqtt_utils_connected(void);
+
 int publish(uint8_t *topic, uint8_t *payload);
 
+/* publish on a topic that is registered on first use only */
+int publish_topic(emcute_topic_t *topic, const char *payload);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,207 @@
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "mutex.h"
+
+#include "node_config.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+static node_config_entry_t *_entries = NULL;
+static mutex_t _lock = MUTEX_INIT;
+
+/* persisted settings, read once when the first entry is registered */
+static char _stored[NODE_CONFIG_STORE_LEN];
+static bool _loaded = false;
+
+static node_config_entry_t *_find(const char *name)
+{
+    for (node_config_entry_t *e = _entries; e != NULL; e = e->next) {
+        if (strcmp(e->name, name) == 0) {
+            return e;
+        }
+    }
+    return NULL;
+}
+
+static int _parse(node_config_entry_t *entry, const char *value)
+{
+    switch (entry->type) {
+    case NODE_CONFIG_UINT: {
+        char *end;
+        unsigned long v = strtoul(value, &end, 10);
+        if ((*value == '\0') || (*end != '\0') ||
+            (v < entry->min) || (v > entry->max)) {
+            return -EINVAL;
+        }
+        *(uint32_t *)entry->value = v;
+        return 0;
+    }
+    case NODE_CONFIG_BOOL:
+        if ((strcmp(value, "1") == 0) || (strcmp(value, "true") == 0)) {
+            *(bool *)entry->value = true;
+        }
+        else if ((strcmp(value, "0") == 0) || (strcmp(value, "false") == 0)) {
+            *(bool *)entry->value = false;
+        }
+        else {
+            return -EINVAL;
+        }
+        return 0;
+    case NODE_CONFIG_STR:
+        if (strlen(value) >= entry->max) {
+            return -EINVAL;
+        }
+        strcpy(entry->value, value);
+        return 0;
+    }
+    return -EINVAL;
+}
+
+static int _format(const node_config_entry_t *entry, char *buf, size_t len)
+{
+    switch (entry->type) {
+    case NODE_CONFIG_UINT:
+        return snprintf(buf, len, "%s=%" PRIu32, entry->name,
+                        *(uint32_t *)entry->value);
+    case NODE_CONFIG_BOOL:
+        return snprintf(buf, len, "%s=%d", entry->name,
+                        (*(bool *)entry->value) ? 1 : 0);
+    case NODE_CONFIG_STR:
+        return snprintf(buf, len, "%s=%s", entry->name,
+                        (const char *)entry->value);
+    }
+    return 0;
+}
+
+/* "name=value" of the stored settings, written to value */
+static bool _stored_value(const char *name, char *value, size_t len)
+{
+    size_t name_len = strlen(name);
+    for (const char *p = _stored; *p != '\0'; ) {
+        const char *end = strchr(p, '&');
+        size_t pair_len = (end) ? (size_t)(end - p) : strlen(p);
+        if ((pair_len > name_len) && (strncmp(p, name, name_len) == 0) &&
+            (p[name_len] == '=') && (pair_len - name_len - 1 < len)) {
+            memcpy(value, &p[name_len + 1], pair_len - name_len - 1);
+            value[pair_len - name_len - 1] = '\0';
+            return true;
+        }
+        p += pair_len + ((end) ? 1 : 0);
+    }
+    return false;
+}
+
+void node_config_register(node_config_entry_t *entry)
+{
+    mutex_lock(&_lock);
+    if (!_loaded) {
+        _loaded = true;
+        if (node_config_store_read(_stored, sizeof(_stored)) < 0) {
+            _stored[0] = '\0';
+        }
+    }
+
+    if (_find(entry->name)) {
+        mutex_unlock(&_lock);
+        return;
+    }
+    entry->next = _entries;
+    _entries = entry;
+
+    char value[NODE_CONFIG_STORE_LEN];
+    bool stored = _stored_value(entry->name, value, sizeof(value)) &&
+                  (_parse(entry, value) == 0);
+    mutex_unlock(&_lock);
+
+    if (stored) {
+        DEBUG("[DEBUG] config: %s=%s loaded\n", entry->name, value);
+        if (entry->apply) {
+            entry->apply(entry);
+        }
+    }
+}
+
+int node_config_set(const char *name, const char *value)
+{
+    mutex_lock(&_lock);
+    node_config_entry_t *entry = _find(name);
+    int res = (entry) ? _parse(entry, value) : -ENOENT;
+    mutex_unlock(&_lock);
+
+    if (res < 0) {
+        DEBUG("[DEBUG] config: %s=%s rejected (%d)\n", name, value, res);
+        return res;
+    }
+    if (entry->apply) {
+        entry->apply(entry);
+    }
+    return 0;
+}
+
+int node_config_set_all(char *list)
+{
+    char *saveptr = NULL;
+    for (char *tok = strtok_r(list, "&,", &saveptr); tok != NULL;
+         tok = strtok_r(NULL, "&,", &saveptr)) {
+        char *val = strchr(tok, '=');
+        if (val == NULL) {
+            return -EINVAL;
+        }
+        *val++ = '\0';
+        int res = node_config_set(tok, val);
+        if (res < 0) {
+            return res;
+        }
+    }
+    /* without a backend the settings only last until the next reboot */
+    int res = node_config_save();
+    return (res == -ENOTSUP) ? 0 : res;
+}
+
+int node_config_format(char *buf, size_t len)
+{
+    size_t p = 0;
+
+    if (len == 0) {
+        return -ENOSPC;
+    }
+    buf[0] = '\0';
+    mutex_lock(&_lock);
+    for (node_config_entry_t *e = _entries; e != NULL; e = e->next) {
+        if ((p > 0) && (p < len)) {
+            buf[p++] = '&';
+        }
+        int n = _format(e, &buf[p], (p < len) ? len - p : 0);
+        if ((n < 0) || (p + n >= len)) {
+            mutex_unlock(&_lock);
+            return -ENOSPC;
+        }
+        p += n;
+    }
+    mutex_unlock(&_lock);
+    return p;
+}
+
+int node_config_save(void)
+{
+    char buf[NODE_CONFIG_STORE_LEN];
+    int len = node_config_format(buf, sizeof(buf));
+    if (len < 0) {
+        return len;
+    }
+    /* unchanged settings are not written again, flash pages wear out */
+    if (strcmp(buf, _stored) == 0) {
+        return 0;
+    }
+    int res = node_config_store_write(buf, len + 1);
+    if (res == 0) {
+        strcpy(_stored, buf);
+    }
+    return res;
+}
@@ -0,0 +1,69 @@
+#ifndef NODE_CONFIG_H
+#define NODE_CONFIG_H
+
+#include <stdbool.h>
+#include <inttypes.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef NODE_CONFIG_STORE_LEN
+#define NODE_CONFIG_STORE_LEN       (256U)  /* persisted "name=value&..." text */
+#endif
+
+#define NODE_CONFIG_URI             "/config"
+
+typedef enum {
+    NODE_CONFIG_UINT,       /* uint32_t within [min, max] */
+    NODE_CONFIG_BOOL,       /* bool, "0"/"1" or "false"/"true" */
+    NODE_CONFIG_STR,        /* char array of max bytes */
+} node_config_type_t;
+
+/* A setting owned by a module. Modules register their settings at init,
+ * the persisted value, if any, is loaded at once. `apply` is called after
+ * each change so that the module can update its running state. */
+typedef struct node_config_entry {
+    struct node_config_entry *next;
+    const char *name;
+    node_config_type_t type;
+    void *value;
+    uint32_t min;
+    uint32_t max;                       /* string buffer size for strings */
+    void (*apply)(const struct node_config_entry *entry);   /* optional */
+} node_config_entry_t;
+
+void node_config_register(node_config_entry_t *entry);
+
+/* Parses, validates and applies a value, returns -ENOENT for an unknown
+ * name and -EINVAL for an invalid value */
+int node_config_set(const char *name, const char *value);
+
+/* Applies each "name=value" of a "&" separated list, stops at the first
+ * error, persists the settings when all of them were valid */
+int node_config_set_all(char *list);
+
+/* Writes "name=value" pairs separated by "&", returns the length or
+ * -ENOSPC if the buffer is too small */
+int node_config_format(char *buf, size_t len);
+
+/* Persists the current settings */
+int node_config_save(void);
+
+/* Persistence backend: flash page, file on native or none */
+int node_config_store_read(char *buf, size_t len);
+int node_config_store_write(const char *buf, size_t len);
+
+/* Registers the /config resource */
+void init_config_handler(void);
+
+/* Subscribes to node/<id>/config/set and publishes the settings on
+ * node/<id>/config, to be called once MQTT-SN is connected */
+void init_config_mqtt(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NODE_CONFIG_H */
@@ -0,0 +1,78 @@
+#ifdef MODULE_GCOAP
+
+#include <errno.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include "net/gcoap.h"
+
+#include "node_config.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+static ssize_t _config_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx);
+
+static const coap_resource_t _resources[] = {
+    { NODE_CONFIG_URI, COAP_GET | COAP_POST | COAP_PUT, _config_handler, NULL },
+};
+
+static gcoap_listener_t _listener = {
+    (coap_resource_t *)&_resources[0],
+    sizeof(_resources) / sizeof(_resources[0]),
+    NULL
+};
+
+static ssize_t _config_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx)
+{
+    (void)ctx;
+    unsigned method_flag = coap_method2flag(coap_get_code_detail(pdu));
+
+    if (method_flag & (COAP_POST | COAP_PUT)) {
+        char payload[NODE_CONFIG_STORE_LEN];
+
+        if (pdu->payload_len >= sizeof(payload)) {
+            return coap_reply_simple(pdu, COAP_CODE_REQUEST_ENTITY_TOO_LARGE,
+                                     buf, len, COAP_FORMAT_TEXT, NULL, 0);
+        }
+        memcpy(payload, pdu->payload, pdu->payload_len);
+        payload[pdu->payload_len] = '\0';
+
+        unsigned code;
+        switch (node_config_set_all(payload)) {
+        case 0:
+            code = COAP_CODE_CHANGED;
+            break;
+        case -ENOENT:
+            code = COAP_CODE_NOT_FOUND;
+            break;
+        case -EINVAL:
+            code = COAP_CODE_BAD_REQUEST;
+            break;
+        default:
+            /* applied but not persisted */
+            code = COAP_CODE_INTERNAL_SERVER_ERROR;
+            break;
+        }
+        return coap_reply_simple(pdu, code, buf, len, COAP_FORMAT_TEXT, NULL, 0);
+    }
+
+    /* GET: "name=value&..." of all the settings */
+    gcoap_resp_init(pdu, buf, len, COAP_CODE_CONTENT);
+    int n = node_config_format((char*)pdu->payload, pdu->payload_len);
+    if (n < 0) {
+        return coap_reply_simple(pdu, COAP_CODE_INTERNAL_SERVER_ERROR, buf, len,
+                                 COAP_FORMAT_TEXT, NULL, 0);
+    }
+
+    return gcoap_finish(pdu, n, COAP_FORMAT_TEXT);
+}
+
+void init_config_handler(void)
+{
+    gcoap_register_listener(&_listener);
+}
+
+#else
+typedef int dont_be_pedantic;
+#endif /* MODULE_GCOAP */
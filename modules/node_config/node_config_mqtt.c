@@ -0,0 +1,65 @@
+#ifdef MODULE_EMCUTE
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "net/emcute.h"
+
+#include "mqtt_utils.h"
+#include "node_config.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+static emcute_sub_t _sub;
+static emcute_topic_t _config_topic = { MQTT_TOPIC("config"), 0 };
+static char _buf[NODE_CONFIG_STORE_LEN];
+
+/* the settings are published with QoS 0: a QoS 1 publish waits for the
+   emcute thread, which runs this callback */
+static void _publish(void)
+{
+    int len = node_config_format(_buf, sizeof(_buf));
+    if ((len >= 0) && (_config_topic.id != 0)) {
+        emcute_pub(&_config_topic, _buf, len, EMCUTE_QOS_0);
+    }
+}
+
+static void _on_set(const emcute_topic_t *topic, void *data, size_t len)
+{
+    (void)topic;
+
+    if (len >= sizeof(_buf)) {
+        DEBUG("[ERROR] config: payload too large\n");
+        return;
+    }
+    memcpy(_buf, data, len);
+    _buf[len] = '\0';
+
+    int res = node_config_set_all(_buf);
+    if (res < 0) {
+        DEBUG("[ERROR] config: update rejected (%d)\n", res);
+    }
+    _publish();
+}
+
+void init_config_mqtt(void)
+{
+    _sub.cb = _on_set;
+    _sub.topic.name = MQTT_TOPIC("config/set");
+    if (emcute_sub(&_sub, EMCUTE_QOS_1) != EMCUTE_OK) {
+        DEBUG("[ERROR] config: unable to subscribe to %s\n", _sub.topic.name);
+        return;
+    }
+    if (emcute_reg(&_config_topic) != EMCUTE_OK) {
+        DEBUG("[ERROR] config: unable to register %s\n", _config_topic.name);
+        return;
+    }
+    _publish();
+}
+
+#else
+typedef int dont_be_pedantic;
+#endif /* MODULE_EMCUTE */
@@ -0,0 +1,116 @@
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "node_config.h"
+
+#if defined(BOARD_NATIVE)
+#include "native_internal.h"
+#elif defined(MODULE_PERIPH_FLASHPAGE)
+#include "periph/flashpage.h"
+#endif
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+#if defined(BOARD_NATIVE)
+
+#ifndef NODE_CONFIG_FILE
+#define NODE_CONFIG_FILE            "node_config.txt"   /* in the working directory */
+#endif
+
+int node_config_store_read(char *buf, size_t len)
+{
+    _native_syscall_enter();
+    FILE *f = real_fopen(NODE_CONFIG_FILE, "r");
+    size_t n = 0;
+    if (f != NULL) {
+        n = real_fread(buf, 1, len - 1, f);
+        real_fclose(f);
+    }
+    _native_syscall_leave();
+
+    if (f == NULL) {
+        return -ENOENT;
+    }
+    buf[n] = '\0';
+    return n;
+}
+
+int node_config_store_write(const char *buf, size_t len)
+{
+    _native_syscall_enter();
+    FILE *f = real_fopen(NODE_CONFIG_FILE, "w");
+    size_t n = 0;
+    if (f != NULL) {
+        /* the terminating null byte is not written to the file */
+        n = real_fwrite(buf, 1, len - 1, f);
+        real_fclose(f);
+    }
+    _native_syscall_leave();
+
+    return ((f != NULL) && (n == len - 1)) ? 0 : -EIO;
+}
+
+#elif defined(MODULE_PERIPH_FLASHPAGE)
+
+#ifndef NODE_CONFIG_FLASHPAGE
+#define NODE_CONFIG_FLASHPAGE       (FLASHPAGE_NUMOF - 1)   /* must not hold firmware */
+#endif
+#define NODE_CONFIG_MAGIC           (0x31676663)    /* "cfg1" */
+#define NODE_CONFIG_PAGE_LEN        ((NODE_CONFIG_STORE_LEN < FLASHPAGE_SIZE - 4) \
+                                     ? NODE_CONFIG_STORE_LEN : FLASHPAGE_SIZE - 4)
+
+/* a whole page is written at once */
+static uint32_t _page[FLASHPAGE_SIZE / sizeof(uint32_t)];
+
+int node_config_store_read(char *buf, size_t len)
+{
+    flashpage_read(NODE_CONFIG_FLASHPAGE, _page);
+    if (_page[0] != NODE_CONFIG_MAGIC) {
+        return -ENOENT;
+    }
+    const char *text = (const char *)&_page[1];
+    size_t n = strnlen(text, NODE_CONFIG_PAGE_LEN);
+    if ((n == NODE_CONFIG_PAGE_LEN) || (n >= len)) {
+        return -EINVAL;
+    }
+    memcpy(buf, text, n + 1);
+    return n;
+}
+
+int node_config_store_write(const char *buf, size_t len)
+{
+    if (len > NODE_CONFIG_PAGE_LEN) {
+        return -ENOSPC;
+    }
+    memset(_page, 0xff, sizeof(_page));
+    _page[0] = NODE_CONFIG_MAGIC;
+    memcpy(&_page[1], buf, len);
+    if (flashpage_write_and_verify(NODE_CONFIG_FLASHPAGE, _page) != FLASHPAGE_OK) {
+        DEBUG("[ERROR] config: writing page %u failed\n",
+              (unsigned)NODE_CONFIG_FLASHPAGE);
+        return -EIO;
+    }
+    return 0;
+}
+
+#else
+
+/* settings are not persisted */
+int node_config_store_read(char *buf, size_t len)
+{
+    (void)buf;
+    (void)len;
+    return -ENOTSUP;
+}
+
+int node_config_store_write(const char *buf, size_t len)
+{
+    (void)buf;
+    (void)len;
+    return -ENOTSUP;
+}
+
+#endif
@@ -0,0 +1,99 @@
+#include <stdlib.h>
+
+#include "shell.h"
+
+#include "node_tools.h"
+#ifdef MODULE_ENERGY
+#include "energy.h"
+#endif
+#ifdef MODULE_METRICS
+#include "metrics.h"
+#endif
+#ifdef MODULE_MICROBENCH
+#include "microbench.h"
+#endif
+#ifdef MODULE_MOCK_SENSORS
+#include "mock_sensors.h"
+#endif
+#ifdef MODULE_PERF
+#include "perf.h"
+#endif
+#ifdef MODULE_SENSOR_BUS
+#include "sensor_bus.h"
+#endif
+#ifdef MODULE_STACK_USAGE
+#include "stack_usage.h"
+#endif
+#ifdef MODULE_TLOG
+#include "tlog.h"
+#endif
+#ifdef MODULE_TRACE
+#include "trace.h"
+#endif
+
+const shell_command_t node_tools_shell_commands[] = {
+#ifdef MODULE_MICROBENCH
+    { "bench", "Run the microbenchmarks of the module code", microbench_cmd },
+#endif
+#ifdef MODULE_SENSOR_BUS
+    { "bus", "Print the sensor bus cycles and busy time", sensor_bus_cmd },
+#endif
+#ifdef MODULE_ENERGY
+    { "energy", "Print the estimated current draw and battery life", energy_cmd },
+#endif
+#ifdef MODULE_METRICS
+    { "metrics", "Print the hot path counters and latencies", metrics_cmd },
+#endif
+#ifdef MODULE_MOCK_SENSORS
+    { "mock", "Show or override the mock sensor values", mock_sensors_cmd },
+#endif
+#ifdef MODULE_PERF
+    { "perf", "Print the CPU time of each thread and job", perf_cmd },
+#endif
+#ifdef MODULE_STACK_USAGE
+    { "stacks", "Print the stack usage of each thread", stack_usage_cmd },
+#endif
+#ifdef MODULE_TLOG
+    { "tlog", "Print and clear the tokenized log", tlog_cmd },
+#endif
+#ifdef MODULE_TRACE
+    { "trace", "Print and clear the request trace", trace_cmd },
+#endif
+    { NULL, NULL, NULL }
+};
+
+void node_tools_init(const struct gcoap_listener *listener)
+{
+    (void)listener;
+
+#ifdef MODULE_GCOAP
+#ifdef MODULE_METRICS
+    init_metrics_handler();
+#endif
+#ifdef MODULE_STACK_USAGE
+    init_stack_usage_handler();
+#endif
+#ifdef MODULE_TLOG
+    init_tlog_handler();
+#endif
+#ifdef MODULE_TRACE
+    init_trace_handler();
+#endif
+#ifdef MODULE_ENERGY
+    init_energy_handler();
+#endif
+#ifdef MODULE_MICROBENCH
+    if (listener) {
+        microbench_init(listener);
+    }
+#endif
+#else /* without a CoAP server the modules are only read from the shell */
+#ifdef MODULE_ENERGY
+    energy_init();
+#endif
+#endif /* MODULE_GCOAP */
+
+#ifdef MODULE_MOCK_SENSORS
+    mock_sensors_init();
+#endif
+}
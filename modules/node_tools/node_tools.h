@@ -0,0 +1,26 @@
+#ifndef NODE_TOOLS_H
+#define NODE_TOOLS_H
+
+#include "shell.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct gcoap_listener;
+
+/* Shell commands of the optional instrumentation and mock modules built in
+ * (energy, metrics, mock, perf, stacks, tlog, trace, bench), to be passed
+ * to shell_run() */
+extern const shell_command_t node_tools_shell_commands[];
+
+/* Starts these modules and registers their resources, before the sensor
+ * modules are initialized. `listener` holds the resources of the
+ * application for the microbenchmarks, NULL without a CoAP server. */
+void node_tools_init(const struct gcoap_listener *listener);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NODE_TOOLS_H */
@@ -0,0 +1,140 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "irq.h"
+#include "sched.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#include "perf.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+typedef struct {
+    unsigned schedules;
+    uint64_t runtime_ticks;
+} _baseline_t;
+
+static perf_job_t *_jobs = NULL;
+/* scheduler statistics at the last reset, they are never cleared */
+static _baseline_t _baseline[KERNEL_PID_LAST + 1];
+static uint64_t _since = 0;
+
+void perf_job_register(perf_job_t *job)
+{
+    unsigned state = irq_disable();
+    job->runs = 0;
+    job->time = 0;
+    job->next = _jobs;
+    _jobs = job;
+    irq_restore(state);
+}
+
+void perf_job_add(perf_job_t *job, uint32_t us)
+{
+    unsigned state = irq_disable();
+    job->runs++;
+    job->time += us;
+    irq_restore(state);
+}
+
+static uint64_t _ticks_to_usec(uint64_t ticks)
+{
+    xtimer_ticks64_t t = { ticks };
+    return xtimer_usec_from_ticks64(t);
+}
+
+unsigned perf_get_threads(perf_entry_t *entries, unsigned numof)
+{
+    unsigned n = 0;
+
+    for (kernel_pid_t pid = KERNEL_PID_FIRST;
+         (pid <= KERNEL_PID_LAST) && (n < numof); pid++) {
+        if (thread_get(pid) == NULL) {
+            continue;
+        }
+        unsigned state = irq_disable();
+        schedstat_t stat = sched_pidlist[pid];
+        irq_restore(state);
+        entries[n].name = thread_getname(pid);
+        entries[n].active = _ticks_to_usec(stat.runtime_ticks -
+                                           _baseline[pid].runtime_ticks);
+        entries[n].runs = stat.schedules - _baseline[pid].schedules;
+        n++;
+    }
+
+    return n;
+}
+
+uint64_t perf_get_elapsed(void)
+{
+    return xtimer_now_usec64() - _since;
+}
+
+void perf_reset(void)
+{
+    unsigned state = irq_disable();
+    for (kernel_pid_t pid = 0; pid <= KERNEL_PID_LAST; pid++) {
+        _baseline[pid].schedules = sched_pidlist[pid].schedules;
+        _baseline[pid].runtime_ticks = sched_pidlist[pid].runtime_ticks;
+    }
+    for (perf_job_t *job = _jobs; job != NULL; job = job->next) {
+        job->runs = 0;
+        job->time = 0;
+    }
+    irq_restore(state);
+    _since = xtimer_now_usec64();
+}
+
+static void _print(const char *name, uint64_t active, uint32_t runs,
+                   uint64_t elapsed)
+{
+    /* per mille of the elapsed time, per mille of runs per second */
+    uint32_t cpu = (elapsed) ? (uint32_t)((active * 1000) / elapsed) : 0;
+    uint32_t rate = (elapsed) ? (uint32_t)(((uint64_t)runs * 1000 * US_PER_SEC) /
+                                           elapsed) : 0;
+    printf("%-20s %10" PRIu32 " %3" PRIu32 ".%" PRIu32 " %7" PRIu32 ".%03" PRIu32
+           " %10" PRIu32 "\n",
+           (name) ? name : "-", (uint32_t)(active / US_PER_MS),
+           cpu / 10, cpu % 10, rate / 1000, rate % 1000,
+           (runs) ? (uint32_t)(active / runs) : 0);
+}
+
+int perf_cmd(int argc, char **argv)
+{
+    if ((argc > 1) && (strcmp(argv[1], "reset") == 0)) {
+        perf_reset();
+        return 0;
+    }
+    if (argc > 1) {
+        printf("usage: %s [reset]\n", argv[0]);
+        return 1;
+    }
+
+    uint64_t elapsed = perf_get_elapsed();
+    perf_entry_t entries[MAXTHREADS];
+    unsigned numof = perf_get_threads(entries, MAXTHREADS);
+
+    printf("elapsed: %" PRIu32 " ms\n", (uint32_t)(elapsed / US_PER_MS));
+    printf("%-20s %10s %5s %11s %10s\n",
+           "thread", "active ms", "cpu %", "wakeups/s", "avg run us");
+    for (unsigned i = 0; i < numof; i++) {
+        _print(entries[i].name, entries[i].active, entries[i].runs, elapsed);
+    }
+
+    if (_jobs) {
+        printf("%-20s %10s %5s %11s %10s\n",
+               "job", "active ms", "cpu %", "runs/s", "avg run us");
+    }
+    for (perf_job_t *job = _jobs; job != NULL; job = job->next) {
+        unsigned state = irq_disable();
+        uint64_t time = job->time;
+        uint32_t runs = job->runs;
+        irq_restore(state);
+        _print(job->name, time, runs, elapsed);
+    }
+
+    return 0;
+}
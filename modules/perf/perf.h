@@ -0,0 +1,43 @@
+#ifndef PERF_H
+#define PERF_H
+
+#include <inttypes.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A unit of work run by a shared thread, e.g. the read and report of a
+ * sensor on the bus thread, whose CPU time is accounted on its own */
+typedef struct perf_job {
+    struct perf_job *next;
+    const char *name;
+    uint32_t runs;
+    uint64_t time;              /* us */
+} perf_job_t;
+
+/* CPU time of a thread or job since the last reset */
+typedef struct {
+    const char *name;
+    uint64_t active;            /* us */
+    uint32_t runs;              /* wakeups of a thread, runs of a job */
+} perf_entry_t;
+
+void perf_job_register(perf_job_t *job);
+void perf_job_add(perf_job_t *job, uint32_t us);
+
+/* Fill `entries` with the running threads, return their number */
+unsigned perf_get_threads(perf_entry_t *entries, unsigned numof);
+/* Time since the last reset in us */
+uint64_t perf_get_elapsed(void);
+void perf_reset(void);
+
+/* "perf [reset]" shell command */
+int perf_cmd(int argc, char **argv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PERF_H */
@@ -0,0 +1,454 @@
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "irq.h"
+#include "msg.h"
+#include "mutex.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#include "sensor_bus.h"
+#include "metrics.h"
+#include "trace.h"
+#include "tlog.h"
+#ifdef MODULE_NODE_CONFIG
+#include "node_config.h"
+#endif
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+#define SENSOR_BUS_QUEUE_SIZE      (8U)
+#define SENSOR_BUS_MSG_TRIGGER     (0x3801)
+#define SENSOR_BUS_MSG_INTERVAL    (0x3802)
+
+#ifndef SENSOR_BUS_STACKSIZE
+#define SENSOR_BUS_STACKSIZE       (THREAD_STACKSIZE_DEFAULT)
+#endif
+
+static msg_t _sensor_bus_msg_queue[SENSOR_BUS_QUEUE_SIZE];
+static char sensor_bus_stack[SENSOR_BUS_STACKSIZE];
+static kernel_pid_t sensor_bus_pid = KERNEL_PID_UNDEF;
+
+/* The lock is held while the devices are driven, not while their
+ * conversions run. Devices are only added, at the head of the list with
+ * interrupts disabled, and the counters read by other threads are updated
+ * with interrupts disabled so that they are read without the lock. */
+static sensor_bus_dev_t *_devs = NULL;
+static sensor_bus_stats_t _stats;
+static mutex_t _lock = MUTEX_INIT;
+/* in 64 bits: a day of us does not fit in 32 */
+static uint64_t _interval = SENSOR_BUS_INTERVAL;
+
+#ifdef MODULE_NODE_CONFIG
+static uint32_t _config_interval = SENSOR_BUS_INTERVAL / US_PER_SEC;
+
+static void _apply_interval(const node_config_entry_t *entry)
+{
+    (void)entry;
+    sensor_bus_set_interval((uint64_t)_config_interval * US_PER_SEC);
+}
+
+static node_config_entry_t _config = {
+    .name = "report_interval",
+    .type = NODE_CONFIG_UINT,
+    .value = &_config_interval,
+    .min = 1,
+    .max = 24 * 60 * 60,
+    .apply = _apply_interval,
+};
+#endif
+
+/* devices sampled on their own cadence since the last cycle are skipped,
+   polling is only the fallback for them */
+static bool _due(const sensor_bus_dev_t *dev, uint64_t now)
+{
+    return (dev->samples == 0) ||
+           ((now - dev->last_sample) >= sensor_bus_get_interval() / 2);
+}
+
+/* returns the bus time of the starts, and the longest conversion time */
+static uint32_t _start_all(uint32_t *conv_time)
+{
+    uint32_t busy = 0;
+    uint64_t now = xtimer_now_usec64();
+
+    *conv_time = 0;
+
+    for (sensor_bus_dev_t *dev = _devs; dev != NULL; dev = dev->next) {
+        dev->due = _due(dev, now);
+        if (!dev->due) {
+            continue;
+        }
+        if (dev->start) {
+            uint32_t t = xtimer_now_usec();
+            if (dev->start(dev->arg) < 0) {
+                dev->errors++;
+            }
+            busy += xtimer_now_usec() - t;
+            unsigned state = irq_disable();
+            dev->active_time += dev->conv_time;
+            irq_restore(state);
+        }
+        if (dev->conv_time > *conv_time) {
+            *conv_time = dev->conv_time;
+        }
+    }
+
+    return busy;
+}
+
+static uint32_t _read(sensor_bus_dev_t *dev)
+{
+    uint32_t t = xtimer_now_usec();
+    TRACE_BEGIN(SENSOR);
+    dev->ready = (dev->read(dev->arg) == 0);
+    TRACE_END(SENSOR);
+    dev->busy_time = xtimer_now_usec() - t;
+    dev->last_sample = xtimer_now_usec64();
+    unsigned state = irq_disable();
+    dev->active_time += dev->busy_time;
+    dev->samples++;
+    if (!dev->ready) {
+        dev->errors++;
+    }
+    irq_restore(state);
+    if (!dev->ready) {
+        METRICS_INC(SENSOR_ERR);
+    }
+    METRICS_RECORD(SENSOR, dev->busy_time);
+    TLOG("[DEBUG] sensor_bus: %s read in %" PRIu32 "us\n",
+         dev->name, dev->busy_time);
+
+    return dev->busy_time;
+}
+
+static uint32_t _read_all(void)
+{
+    uint32_t busy = 0;
+
+    for (sensor_bus_dev_t *dev = _devs; dev != NULL; dev = dev->next) {
+        if (dev->due) {
+            busy += _read(dev);
+        }
+    }
+
+    return busy;
+}
+
+/* called for every sampled device, ready or not */
+static void _report(sensor_bus_dev_t *dev)
+{
+    uint32_t t = xtimer_now_usec();
+    if (dev->ready && dev->report) {
+        dev->report(dev->arg);
+    }
+#ifdef MODULE_PERF
+    /* a run of the job is a read and its report */
+    perf_job_add(&dev->job, dev->busy_time + (xtimer_now_usec() - t));
+#else
+    (void)t;
+#endif
+}
+
+static void _cycle(void)
+{
+    uint32_t conv_time;
+
+    /* a cycle is traced as one request, from the first start to the last
+       report */
+    TRACE_NEW();
+    TRACE_BEGIN(CYCLE);
+    uint32_t begin = xtimer_now_usec();
+    mutex_lock(&_lock);
+    uint32_t busy = _start_all(&conv_time);
+    mutex_unlock(&_lock);
+
+    /* all conversions run in parallel, wait for the slowest one with the
+       bus free for triggered reads */
+    if (conv_time) {
+        xtimer_usleep(conv_time);
+    }
+
+    mutex_lock(&_lock);
+    busy += _read_all();
+    uint32_t duration = xtimer_now_usec() - begin;
+
+    /* reporting uses the network, not the bus */
+    for (sensor_bus_dev_t *dev = _devs; dev != NULL; dev = dev->next) {
+        if (dev->due) {
+            _report(dev);
+        }
+    }
+    mutex_unlock(&_lock);
+    TRACE_END(CYCLE);
+
+    unsigned state = irq_disable();
+    _stats.cycles++;
+    _stats.busy = busy;
+    _stats.duration = duration;
+    if (busy > _stats.busy_max) {
+        _stats.busy_max = busy;
+    }
+    irq_restore(state);
+    TLOG("[DEBUG] sensor_bus: cycle %" PRIu32 ", busy %" PRIu32
+         "us over %" PRIu32 "us\n", _stats.cycles, busy, duration);
+}
+
+static void _interval_changed(void)
+{
+    uint64_t interval = sensor_bus_get_interval();
+    for (sensor_bus_dev_t *dev = _devs; dev != NULL; dev = dev->next) {
+        if (dev->interval) {
+            dev->interval(dev->arg, interval);
+        }
+    }
+}
+
+/* data ready: the conversion is already done, read and report right away */
+static void _sample(sensor_bus_dev_t *dev)
+{
+#ifdef MODULE_TRACE
+    TRACE_REQUEST(dev->trace_id);
+#endif
+    _read(dev);
+    _report(dev);
+    unsigned state = irq_disable();
+    _stats.triggers++;
+    irq_restore(state);
+}
+
+static void *_sensor_bus_thread(void *args)
+{
+    (void)args;
+    msg_t msg;
+    uint64_t last_cycle = xtimer_now_usec64();
+    uint64_t next_cycle = last_cycle;
+
+    msg_init_queue(_sensor_bus_msg_queue, SENSOR_BUS_QUEUE_SIZE);
+
+    for(;;) {
+        uint64_t now = xtimer_now_usec64();
+        if ((next_cycle > now) &&
+            (xtimer_msg_receive_timeout64(&msg, next_cycle - now) >= 0)) {
+            METRICS_PEAK(BUS_QUEUE, msg_avail() + 1);
+            if (msg.type == SENSOR_BUS_MSG_TRIGGER) {
+                mutex_lock(&_lock);
+                _sample(msg.content.ptr);
+                mutex_unlock(&_lock);
+            }
+            else if (msg.type == SENSOR_BUS_MSG_INTERVAL) {
+                /* the new interval counts from the last cycle */
+                next_cycle = last_cycle + sensor_bus_get_interval();
+                mutex_lock(&_lock);
+                _interval_changed();
+                mutex_unlock(&_lock);
+            }
+            continue;
+        }
+
+        _cycle();
+
+        uint64_t interval = sensor_bus_get_interval();
+        last_cycle = next_cycle;
+        next_cycle += interval;
+        if (next_cycle < xtimer_now_usec64()) {
+            /* do not catch up on missed cycles */
+            last_cycle = xtimer_now_usec64();
+            next_cycle = last_cycle + interval;
+        }
+    }
+
+    return NULL;
+}
+
+static void _notify_interval(void)
+{
+    msg_t msg;
+    msg.type = SENSOR_BUS_MSG_INTERVAL;
+    if (sensor_bus_pid != KERNEL_PID_UNDEF) {
+        msg_try_send(&msg, sensor_bus_pid);
+    }
+}
+
+void sensor_bus_register(sensor_bus_dev_t *dev)
+{
+    dev->ready = false;
+    dev->due = false;
+    dev->busy_time = 0;
+    dev->last_sample = 0;
+    dev->samples = 0;
+    dev->errors = 0;
+    dev->active_time = 0;
+    dev->since = xtimer_now_usec64();
+#ifdef MODULE_PERF
+    dev->job.name = dev->name;
+    perf_job_register(&dev->job);
+#endif
+
+#ifdef MODULE_NODE_CONFIG
+    /* the persisted interval is applied by the first registration */
+    if (sensor_bus_pid == KERNEL_PID_UNDEF) {
+        node_config_register(&_config);
+    }
+#endif
+    /* the bus does not drive the device before it is on the list */
+    uint64_t interval = sensor_bus_get_interval();
+    if (dev->interval) {
+        dev->interval(dev->arg, interval);
+    }
+
+    unsigned state = irq_disable();
+    dev->next = _devs;
+    _devs = dev;
+    irq_restore(state);
+
+    if (dev->interval && (sensor_bus_get_interval() != interval)) {
+        /* changed in between, the bus thread did not see the device */
+        _notify_interval();
+    }
+
+    if (sensor_bus_pid != KERNEL_PID_UNDEF) {
+        return;
+    }
+
+    /* a single thread samples every device on the bus */
+    sensor_bus_pid = thread_create(sensor_bus_stack, sizeof(sensor_bus_stack),
+                                   THREAD_PRIORITY_MAIN - 1,
+                                   THREAD_CREATE_STACKTEST, _sensor_bus_thread,
+                                   NULL, "sensor bus thread");
+    if (sensor_bus_pid == -EINVAL || sensor_bus_pid == -EOVERFLOW) {
+        puts("Error: failed to create sensor bus thread, exiting\n");
+        sensor_bus_pid = KERNEL_PID_UNDEF;
+    }
+    else {
+        puts("Successfuly created sensor bus thread !\n");
+    }
+}
+
+void sensor_bus_trigger(sensor_bus_dev_t *dev)
+{
+    msg_t msg;
+    msg.type = SENSOR_BUS_MSG_TRIGGER;
+    msg.content.ptr = dev;
+#ifdef MODULE_TRACE
+    dev->trace_id = trace_new_request();
+    TRACE_INSTANT_FOR(ENQUEUE, dev->trace_id);
+#endif
+
+    /* a full queue is not an error, the next cycle polls the device */
+    if (irq_is_in()) {
+        msg_send_int(&msg, sensor_bus_pid);
+    }
+    else {
+        msg_try_send(&msg, sensor_bus_pid);
+    }
+}
+
+void sensor_bus_lock(void)
+{
+    mutex_lock(&_lock);
+}
+
+void sensor_bus_unlock(void)
+{
+    mutex_unlock(&_lock);
+}
+
+void sensor_bus_set_interval(uint64_t interval)
+{
+    /* not atomic on 32 bit platforms */
+    unsigned state = irq_disable();
+    _interval = interval;
+    irq_restore(state);
+
+    _notify_interval();
+}
+
+uint64_t sensor_bus_get_interval(void)
+{
+    unsigned state = irq_disable();
+    uint64_t interval = _interval;
+    irq_restore(state);
+    return interval;
+}
+
+void sensor_bus_get_stats(sensor_bus_stats_t *stats)
+{
+    unsigned state = irq_disable();
+    *stats = _stats;
+    irq_restore(state);
+}
+
+const sensor_bus_dev_t *sensor_bus_iter(const sensor_bus_dev_t *prev)
+{
+    return (prev == NULL) ? _devs : prev->next;
+}
+
+uint32_t sensor_bus_avg_current(const sensor_bus_dev_t *dev)
+{
+    uint64_t total = xtimer_now_usec64() - dev->since;
+    if (total == 0) {
+        return dev->idle_ua;
+    }
+    unsigned state = irq_disable();
+    uint64_t active = dev->active_time;
+    irq_restore(state);
+    if (active > total) {
+        active = total;
+    }
+
+    return (uint32_t)((active * dev->active_ua +
+                       (total - active) * dev->idle_ua) / total);
+}
+
+void sensor_bus_get_usage(uint32_t *conversions, uint64_t *charge)
+{
+    uint64_t now = xtimer_now_usec64();
+    *conversions = 0;
+    *charge = 0;
+
+    for (sensor_bus_dev_t *dev = _devs; dev != NULL; dev = dev->next) {
+        unsigned state = irq_disable();
+        uint64_t active = dev->active_time;
+        uint32_t samples = dev->samples;
+        irq_restore(state);
+
+        uint64_t total = now - dev->since;
+        if (active > total) {
+            active = total;
+        }
+        *conversions += samples;
+        *charge += active * dev->active_ua + (total - active) * dev->idle_ua;
+    }
+}
+
+int sensor_bus_cmd(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+    sensor_bus_stats_t stats;
+    sensor_bus_get_stats(&stats);
+
+    printf("interval: %" PRIu32 " ms\n",
+           (uint32_t)(sensor_bus_get_interval() / US_PER_MS));
+    printf("cycles: %" PRIu32 ", triggered reads: %" PRIu32 "\n",
+           stats.cycles, stats.triggers);
+    printf("last cycle: busy %" PRIu32 " us over %" PRIu32 " us, "
+           "busy max %" PRIu32 " us\n",
+           stats.busy, stats.duration, stats.busy_max);
+    printf("%-12s %8s %6s %12s\n", "device", "reads", "errors", "last read us");
+    for (sensor_bus_dev_t *dev = _devs; dev != NULL; dev = dev->next) {
+        unsigned state = irq_disable();
+        uint32_t samples = dev->samples;
+        unsigned errors = dev->errors;
+        uint32_t busy_time = dev->busy_time;
+        irq_restore(state);
+        printf("%-12s %8" PRIu32 " %6u %12" PRIu32 "\n",
+               dev->name, samples, errors, busy_time);
+    }
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+#ifndef SENSOR_BUS_H
+#define SENSOR_BUS_H
+
+#include <stdbool.h>
+#include <inttypes.h>
+
+#ifdef MODULE_PERF
+#include "perf.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef SENSOR_BUS_INTERVAL
+#define SENSOR_BUS_INTERVAL    (5000000UL)    /* default sampling cycle in us */
+#endif
+
+/* A device sampled by the bus scheduler. Each cycle the scheduler:
+ * - calls `start` on every device to trigger its conversion
+ * - sleeps for the longest `conv_time`
+ * - calls `read` on every device, it must fetch all channels at once
+ * - calls `report` on every device whose read succeeded, off the bus
+ * Devices with a data ready signal call sensor_bus_trigger() instead, they
+ * are read and reported at once and skipped by the cycles in between. */
+typedef struct sensor_bus_dev {
+    struct sensor_bus_dev *next;
+    const char *name;
+    uint32_t conv_time;                 /* us between start and read */
+    int (*start)(void *arg);            /* optional */
+    int (*read)(void *arg);
+    void (*report)(void *arg);          /* optional */
+    /* optional, called at registration and then on the bus thread whenever
+       the sampling cycle changes, e.g. to adapt the sensor cadence */
+    void (*interval)(void *arg, uint64_t interval);
+    void *arg;
+    bool ready;                         /* last read succeeded */
+    bool due;                           /* sampled by the current cycle */
+    uint32_t busy_time;                 /* bus time of the last read in us */
+    uint64_t last_sample;               /* time of the last read in us */
+    uint32_t samples;
+    unsigned errors;
+    uint32_t active_ua;                 /* typical supply current while sampling */
+    uint32_t idle_ua;                   /* typical supply current in between */
+    uint64_t active_time;               /* total sampling time in us */
+    uint64_t since;                     /* registration time in us */
+#ifdef MODULE_PERF
+    perf_job_t job;                     /* CPU time of the reads and reports */
+#endif
+#ifdef MODULE_TRACE
+    uint32_t trace_id;                  /* request of the pending trigger */
+#endif
+} sensor_bus_dev_t;
+
+typedef struct {
+    uint32_t cycles;
+    uint32_t triggers;                  /* reads started by sensor_bus_trigger */
+    uint32_t busy;                      /* bus busy time of the last cycle in us */
+    uint32_t busy_max;                  /* worst bus busy time in us */
+    uint32_t duration;                  /* last cycle from first start to last read in us */
+} sensor_bus_stats_t;
+
+void sensor_bus_register(sensor_bus_dev_t *dev);
+
+/* Request an immediate read, safe to call from interrupt context */
+void sensor_bus_trigger(sensor_bus_dev_t *dev);
+
+/* Exclusive access to the devices outside of the bus thread, e.g. for the
+ * reads of the CoAP handlers and bursts. Not held during the conversion
+ * waits of the cycles. */
+void sensor_bus_lock(void);
+void sensor_bus_unlock(void);
+
+/* Changes the sampling cycle in us, the next cycle follows the new one */
+void sensor_bus_set_interval(uint64_t interval);
+uint64_t sensor_bus_get_interval(void);
+
+/* Counters of the cycles, read without waiting for the bus */
+void sensor_bus_get_stats(sensor_bus_stats_t *stats);
+
+/* Returns the registered device after prev, the first one for NULL */
+const sensor_bus_dev_t *sensor_bus_iter(const sensor_bus_dev_t *prev);
+
+/* Average supply current of a device since registration in uA, from the
+ * time spent sampling and idle and the typical current of each mode */
+uint32_t sensor_bus_avg_current(const sensor_bus_dev_t *dev);
+
+/* Totals of all devices since registration: number of reads and charge
+ * drawn in uA.us, from the same time split and typical currents */
+void sensor_bus_get_usage(uint32_t *conversions, uint64_t *charge);
+
+/* "bus" shell command: cycle counts, bus busy time and reads per device */
+int sensor_bus_cmd(int argc, char **argv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SENSOR_BUS_H */
@@ -0,0 +1,184 @@
+#include <inttypes.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+
+#include "sensor_filter.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+static sensor_filter_stage_t *_new_stage(sensor_filter_t *filter,
+                                         sensor_filter_type_t type)
+{
+    if (filter->numof >= SENSOR_FILTER_STAGES_MAX) {
+        DEBUG("[ERROR] filter: no stage left\n");
+        return NULL;
+    }
+
+    sensor_filter_stage_t *stage = &filter->stages[filter->numof++];
+    memset(stage, 0, sizeof(*stage));
+    stage->type = type;
+    return stage;
+}
+
+static int32_t _median(sensor_filter_stage_t *stage, int32_t x)
+{
+    int32_t sorted[SENSOR_FILTER_MEDIAN_MAX];
+
+    stage->median.buf[stage->median.pos] = x;
+    stage->median.pos = (stage->median.pos + 1) % stage->median.size;
+    if (stage->median.len < stage->median.size) {
+        stage->median.len++;
+    }
+
+    /* insertion sort, the window is small */
+    for (uint8_t i = 0; i < stage->median.len; i++) {
+        int32_t v = stage->median.buf[i];
+        int8_t j = i - 1;
+        while ((j >= 0) && (sorted[j] > v)) {
+            sorted[j + 1] = sorted[j];
+            j--;
+        }
+        sorted[j + 1] = v;
+    }
+
+    return sorted[(stage->median.len - 1) / 2];
+}
+
+static int32_t _ema(sensor_filter_stage_t *stage, int32_t x)
+{
+    uint8_t shift = stage->ema.shift;
+
+    if (!stage->primed) {
+        stage->ema.acc = (int64_t)x * (1L << shift);
+        stage->primed = true;
+        return x;
+    }
+
+    int32_t round = (shift) ? (1L << (shift - 1)) : 0;
+    stage->ema.acc += x - ((stage->ema.acc + round) >> shift);
+    return (int32_t)((stage->ema.acc + round) >> shift);
+}
+
+static int32_t _iir(sensor_filter_stage_t *stage, int32_t x)
+{
+    if (!stage->primed) {
+        stage->iir.x1 = x;
+        stage->iir.y1 = x;
+        stage->primed = true;
+    }
+
+    int64_t acc = (int64_t)stage->iir.b0 * x
+                + (int64_t)stage->iir.b1 * stage->iir.x1
+                - (int64_t)stage->iir.a1 * stage->iir.y1;
+    int32_t y = (int32_t)((acc + (1L << 14)) >> 15);
+
+    stage->iir.x1 = x;
+    stage->iir.y1 = y;
+    return y;
+}
+
+void sensor_filter_init(sensor_filter_t *filter)
+{
+    memset(filter, 0, sizeof(*filter));
+}
+
+void sensor_filter_reset(sensor_filter_t *filter)
+{
+    for (uint8_t i = 0; i < filter->numof; i++) {
+        sensor_filter_stage_t *stage = &filter->stages[i];
+        stage->primed = false;
+        if (stage->type == SENSOR_FILTER_MEDIAN) {
+            stage->median.len = 0;
+            stage->median.pos = 0;
+        }
+    }
+    filter->valid = false;
+}
+
+int sensor_filter_add_median(sensor_filter_t *filter, uint8_t size)
+{
+    if ((size == 0) || (size > SENSOR_FILTER_MEDIAN_MAX)) {
+        return -EINVAL;
+    }
+
+    sensor_filter_stage_t *stage = _new_stage(filter, SENSOR_FILTER_MEDIAN);
+    if (stage == NULL) {
+        return -ENOMEM;
+    }
+    stage->median.size = size;
+    return 0;
+}
+
+int sensor_filter_add_ema(sensor_filter_t *filter, uint8_t shift)
+{
+    if (shift > 15) {
+        return -EINVAL;
+    }
+
+    sensor_filter_stage_t *stage = _new_stage(filter, SENSOR_FILTER_EMA);
+    if (stage == NULL) {
+        return -ENOMEM;
+    }
+    stage->ema.shift = shift;
+    return 0;
+}
+
+int sensor_filter_add_iir(sensor_filter_t *filter,
+                          int16_t b0, int16_t b1, int16_t a1)
+{
+    sensor_filter_stage_t *stage = _new_stage(filter, SENSOR_FILTER_IIR);
+    if (stage == NULL) {
+        return -ENOMEM;
+    }
+    stage->iir.b0 = b0;
+    stage->iir.b1 = b1;
+    stage->iir.a1 = a1;
+    return 0;
+}
+
+void sensor_filter_setup(sensor_filter_t *filter,
+                         uint8_t median_size, uint8_t ema_shift)
+{
+    sensor_filter_init(filter);
+    if (median_size > 1) {
+        sensor_filter_add_median(filter, median_size);
+    }
+    if (ema_shift > 0) {
+        sensor_filter_add_ema(filter, ema_shift);
+    }
+}
+
+int32_t sensor_filter_update(sensor_filter_t *filter, int32_t sample)
+{
+    int32_t value = sample;
+
+    for (uint8_t i = 0; i < filter->numof; i++) {
+        sensor_filter_stage_t *stage = &filter->stages[i];
+        switch (stage->type) {
+        case SENSOR_FILTER_MEDIAN:
+            value = _median(stage, value);
+            break;
+        case SENSOR_FILTER_EMA:
+            value = _ema(stage, value);
+            break;
+        case SENSOR_FILTER_IIR:
+            value = _iir(stage, value);
+            break;
+        }
+    }
+
+    filter->value = value;
+    filter->valid = true;
+    return value;
+}
+
+bool sensor_filter_get(const sensor_filter_t *filter, int32_t *value)
+{
+    if (!filter->valid) {
+        return false;
+    }
+    *value = filter->value;
+    return true;
+}
@@ -0,0 +1,82 @@
+#ifndef SENSOR_FILTER_H
+#define SENSOR_FILTER_H
+
+#include <stdbool.h>
+#include <inttypes.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef SENSOR_FILTER_STAGES_MAX
+#define SENSOR_FILTER_STAGES_MAX    (3U)    /* max number of stages per series */
+#endif
+
+#ifndef SENSOR_FILTER_MEDIAN_MAX
+#define SENSOR_FILTER_MEDIAN_MAX    (7U)    /* max median window size */
+#endif
+
+#define SENSOR_FILTER_Q15_ONE       (32767)
+
+typedef enum {
+    SENSOR_FILTER_MEDIAN,
+    SENSOR_FILTER_EMA,
+    SENSOR_FILTER_IIR,
+} sensor_filter_type_t;
+
+/* A single stage of a filter chain. All arithmetic is integer only:
+ * - median: median of the last `size` samples
+ * - ema: y += (x - y) / 2^shift, kept with `shift` fractional bits
+ * - iir: y = b0 * x + b1 * x[n-1] - a1 * y[n-1], Q15 coefficients */
+typedef struct {
+    sensor_filter_type_t type;
+    bool primed;
+    union {
+        struct {
+            int32_t buf[SENSOR_FILTER_MEDIAN_MAX];
+            uint8_t size;
+            uint8_t len;
+            uint8_t pos;
+        } median;
+        struct {
+            int64_t acc;        /* x * 2^15 does not fit in 32 bits */
+            uint8_t shift;
+        } ema;
+        struct {
+            int32_t x1;
+            int32_t y1;
+            int16_t b0;
+            int16_t b1;
+            int16_t a1;
+        } iir;
+    };
+} sensor_filter_stage_t;
+
+/* Per-series filter chain, stages are applied in the order they are added */
+typedef struct {
+    sensor_filter_stage_t stages[SENSOR_FILTER_STAGES_MAX];
+    uint8_t numof;
+    bool valid;
+    int32_t value;
+} sensor_filter_t;
+
+void sensor_filter_init(sensor_filter_t *filter);
+void sensor_filter_reset(sensor_filter_t *filter);
+
+int sensor_filter_add_median(sensor_filter_t *filter, uint8_t size);
+int sensor_filter_add_ema(sensor_filter_t *filter, uint8_t shift);
+int sensor_filter_add_iir(sensor_filter_t *filter,
+                          int16_t b0, int16_t b1, int16_t a1);
+
+/* Convenience setup for the common median + EMA chain, 0 disables a stage */
+void sensor_filter_setup(sensor_filter_t *filter,
+                         uint8_t median_size, uint8_t ema_shift);
+
+int32_t sensor_filter_update(sensor_filter_t *filter, int32_t sample);
+bool sensor_filter_get(const sensor_filter_t *filter, int32_t *value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SENSOR_FILTER_H */
@@ -0,0 +1,84 @@
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "cpu.h"
+#include "sched.h"
+#include "thread.h"
+
+#include "stack_usage.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+#define STACK_USAGE_NUMOF       (MAXTHREADS + 1)    /* threads and ISR stack */
+
+unsigned stack_usage_get(stack_usage_t *usage, unsigned numof)
+{
+    unsigned n = 0;
+
+    for (kernel_pid_t pid = KERNEL_PID_FIRST;
+         (pid <= KERNEL_PID_LAST) && (n < numof); pid++) {
+        volatile thread_t *thread = thread_get(pid);
+        if (thread == NULL) {
+            continue;
+        }
+        /* the markers are only written below the initial stack frame */
+        size_t unused = thread_measure_stack_free(thread->stack_start);
+        usage[n].pid = pid;
+        usage[n].name = thread->name;
+        usage[n].size = thread->stack_size;
+        usage[n].used = (unused < usage[n].size) ? usage[n].size - unused : 0;
+        n++;
+    }
+
+#ifdef ISR_STACKSIZE
+    if (n < numof) {
+        usage[n].pid = KERNEL_PID_UNDEF;
+        usage[n].name = "isr";
+        usage[n].size = ISR_STACKSIZE;
+        usage[n].used = thread_isr_stack_usage();
+        n++;
+    }
+#endif
+
+    return n;
+}
+
+int stack_usage_format(char *buf, size_t len)
+{
+    stack_usage_t usage[STACK_USAGE_NUMOF];
+    unsigned numof = stack_usage_get(usage, STACK_USAGE_NUMOF);
+    size_t pos = 0;
+
+    for (unsigned i = 0; i < numof; i++) {
+        int n = snprintf(&buf[pos], len - pos, "%s%s:%u/%u",
+                         (i) ? "\n" : "", usage[i].name,
+                         (unsigned)usage[i].used, (unsigned)usage[i].size);
+        if ((n < 0) || ((size_t)n >= len - pos)) {
+            return -ENOSPC;
+        }
+        pos += n;
+    }
+
+    return pos;
+}
+
+int stack_usage_cmd(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+    stack_usage_t usage[STACK_USAGE_NUMOF];
+    unsigned numof = stack_usage_get(usage, STACK_USAGE_NUMOF);
+
+    puts("pid | name                 |  size |  used | peak");
+    for (unsigned i = 0; i < numof; i++) {
+        printf("%3d | %-20s | %5u | %5u | %3u%%\n",
+               (int)usage[i].pid, usage[i].name,
+               (unsigned)usage[i].size, (unsigned)usage[i].used,
+               (unsigned)((usage[i].size) ? (usage[i].used * 100) / usage[i].size : 0));
+    }
+
+    return 0;
+}
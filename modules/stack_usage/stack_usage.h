@@ -0,0 +1,41 @@
+#ifndef STACK_USAGE_H
+#define STACK_USAGE_H
+
+#include <inttypes.h>
+#include <stdlib.h>
+
+#include "kernel_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define STACK_USAGE_URI         "/stacks"
+
+/* Stack high-water mark of a thread, measured from the markers written at
+ * creation (THREAD_CREATE_STACKTEST), so `used` is the peak since boot */
+typedef struct {
+    kernel_pid_t pid;           /* KERNEL_PID_UNDEF for the ISR stack */
+    const char *name;
+    size_t size;
+    size_t used;
+} stack_usage_t;
+
+/* Fills `usage` with the running threads then the ISR stack, returns the
+ * number of entries */
+unsigned stack_usage_get(stack_usage_t *usage, unsigned numof);
+
+/* "name:used/size" lines, returns the length or -ENOSPC */
+int stack_usage_format(char *buf, size_t len);
+
+/* Registers /stacks */
+void init_stack_usage_handler(void);
+
+/* "stacks" shell command */
+int stack_usage_cmd(int argc, char **argv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STACK_USAGE_H */
@@ -0,0 +1,45 @@
+#ifdef MODULE_GCOAP
+
+#include <inttypes.h>
+#include <string.h>
+
+#include "net/gcoap.h"
+
+#include "stack_usage.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+static ssize_t _stacks_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx);
+
+static const coap_resource_t _resources[] = {
+    { STACK_USAGE_URI, COAP_GET, _stacks_handler, NULL },
+};
+
+static gcoap_listener_t _listener = {
+    (coap_resource_t *)&_resources[0],
+    sizeof(_resources) / sizeof(_resources[0]),
+    NULL
+};
+
+static ssize_t _stacks_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx)
+{
+    (void)ctx;
+    gcoap_resp_init(pdu, buf, len, COAP_CODE_CONTENT);
+    int n = stack_usage_format((char*)pdu->payload, pdu->payload_len);
+    if (n < 0) {
+        return coap_reply_simple(pdu, COAP_CODE_INTERNAL_SERVER_ERROR, buf, len,
+                                 COAP_FORMAT_TEXT, NULL, 0);
+    }
+
+    return gcoap_finish(pdu, n, COAP_FORMAT_TEXT);
+}
+
+void init_stack_usage_handler(void)
+{
+    gcoap_register_listener(&_listener);
+}
+
+#else
+typedef int dont_be_pedantic;
+#endif /* MODULE_GCOAP */
@@ -0,0 +1,133 @@
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "mutex.h"
+
+#include "telemetry.h"
+#include "metrics.h"
+#include "trace.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+#ifdef MODULE_TELEMETRY_COAP
+extern telemetry_sink_t telemetry_coap_sink;
+#endif
+#ifdef MODULE_TELEMETRY_OBSERVE
+extern telemetry_sink_t telemetry_observe_sink;
+#endif
+#ifdef MODULE_TELEMETRY_MQTT
+extern telemetry_sink_t telemetry_mqtt_sink;
+extern void telemetry_mqtt_init(void);
+#endif
+#ifdef MODULE_TELEMETRY_LOG
+extern telemetry_sink_t telemetry_log_sink;
+#endif
+
+static telemetry_sink_t *_sinks = NULL;
+static bool _initialized = false;
+/* sinks share their buffers between samples of different modules */
+static mutex_t _lock = MUTEX_INIT;
+
+void telemetry_init(void)
+{
+    if (_initialized) {
+        return;
+    }
+    _initialized = true;
+
+#ifdef MODULE_TELEMETRY_COAP
+    telemetry_register_sink(&telemetry_coap_sink);
+#endif
+#ifdef MODULE_TELEMETRY_OBSERVE
+    telemetry_register_sink(&telemetry_observe_sink);
+#endif
+#ifdef MODULE_TELEMETRY_MQTT
+    telemetry_mqtt_init();
+    telemetry_register_sink(&telemetry_mqtt_sink);
+#endif
+#ifdef MODULE_TELEMETRY_LOG
+    telemetry_register_sink(&telemetry_log_sink);
+#endif
+}
+
+void telemetry_register_sink(telemetry_sink_t *sink)
+{
+    mutex_lock(&_lock);
+    sink->next = _sinks;
+    _sinks = sink;
+    mutex_unlock(&_lock);
+    DEBUG("[DEBUG] telemetry: sink %s registered\n", sink->name);
+}
+
+void telemetry_publish(const telemetry_sample_t *sample)
+{
+    mutex_lock(&_lock);
+    for (telemetry_sink_t *sink = _sinks; sink != NULL; sink = sink->next) {
+        sink->publish(sample);
+    }
+    mutex_unlock(&_lock);
+}
+
+void telemetry_flush(void)
+{
+    mutex_lock(&_lock);
+    for (telemetry_sink_t *sink = _sinks; sink != NULL; sink = sink->next) {
+        if (sink->flush) {
+            sink->flush();
+        }
+    }
+    mutex_unlock(&_lock);
+}
+
+static size_t _format(char *buf, const telemetry_sample_t *sample)
+{
+    const char *unit = (sample->unit) ? sample->unit : "";
+
+    if (sample->str) {
+        return snprintf(buf, TELEMETRY_VALUE_MAX + 1, "%s%s", sample->str, unit);
+    }
+
+    int32_t v = sample->value;
+    if (sample->scale >= 0) {
+        for (int i = 0; i < sample->scale; i++) {
+            v *= 10;
+        }
+        return snprintf(buf, TELEMETRY_VALUE_MAX + 1, "%" PRIi32 "%s", v, unit);
+    }
+
+    /* the decimals beyond `digits` are truncated */
+    int32_t div = 1;
+    for (int i = 0; i < -sample->scale; i++) {
+        div *= 10;
+    }
+    int digits = (sample->digits < -sample->scale) ? sample->digits
+                                                   : -sample->scale;
+    int32_t frac_div = div;
+    for (int i = 0; i < digits; i++) {
+        frac_div /= 10;
+    }
+    bool negative = (v < 0);
+    if (negative) {
+        v = -v;
+    }
+    if (digits == 0) {
+        return snprintf(buf, TELEMETRY_VALUE_MAX + 1, "%s%" PRIi32 "%s",
+                        (negative) ? "-" : "", v / div, unit);
+    }
+    return snprintf(buf, TELEMETRY_VALUE_MAX + 1, "%s%" PRIi32 ".%0*" PRIi32 "%s",
+                    (negative) ? "-" : "", v / div, digits,
+                    (v % div) / frac_div, unit);
+}
+
+size_t telemetry_format(char *buf, const telemetry_sample_t *sample)
+{
+    METRICS_START(t);
+    TRACE_BEGIN(ENCODE);
+    size_t len = _format(buf, sample);
+    TRACE_END(ENCODE);
+    METRICS_STOP(ENCODE, t);
+    return len;
+}
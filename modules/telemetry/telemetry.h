@@ -0,0 +1,65 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <inttypes.h>
+#include <limits.h>
+#include <stdlib.h>
+
+#ifdef MODULE_TELEMETRY_OBSERVE
+#include "net/gcoap.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TELEMETRY_NO_INDEX      (UINT_MAX)  /* single instance, name is unique */
+#define TELEMETRY_VALUE_MAX     (24U)       /* max length of a formatted value */
+
+/* A value published by a sensor module. Numbers are value * 10^scale in
+ * `unit` and keep `digits` decimals once formatted, e.g. 2345, -2, 1, "°C"
+ * gives "23.4°C". Text values set `str` instead. */
+typedef struct {
+    const char *name;           /* resource name, e.g. "temperature" */
+    unsigned idx;               /* instance or TELEMETRY_NO_INDEX */
+    int32_t value;
+    int8_t scale;
+    uint8_t digits;
+    const char *unit;
+    const char *str;            /* text value, NULL for numbers */
+} telemetry_sample_t;
+
+/* A consumer of the samples. Samples of one report are published one after
+ * the other and followed by a flush, sinks are never called concurrently. */
+typedef struct telemetry_sink {
+    struct telemetry_sink *next;
+    const char *name;
+    void (*publish)(const telemetry_sample_t *sample);
+    void (*flush)(void);        /* optional, end of a report */
+} telemetry_sink_t;
+
+/* Registers the sinks selected at build time (telemetry_coap,
+ * telemetry_observe, telemetry_mqtt, telemetry_log), can be called by
+ * every sensor module */
+void telemetry_init(void);
+
+void telemetry_register_sink(telemetry_sink_t *sink);
+
+void telemetry_publish(const telemetry_sample_t *sample);
+void telemetry_flush(void);
+
+/* Writes the value and its unit, at most TELEMETRY_VALUE_MAX bytes plus the
+ * terminating null byte */
+size_t telemetry_format(char *buf, const telemetry_sample_t *sample);
+
+#ifdef MODULE_TELEMETRY_OBSERVE
+/* Resources of the listener named after a sample ("/name" or "/name/index")
+ * notify their observers of each new value */
+void telemetry_observe_listener(const gcoap_listener_t *listener);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TELEMETRY_H */
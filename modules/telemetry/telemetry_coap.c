@@ -0,0 +1,35 @@
+#ifdef MODULE_TELEMETRY_COAP
+
+#include <inttypes.h>
+
+#include "coap_utils.h"
+#include "telemetry.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+/* pushes "<name>:<value>" to the broker, values of indexed instances are
+   batched until the end of the report */
+static coap_batch_t batch;
+
+static void _publish(const telemetry_sample_t *sample)
+{
+    batch.numof = (sample->idx == TELEMETRY_NO_INDEX) ? 1 : 2;
+    char *out = coap_batch_key(&batch, sample->name, sample->idx);
+    coap_batch_add(&batch, telemetry_format(out, sample));
+}
+
+static void _flush(void)
+{
+    coap_batch_send(&batch);
+}
+
+telemetry_sink_t telemetry_coap_sink = {
+    .name = "coap",
+    .publish = _publish,
+    .flush = _flush,
+};
+
+#else
+typedef int dont_be_pedantic;
+#endif /* MODULE_TELEMETRY_COAP */
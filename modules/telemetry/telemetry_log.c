@@ -0,0 +1,26 @@
+#ifdef MODULE_TELEMETRY_LOG
+
+#include <stdio.h>
+
+#include "telemetry.h"
+
+static void _publish(const telemetry_sample_t *sample)
+{
+    char value[TELEMETRY_VALUE_MAX + 1];
+    telemetry_format(value, sample);
+    if (sample->idx == TELEMETRY_NO_INDEX) {
+        printf("[telemetry] %s: %s\n", sample->name, value);
+    }
+    else {
+        printf("[telemetry] %s/%u: %s\n", sample->name, sample->idx, value);
+    }
+}
+
+telemetry_sink_t telemetry_log_sink = {
+    .name = "log",
+    .publish = _publish,
+};
+
+#else
+typedef int dont_be_pedantic;
+#endif /* MODULE_TELEMETRY_LOG */
@@ -0,0 +1,89 @@
+#ifdef MODULE_TELEMETRY_MQTT
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "net/emcute.h"
+
+#include "mqtt_utils.h"
+#include "telemetry.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+#ifndef TELEMETRY_MQTT_TOPICS
+#define TELEMETRY_MQTT_TOPICS       (8U)    /* topics registered at most */
+#endif
+#define TELEMETRY_MQTT_TOPIC_LEN    (48U)
+
+/* topics are built and registered once, on the first value */
+typedef struct {
+    char name[TELEMETRY_MQTT_TOPIC_LEN];
+    emcute_topic_t topic;
+} telemetry_mqtt_topic_t;
+
+static telemetry_mqtt_topic_t _topics[TELEMETRY_MQTT_TOPICS];
+static unsigned _topics_numof = 0;
+static char payload[TELEMETRY_VALUE_MAX + 16];
+
+static emcute_topic_t *_topic(const telemetry_sample_t *sample)
+{
+    char name[TELEMETRY_MQTT_TOPIC_LEN];
+    if (sample->idx == TELEMETRY_NO_INDEX) {
+        snprintf(name, sizeof(name), MQTT_TOPIC("%s"), sample->name);
+    }
+    else {
+        snprintf(name, sizeof(name), MQTT_TOPIC("%s/%u"),
+                 sample->name, sample->idx);
+    }
+
+    for (unsigned i = 0; i < _topics_numof; i++) {
+        if (strcmp(_topics[i].name, name) == 0) {
+            return &_topics[i].topic;
+        }
+    }
+    if (_topics_numof == TELEMETRY_MQTT_TOPICS) {
+        DEBUG("[ERROR] telemetry: no topic left for %s\n", name);
+        return NULL;
+    }
+    telemetry_mqtt_topic_t *t = &_topics[_topics_numof++];
+    strcpy(t->name, name);
+    t->topic.name = t->name;
+    t->topic.id = 0;
+    return &t->topic;
+}
+
+/* CoAP firmwares have no MQTT-SN client of their own: the sink starts
+   emcute and connects to the gateway, samples are dropped while it is not
+   connected */
+void telemetry_mqtt_init(void)
+{
+    if (mqtt_utils_connect() < 0) {
+        DEBUG("[ERROR] telemetry: no MQTT-SN gateway\n");
+    }
+}
+
+static void _publish(const telemetry_sample_t *sample)
+{
+    if (!mqtt_utils_connected()) {
+        return;
+    }
+    emcute_topic_t *topic = _topic(sample);
+    if (topic == NULL) {
+        return;
+    }
+    size_t p = sprintf(payload, "{\"value\":\"");
+    p += telemetry_format(&payload[p], sample);
+    sprintf(&payload[p], "\"}");
+    publish_topic(topic, payload);
+}
+
+telemetry_sink_t telemetry_mqtt_sink = {
+    .name = "mqtt",
+    .publish = _publish,
+};
+
+#else
+typedef int dont_be_pedantic;
+#endif /* MODULE_TELEMETRY_MQTT */
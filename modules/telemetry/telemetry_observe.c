@@ -0,0 +1,78 @@
+#ifdef MODULE_TELEMETRY_OBSERVE
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "net/gcoap.h"
+
+#include "telemetry.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+#ifndef TELEMETRY_OBSERVE_LISTENERS
+#define TELEMETRY_OBSERVE_LISTENERS     (4U)
+#endif
+#define TELEMETRY_OBSERVE_PATH_LEN      (32U)
+
+static const gcoap_listener_t *_listeners[TELEMETRY_OBSERVE_LISTENERS];
+static unsigned _listeners_numof = 0;
+static uint8_t buf[GCOAP_PDU_BUF_SIZE];
+
+void telemetry_observe_listener(const gcoap_listener_t *listener)
+{
+    if (_listeners_numof < TELEMETRY_OBSERVE_LISTENERS) {
+        _listeners[_listeners_numof++] = listener;
+    }
+}
+
+static void _notify(const coap_resource_t *resource,
+                    const telemetry_sample_t *sample)
+{
+    coap_pkt_t pdu;
+    if (gcoap_obs_init(&pdu, buf, sizeof(buf), resource) != GCOAP_OBS_INIT_OK) {
+        /* nobody observes it */
+        return;
+    }
+    size_t len = telemetry_format((char*)pdu.payload, sample);
+    gcoap_obs_send(buf, gcoap_finish(&pdu, len, COAP_FORMAT_TEXT), resource);
+    DEBUG("[DEBUG] telemetry: notified %s\n", resource->path);
+}
+
+static void _publish(const telemetry_sample_t *sample)
+{
+    char path[TELEMETRY_OBSERVE_PATH_LEN];
+    char plain[TELEMETRY_OBSERVE_PATH_LEN];
+
+    /* the plain resource also serves the first instance */
+    snprintf(plain, sizeof(plain), "/%s", sample->name);
+    if (sample->idx == TELEMETRY_NO_INDEX) {
+        path[0] = '\0';
+    }
+    else {
+        snprintf(path, sizeof(path), "/%s/%u", sample->name, sample->idx);
+    }
+    bool first = (sample->idx == TELEMETRY_NO_INDEX) || (sample->idx == 0);
+
+    for (unsigned i = 0; i < _listeners_numof; i++) {
+        const gcoap_listener_t *listener = _listeners[i];
+        for (size_t j = 0; j < listener->resources_len; j++) {
+            const coap_resource_t *resource = &listener->resources[j];
+            if ((first && (strcmp(resource->path, plain) == 0)) ||
+                (strcmp(resource->path, path) == 0)) {
+                _notify(resource, sample);
+            }
+        }
+    }
+}
+
+telemetry_sink_t telemetry_observe_sink = {
+    .name = "observe",
+    .publish = _publish,
+};
+
+#else
+typedef int dont_be_pedantic;
+#endif /* MODULE_TELEMETRY_OBSERVE */
@@ -0,0 +1,110 @@
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "irq.h"
+#include "ringbuffer.h"
+#include "xtimer.h"
+
+#include "tlog.h"
+
+#define TLOG_HDR_LEN        (7U)
+#define TLOG_RECORD_MAX     (TLOG_HDR_LEN + 4 * TLOG_ARGS_MAX)
+
+/* start of the format strings, placed by the linker */
+extern const char __start_tlog_fmt[];
+
+static char _buf[TLOG_BUF_SIZE];
+static ringbuffer_t _rb = RINGBUFFER_INIT(_buf);
+static uint32_t _dropped = 0;
+
+static size_t _put_u32(uint8_t *buf, uint32_t value)
+{
+    buf[0] = (uint8_t)value;
+    buf[1] = (uint8_t)(value >> 8);
+    buf[2] = (uint8_t)(value >> 16);
+    buf[3] = (uint8_t)(value >> 24);
+    return 4;
+}
+
+static size_t _header(uint8_t *buf, unsigned nargs, uint16_t id, uint32_t now)
+{
+    buf[0] = nargs;
+    buf[1] = (uint8_t)id;
+    buf[2] = (uint8_t)(id >> 8);
+    return 3 + _put_u32(&buf[3], now);
+}
+
+void tlog_write(const char *fmt, unsigned nargs, ...)
+{
+    uint8_t record[TLOG_RECORD_MAX];
+    uint32_t now = xtimer_now_usec();
+    size_t len = _header(record, nargs, (uint16_t)(fmt - __start_tlog_fmt), now);
+
+    va_list ap;
+    va_start(ap, nargs);
+    for (unsigned i = 0; i < nargs; i++) {
+        len += _put_u32(&record[len], va_arg(ap, uint32_t));
+    }
+    va_end(ap);
+
+    /* records are written whole, and after the count of those lost */
+    unsigned state = irq_disable();
+    if (_dropped) {
+        uint8_t dropped[TLOG_HDR_LEN + 4];
+        if (ringbuffer_get_free(&_rb) < sizeof(dropped) + len) {
+            _dropped++;
+            irq_restore(state);
+            return;
+        }
+        size_t n = _header(dropped, 1, TLOG_ID_DROPPED, now);
+        n += _put_u32(&dropped[n], _dropped);
+        ringbuffer_add(&_rb, (char *)dropped, n);
+        _dropped = 0;
+    }
+    if (ringbuffer_get_free(&_rb) < len) {
+        _dropped++;
+    }
+    else {
+        ringbuffer_add(&_rb, (char *)record, len);
+    }
+    irq_restore(state);
+}
+
+size_t tlog_read(uint8_t *buf, size_t len)
+{
+    size_t pos = 0;
+    unsigned state = irq_disable();
+    while (!ringbuffer_empty(&_rb)) {
+        uint8_t nargs;
+        ringbuffer_peek(&_rb, (char *)&nargs, 1);
+        size_t n = TLOG_HDR_LEN + 4 * nargs;
+        if (pos + n > len) {
+            break;
+        }
+        ringbuffer_get(&_rb, (char *)&buf[pos], n);
+        pos += n;
+    }
+    irq_restore(state);
+    return pos;
+}
+
+int tlog_cmd(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+    uint8_t record[TLOG_RECORD_MAX];
+    size_t len;
+
+    /* one record per line, the decoder picks them out of the console */
+    while ((len = tlog_read(record, sizeof(record))) > 0) {
+        printf("tlog:");
+        for (size_t i = 0; i < len; i++) {
+            printf("%02x", record[i]);
+        }
+        puts("");
+    }
+
+    return 0;
+}
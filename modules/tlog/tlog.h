@@ -0,0 +1,70 @@
+#ifndef TLOG_H
+#define TLOG_H
+
+#include <inttypes.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef TLOG_BUF_SIZE
+#define TLOG_BUF_SIZE       (512U)      /* RAM ring buffer of records */
+#endif
+
+#define TLOG_URI            "/log"
+#define TLOG_ARGS_MAX       (8U)
+#define TLOG_ID_DROPPED     (0xffff)    /* records lost, the argument counts them */
+
+/* Tokenized log: a call site only stores the offset of its format string
+ * in the "tlog_fmt" section, a timestamp and its raw arguments. The text is
+ * formatted on the host by tools/tlog_decode.py from the ELF file.
+ *
+ * Record, little endian: number of arguments (1 byte), format id (2 bytes),
+ * time in us (4 bytes) and the arguments (4 bytes each).
+ *
+ * Arguments are passed as 32 bit words: integers and pointers only, no
+ * 64 bit or floating point values. A %s argument is decoded if it points
+ * to a constant string of the firmware, RAM buffers show their address.
+ *
+ * Without the tlog module TLOG() is DEBUG(), see debug.h */
+#ifdef MODULE_TLOG
+#define TLOG(...) \
+    do { \
+        static const char _tlog_fmt[] \
+            __attribute__((section("tlog_fmt"), aligned(1))) = \
+            _TLOG_FIRST(__VA_ARGS__, _); \
+        tlog_write(_tlog_fmt, _TLOG_NARGS(__VA_ARGS__) _TLOG_REST(__VA_ARGS__)); \
+    } while (0)
+#else
+#define TLOG(...)   DEBUG(__VA_ARGS__)
+#endif
+
+/* Argument list helpers, they stay valid for -pedantic without arguments */
+#define _TLOG_FIRST(fmt, ...)   fmt
+#define _TLOG_NARGS(...) \
+    _TLOG_SELECT(__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0, _)
+#define _TLOG_REST(...) \
+    _TLOG_REST_(_TLOG_SELECT(__VA_ARGS__, N, N, N, N, N, N, N, N, 0, _), __VA_ARGS__)
+#define _TLOG_REST_(n, ...)     _TLOG_REST__(n, __VA_ARGS__)
+#define _TLOG_REST__(n, ...)    _TLOG_REST_##n(__VA_ARGS__)
+#define _TLOG_REST_0(fmt)
+#define _TLOG_REST_N(fmt, ...)  , __VA_ARGS__
+#define _TLOG_SELECT(_0, _1, _2, _3, _4, _5, _6, _7, _8, n, ...)    n
+
+void tlog_write(const char *fmt, unsigned nargs, ...);
+
+/* Moves whole records to `buf`, returns their length */
+size_t tlog_read(uint8_t *buf, size_t len);
+
+/* Registers /log, a GET returns and removes the oldest records */
+void init_tlog_handler(void);
+
+/* "tlog" shell command, prints the records as hex lines */
+int tlog_cmd(int argc, char **argv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TLOG_H */
@@ -0,0 +1,42 @@
+#ifdef MODULE_GCOAP
+
+#include <inttypes.h>
+#include <string.h>
+
+#include "net/gcoap.h"
+
+#include "tlog.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+static ssize_t _log_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx);
+
+static const coap_resource_t _resources[] = {
+    { TLOG_URI, COAP_GET, _log_handler, NULL },
+};
+
+static gcoap_listener_t _listener = {
+    (coap_resource_t *)&_resources[0],
+    sizeof(_resources) / sizeof(_resources[0]),
+    NULL
+};
+
+/* the records are removed once read, an empty payload means no more */
+static ssize_t _log_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx)
+{
+    (void)ctx;
+    gcoap_resp_init(pdu, buf, len, COAP_CODE_CONTENT);
+    size_t payload_len = tlog_read(pdu->payload, pdu->payload_len);
+
+    return gcoap_finish(pdu, payload_len, COAP_FORMAT_OCTET);
+}
+
+void init_tlog_handler(void)
+{
+    gcoap_register_listener(&_listener);
+}
+
+#else
+typedef int dont_be_pedantic;
+#endif /* MODULE_GCOAP */
@@ -0,0 +1,130 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "irq.h"
+#include "sched.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#include "trace.h"
+
+static trace_event_t _events[TRACE_EVENTS];
+static unsigned _first = 0;
+static unsigned _count = 0;
+static uint32_t _lost = 0;
+
+/* request each thread works on */
+static uint32_t _requests[MAXTHREADS];
+static uint16_t _next_local = 0;
+
+void trace_event(trace_stage_t stage, trace_phase_t phase, uint32_t id)
+{
+    uint32_t now = xtimer_now_usec();
+    /* interrupts are shown on their own, not on the thread they preempted */
+    kernel_pid_t pid = irq_is_in() ? KERNEL_PID_UNDEF : thread_getpid();
+
+    unsigned state = irq_disable();
+    trace_event_t *event;
+    if (_count < TRACE_EVENTS) {
+        event = &_events[(_first + _count++) % TRACE_EVENTS];
+    }
+    else {
+        /* keep the most recent events */
+        event = &_events[_first];
+        _first = (_first + 1) % TRACE_EVENTS;
+        _lost++;
+    }
+    event->time = now;
+    event->id = id;
+    event->stage = stage;
+    event->phase = phase;
+    event->pid = pid;
+    irq_restore(state);
+}
+
+void trace_set_request(uint32_t id)
+{
+    kernel_pid_t pid = thread_getpid();
+    if (pid > 0) {
+        _requests[pid - 1] = id;
+    }
+}
+
+uint32_t trace_get_request(void)
+{
+    kernel_pid_t pid = thread_getpid();
+    return (pid > 0) ? _requests[pid - 1] : 0;
+}
+
+uint32_t trace_new_request(void)
+{
+    unsigned state = irq_disable();
+    uint32_t id = TRACE_LOCAL | _next_local++;
+    irq_restore(state);
+    return id;
+}
+
+static size_t _put_u32(uint8_t *buf, uint32_t value)
+{
+    buf[0] = (uint8_t)value;
+    buf[1] = (uint8_t)(value >> 8);
+    buf[2] = (uint8_t)(value >> 16);
+    buf[3] = (uint8_t)(value >> 24);
+    return 4;
+}
+
+static size_t _put_event(uint8_t *buf, const trace_event_t *event)
+{
+    size_t n = _put_u32(buf, event->time);
+    n += _put_u32(&buf[n], event->id);
+    buf[n++] = event->stage;
+    buf[n++] = event->phase;
+    buf[n++] = (uint8_t)event->pid;
+    return n;
+}
+
+size_t trace_read(uint8_t *buf, size_t len)
+{
+    size_t pos = 0;
+    unsigned state = irq_disable();
+    if (_lost && len >= TRACE_EVENT_LEN) {
+        trace_event_t lost = { xtimer_now_usec(), _lost, TRACE_STAGE_LOST,
+                               TRACE_PHASE_INSTANT, KERNEL_PID_UNDEF };
+        pos += _put_event(buf, &lost);
+        _lost = 0;
+    }
+    while (_count && (pos + TRACE_EVENT_LEN <= len)) {
+        pos += _put_event(&buf[pos], &_events[_first]);
+        _first = (_first + 1) % TRACE_EVENTS;
+        _count--;
+    }
+    irq_restore(state);
+    return pos;
+}
+
+int trace_cmd(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+    uint8_t buf[4 * TRACE_EVENT_LEN];
+    size_t len;
+
+#ifdef DEVELHELP
+    for (kernel_pid_t pid = KERNEL_PID_FIRST; pid <= KERNEL_PID_LAST; pid++) {
+        thread_t *thread = (thread_t *)thread_get(pid);
+        if (thread) {
+            printf("trace:thread %d %s\n", pid, thread->name);
+        }
+    }
+#endif
+    while ((len = trace_read(buf, sizeof(buf))) > 0) {
+        printf("trace:");
+        for (size_t i = 0; i < len; i++) {
+            printf("%02x", buf[i]);
+        }
+        puts("");
+    }
+
+    return 0;
+}
@@ -0,0 +1,98 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <inttypes.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef TRACE_EVENTS
+#define TRACE_EVENTS            (64U)   /* ring buffer size, oldest events are overwritten */
+#endif
+
+#define TRACE_URI               "/trace"
+
+/* Stages of a request, the host tool reads the names from this list */
+#define TRACE_STAGES(X) \
+    X(HANDLER, "handler") \
+    X(SENSOR, "sensor") \
+    X(ENCODE, "encode") \
+    X(ENQUEUE, "enqueue") \
+    X(CYCLE, "cycle") \
+    X(SEND, "send")
+
+#define TRACE_ID(id, name)      TRACE_##id,
+
+typedef enum { TRACE_STAGES(TRACE_ID) TRACE_STAGE_NUMOF } trace_stage_t;
+
+typedef enum {
+    TRACE_PHASE_BEGIN,
+    TRACE_PHASE_END,
+    TRACE_PHASE_INSTANT,
+} trace_phase_t;
+
+/* Requests are the CoAP message id of an incoming request, or a local id
+ * for the work started on the node (bus cycles, triggered reads) */
+#define TRACE_LOCAL             (0x10000UL)
+
+/* Stage recorded when events were overwritten, its id counts them */
+#define TRACE_STAGE_LOST        (0xff)
+
+/* Event, 11 bytes when read: time in us, request id (4 bytes each, little
+ * endian), stage, phase and thread pid (1 byte each) */
+#define TRACE_EVENT_LEN         (11U)
+
+typedef struct {
+    uint32_t time;
+    uint32_t id;
+    uint8_t stage;
+    uint8_t phase;
+    int8_t pid;
+} trace_event_t;
+
+/* Events are tagged with the request the current thread works on:
+ * TRACE_REQUEST() sets it, TRACE_NEW() starts a local one. Interrupts
+ * give the request explicitly with TRACE_INSTANT_FOR(). The macros
+ * compile to nothing without the trace module */
+#ifdef MODULE_TRACE
+#define TRACE_REQUEST(id)       trace_set_request(id)
+#define TRACE_NEW()             trace_set_request(trace_new_request())
+#define TRACE_BEGIN(stage) \
+    trace_event(TRACE_##stage, TRACE_PHASE_BEGIN, trace_get_request())
+#define TRACE_END(stage) \
+    trace_event(TRACE_##stage, TRACE_PHASE_END, trace_get_request())
+#define TRACE_INSTANT(stage) \
+    trace_event(TRACE_##stage, TRACE_PHASE_INSTANT, trace_get_request())
+#define TRACE_INSTANT_FOR(stage, id) \
+    trace_event(TRACE_##stage, TRACE_PHASE_INSTANT, (id))
+#else
+#define TRACE_REQUEST(id)
+#define TRACE_NEW()
+#define TRACE_BEGIN(stage)
+#define TRACE_END(stage)
+#define TRACE_INSTANT(stage)
+#define TRACE_INSTANT_FOR(stage, id)
+#endif
+
+void trace_event(trace_stage_t stage, trace_phase_t phase, uint32_t id);
+void trace_set_request(uint32_t id);
+uint32_t trace_get_request(void);
+uint32_t trace_new_request(void);
+
+/* Moves the oldest events to `buf`, returns their length */
+size_t trace_read(uint8_t *buf, size_t len);
+
+/* Registers /trace, a GET returns and removes the oldest events */
+void init_trace_handler(void);
+
+/* "trace" shell command, prints the thread names and the events as hex
+ * lines for tools/trace_export.py */
+int trace_cmd(int argc, char **argv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRACE_H */
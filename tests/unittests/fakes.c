@@ -0,0 +1,149 @@
+#include <errno.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include "thread.h"
+#include "xtimer.h"
+#include "net/sock/udp.h"
+#include "net/emcute.h"
+#include "periph/i2c.h"
+
+#include "fakes.h"
+
+fake_sock_t fake_sock;
+fake_emcute_t fake_emcute;
+fake_i2c_t fake_i2c;
+
+void fakes_reset(void)
+{
+    memset(&fake_sock, 0, sizeof(fake_sock));
+    memset(&fake_emcute, 0, sizeof(fake_emcute));
+    memset(&fake_i2c, 0, sizeof(fake_i2c));
+    fake_emcute.con_result = EMCUTE_OK;
+    fake_emcute.reg_result = EMCUTE_OK;
+    fake_emcute.pub_result = EMCUTE_OK;
+    fake_emcute.next_id = 1;
+}
+
+int sock_udp_create(sock_udp_t *sock, const sock_udp_ep_t *local,
+                    const sock_udp_ep_t *remote, uint16_t flags)
+{
+    (void)remote;
+    (void)flags;
+    if (local) {
+        sock->local = *local;
+    }
+    return 0;
+}
+
+void sock_udp_close(sock_udp_t *sock)
+{
+    (void)sock;
+}
+
+int sock_udp_get_local(sock_udp_t *sock, sock_udp_ep_t *ep)
+{
+    *ep = sock->local;
+    return 0;
+}
+
+int sock_udp_get_remote(sock_udp_t *sock, sock_udp_ep_t *ep)
+{
+    (void)sock;
+    (void)ep;
+    return -ENOTCONN;
+}
+
+/* nothing is ever received, the gcoap thread only sees timeouts */
+ssize_t sock_udp_recv(sock_udp_t *sock, void *data, size_t max_len,
+                      uint32_t timeout, sock_udp_ep_t *remote)
+{
+    (void)sock;
+    (void)data;
+    (void)max_len;
+    (void)remote;
+    if (timeout == SOCK_NO_TIMEOUT) {
+        thread_sleep();
+    }
+    else if (timeout) {
+        xtimer_usleep(timeout);
+    }
+    return -ETIMEDOUT;
+}
+
+ssize_t sock_udp_send(sock_udp_t *sock, const void *data, size_t len,
+                      const sock_udp_ep_t *remote)
+{
+    (void)sock;
+    if (fake_sock.send_result < 0) {
+        return fake_sock.send_result;
+    }
+    if (fake_sock.numof < FAKE_SOCK_SENT_MAX) {
+        fake_datagram_t *d = &fake_sock.sent[fake_sock.numof];
+        d->len = (len < sizeof(d->buf)) ? len : sizeof(d->buf);
+        memcpy(d->buf, data, d->len);
+        d->remote = *remote;
+    }
+    fake_sock.numof++;
+    return len;
+}
+
+/* the client thread has nothing to serve */
+void emcute_run(uint16_t port, const char *id)
+{
+    (void)port;
+    (void)id;
+}
+
+int emcute_con(sock_udp_ep_t *remote, bool clean, const char *will_topic,
+               const void *will_msg, size_t will_msg_len, unsigned flags)
+{
+    (void)remote;
+    (void)clean;
+    (void)will_topic;
+    (void)will_msg;
+    (void)will_msg_len;
+    (void)flags;
+    fake_emcute.con_calls++;
+    return fake_emcute.con_result;
+}
+
+int emcute_reg(emcute_topic_t *topic)
+{
+    fake_emcute.reg_calls++;
+    if (fake_emcute.reg_result != EMCUTE_OK) {
+        return fake_emcute.reg_result;
+    }
+    topic->id = fake_emcute.next_id++;
+    return EMCUTE_OK;
+}
+
+int emcute_pub(emcute_topic_t *topic, const void *buf, size_t len,
+               unsigned flags)
+{
+    fake_emcute.pub_calls++;
+    if (fake_emcute.pub_result != EMCUTE_OK) {
+        return fake_emcute.pub_result;
+    }
+    fake_emcute.topic_id = topic->id;
+    fake_emcute.flags = flags;
+    if (len >= sizeof(fake_emcute.payload)) {
+        len = sizeof(fake_emcute.payload) - 1;
+    }
+    memcpy(fake_emcute.payload, buf, len);
+    fake_emcute.payload[len] = '\0';
+    return EMCUTE_OK;
+}
+
+int i2c_read_bytes(i2c_t dev, uint16_t addr, void *data, size_t len,
+                   uint8_t flags)
+{
+    (void)dev;
+    (void)flags;
+    fake_i2c.addr = addr;
+    if (fake_i2c.result < 0) {
+        return fake_i2c.result;
+    }
+    memcpy(data, fake_i2c.reg, (len < 2) ? len : 2);
+    return 0;
+}
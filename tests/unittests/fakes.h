@@ -0,0 +1,65 @@
+#ifndef FAKES_H
+#define FAKES_H
+
+#include <inttypes.h>
+#include <stdlib.h>
+
+#include "net/sock/udp.h"
+#include "net/emcute.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FAKE_SOCK_SENT_MAX      (4U)
+#define FAKE_DATAGRAM_LEN       (256U)
+#define FAKE_PAYLOAD_LEN        (64U)
+
+typedef struct {
+    uint8_t buf[FAKE_DATAGRAM_LEN];
+    size_t len;
+    sock_udp_ep_t remote;
+} fake_datagram_t;
+
+/* Datagrams passed to sock_udp_send(), the first FAKE_SOCK_SENT_MAX are
+ * kept. Sends fail with `send_result` when it is negative. */
+typedef struct {
+    fake_datagram_t sent[FAKE_SOCK_SENT_MAX];
+    unsigned numof;
+    int send_result;
+} fake_sock_t;
+
+/* Calls of emcute_con(), emcute_reg() and emcute_pub(), registered topics
+ * get `next_id` and the calls fail with the given results */
+typedef struct {
+    unsigned con_calls;
+    unsigned reg_calls;
+    unsigned pub_calls;
+    int con_result;
+    int reg_result;
+    int pub_result;
+    uint16_t next_id;
+    uint16_t topic_id;
+    unsigned flags;
+    char payload[FAKE_PAYLOAD_LEN];
+} fake_emcute_t;
+
+/* Register read by i2c_read_bytes(), which fails with `result` when it is
+ * negative */
+typedef struct {
+    uint8_t reg[2];
+    uint16_t addr;
+    int result;
+} fake_i2c_t;
+
+extern fake_sock_t fake_sock;
+extern fake_emcute_t fake_emcute;
+extern fake_i2c_t fake_i2c;
+
+void fakes_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FAKES_H */
@@ -0,0 +1,17 @@
+#ifndef SOCK_TYPES_H
+#define SOCK_TYPES_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The fake stack only keeps the endpoint a sock is bound to */
+struct sock_udp {
+    sock_udp_ep_t local;
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SOCK_TYPES_H */
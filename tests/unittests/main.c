@@ -0,0 +1,22 @@
+/*
+ * Unit tests of the module logic, on the native board
+ */
+
+#include "embUnit.h"
+
+#include "fakes.h"
+#include "tests.h"
+
+int main(void)
+{
+    TESTS_START();
+    TESTS_RUN(tests_coap_common_tests());
+    TESTS_RUN(tests_coap_utils_tests());
+    TESTS_RUN(tests_io1_xplained_tests());
+    TESTS_RUN(tests_mqtt_utils_tests());
+    TESTS_RUN(tests_sensor_filter_tests());
+    TESTS_RUN(tests_telemetry_tests());
+    TESTS_END();
+
+    return 0;
+}
@@ -0,0 +1,49 @@
+#include <string.h>
+
+#include "net/gcoap.h"
+
+#include "tests.h"
+
+int tests_coap_request(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                       unsigned method, const char *path)
+{
+    size_t pos = 0;
+    unsigned delta = COAP_OPT_URI_PATH;
+
+    buf[pos++] = 0x41;          /* version 1, confirmable, 1 byte token */
+    buf[pos++] = method;
+    buf[pos++] = TESTS_COAP_ID >> 8;
+    buf[pos++] = TESTS_COAP_ID & 0xff;
+    buf[pos++] = TESTS_COAP_TOKEN;
+
+    /* one Uri-Path option per segment, segments are short */
+    while (*path == '/') {
+        const char *segment = ++path;
+        size_t n = strcspn(segment, "/");
+        if (pos + 1 + n > len) {
+            return -1;
+        }
+        buf[pos++] = (delta << 4) | n;
+        memcpy(&buf[pos], segment, n);
+        pos += n;
+        path += n;
+        delta = 0;
+    }
+    return coap_parse(pdu, buf, pos);
+}
+
+void tests_coap_check_text(uint8_t *buf, ssize_t len, const char *payload)
+{
+    coap_pkt_t res;
+
+    TEST_ASSERT(len > 0);
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(&res, buf, len));
+    TEST_ASSERT_EQUAL_INT(COAP_TYPE_ACK, coap_get_type(&res));
+    TEST_ASSERT_EQUAL_INT(205, coap_get_code(&res));
+    TEST_ASSERT_EQUAL_INT(TESTS_COAP_ID, coap_get_id(&res));
+    TEST_ASSERT_EQUAL_INT(1, coap_get_token_len(&res));
+    TEST_ASSERT_EQUAL_INT(TESTS_COAP_TOKEN, res.token[0]);
+    TEST_ASSERT_EQUAL_INT(COAP_FORMAT_TEXT, coap_get_content_type(&res));
+    TEST_ASSERT_EQUAL_INT(strlen(payload), res.payload_len);
+    TEST_ASSERT(memcmp(res.payload, payload, res.payload_len) == 0);
+}
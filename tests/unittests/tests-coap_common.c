@@ -0,0 +1,56 @@
+#include <string.h>
+
+#include "embUnit.h"
+#include "net/gcoap.h"
+
+#include "coap_common.h"
+
+#include "tests.h"
+
+static uint8_t _buf[GCOAP_PDU_BUF_SIZE];
+
+static void _check(coap_handler_t handler, const char *path,
+                   const char *expected)
+{
+    coap_pkt_t pdu;
+
+    TEST_ASSERT_EQUAL_INT(0, tests_coap_request(&pdu, _buf, sizeof(_buf),
+                                                COAP_METHOD_GET, path));
+    TEST_ASSERT_EQUAL_STRING(path, (char *)pdu.url);
+    ssize_t len = handler(&pdu, _buf, sizeof(_buf), NULL);
+    tests_coap_check_text(_buf, len, expected);
+}
+
+static void test_name_handler(void)
+{
+    _check(name_handler, "/name", APPLICATION_NAME);
+}
+
+static void test_board_handler(void)
+{
+    _check(board_handler, "/board", RIOT_BOARD);
+}
+
+static void test_mcu_handler(void)
+{
+    _check(mcu_handler, "/mcu", RIOT_MCU);
+}
+
+static void test_os_handler(void)
+{
+    _check(os_handler, "/os", "riot");
+}
+
+Test *tests_coap_common_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_name_handler),
+        new_TestFixture(test_board_handler),
+        new_TestFixture(test_mcu_handler),
+        new_TestFixture(test_os_handler),
+    };
+
+    EMB_UNIT_TESTCALLER(coap_common_tests, NULL, NULL, fixtures);
+
+    return (Test *)&coap_common_tests;
+}
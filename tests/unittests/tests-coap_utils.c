@@ -0,0 +1,160 @@
+#include <errno.h>
+#include <string.h>
+
+#include "embUnit.h"
+#include "net/gcoap.h"
+#include "net/ipv6/addr.h"
+
+#include "coap_utils.h"
+
+#include "fakes.h"
+#include "tests.h"
+
+#define VALUE       "23.4°C"
+#define VALUE_LEN   (sizeof(VALUE) - 1)
+
+static coap_batch_t _batch;
+
+static void set_up(void)
+{
+    fakes_reset();
+}
+
+/* Checks that datagram `i` is a POST of `payload` on /server to the broker */
+static void _check_post(unsigned i, const char *payload)
+{
+    fake_datagram_t *d = &fake_sock.sent[i];
+    ipv6_addr_t broker;
+    coap_pkt_t pdu;
+
+    TEST_ASSERT(i < fake_sock.numof);
+    TEST_ASSERT_NOT_NULL(ipv6_addr_from_str(&broker, BROKER_ADDR));
+    TEST_ASSERT(memcmp(d->remote.addr.ipv6, broker.u8, sizeof(broker.u8)) == 0);
+    TEST_ASSERT_EQUAL_INT(BROKER_PORT, d->remote.port);
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(&pdu, d->buf, d->len));
+    TEST_ASSERT_EQUAL_INT(COAP_METHOD_POST, coap_get_code(&pdu));
+    TEST_ASSERT_EQUAL_STRING("/server", (char *)pdu.url);
+    TEST_ASSERT_EQUAL_INT(COAP_FORMAT_TEXT, coap_get_content_type(&pdu));
+    TEST_ASSERT_EQUAL_INT(strlen(payload), pdu.payload_len);
+    TEST_ASSERT(memcmp(pdu.payload, payload, pdu.payload_len) == 0);
+}
+
+static void _add(unsigned idx)
+{
+    char *value = coap_batch_key(&_batch, "temperature", idx);
+    memcpy(value, VALUE, VALUE_LEN);
+    coap_batch_add(&_batch, VALUE_LEN);
+}
+
+static void test_send_coap_post(void)
+{
+    send_coap_post((uint8_t *)"/server", (uint8_t *)"temperature:" VALUE);
+    TEST_ASSERT_EQUAL_INT(1, fake_sock.numof);
+    _check_post(0, "temperature:" VALUE);
+}
+
+static void test_send_coap_post_raw__too_large(void)
+{
+    static const uint8_t data[GCOAP_PDU_BUF_SIZE] = { 0 };
+
+    TEST_ASSERT_EQUAL_INT(-1, send_coap_post_raw((uint8_t *)"/server", data,
+                                                 sizeof(data),
+                                                 COAP_FORMAT_TEXT));
+    TEST_ASSERT_EQUAL_INT(0, fake_sock.numof);
+}
+
+static void test_send_coap_post_raw__send_error(void)
+{
+    fake_sock.send_result = -ENOMEM;
+    TEST_ASSERT_EQUAL_INT(-1, send_coap_post_raw((uint8_t *)"/server",
+                                                 (uint8_t *)VALUE, VALUE_LEN,
+                                                 COAP_FORMAT_TEXT));
+}
+
+static void test_batch__single(void)
+{
+    coap_batch_init(&_batch, 1);
+    _add(0);
+    _check_post(0, "temperature:" VALUE);
+    TEST_ASSERT_EQUAL_INT(0, _batch.len);
+}
+
+static void test_batch__instances(void)
+{
+    coap_batch_init(&_batch, 3);
+    for (unsigned i = 0; i < 3; i++) {
+        _add(i);
+    }
+    TEST_ASSERT_EQUAL_INT(0, fake_sock.numof);
+
+    coap_batch_send(&_batch);
+    TEST_ASSERT_EQUAL_INT(1, fake_sock.numof);
+    _check_post(0, "temperature/0:" VALUE "\n"
+                   "temperature/1:" VALUE "\n"
+                   "temperature/2:" VALUE);
+
+    /* nothing left to send */
+    coap_batch_send(&_batch);
+    TEST_ASSERT_EQUAL_INT(1, fake_sock.numof);
+}
+
+static void test_batch__full(void)
+{
+    /* "temperature/<i>:23.4°C\n" is 22 bytes, the 8th key does not fit in
+     * the 192 bytes of the batch with room for a value */
+    coap_batch_init(&_batch, 10);
+    for (unsigned i = 0; i < 10; i++) {
+        _add(i);
+    }
+    TEST_ASSERT_EQUAL_INT(1, fake_sock.numof);
+    coap_batch_send(&_batch);
+    TEST_ASSERT_EQUAL_INT(2, fake_sock.numof);
+    _check_post(1, "temperature/7:" VALUE "\n"
+                   "temperature/8:" VALUE "\n"
+                   "temperature/9:" VALUE);
+}
+
+static void test_batch__no_index(void)
+{
+    coap_batch_init(&_batch, 2);
+    char *value = coap_batch_key(&_batch, "pressure", COAP_BATCH_NO_INDEX);
+    memcpy(value, "1013hPa", 7);
+    coap_batch_add(&_batch, 7);
+    _add(0);
+    coap_batch_send(&_batch);
+    _check_post(0, "pressure:1013hPa\ntemperature/0:" VALUE);
+}
+
+static void test_sort_coap_resources(void)
+{
+    coap_resource_t resources[] = {
+        { "/temperature", COAP_GET, NULL, NULL },
+        { "/board", COAP_GET, NULL, NULL },
+        { "/pressure", COAP_GET, NULL, NULL },
+        { "/humidity", COAP_GET, NULL, NULL },
+    };
+
+    sort_coap_resources(resources, 4);
+    TEST_ASSERT_EQUAL_STRING("/board", resources[0].path);
+    TEST_ASSERT_EQUAL_STRING("/humidity", resources[1].path);
+    TEST_ASSERT_EQUAL_STRING("/pressure", resources[2].path);
+    TEST_ASSERT_EQUAL_STRING("/temperature", resources[3].path);
+}
+
+Test *tests_coap_utils_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_send_coap_post),
+        new_TestFixture(test_send_coap_post_raw__too_large),
+        new_TestFixture(test_send_coap_post_raw__send_error),
+        new_TestFixture(test_batch__single),
+        new_TestFixture(test_batch__instances),
+        new_TestFixture(test_batch__full),
+        new_TestFixture(test_batch__no_index),
+        new_TestFixture(test_sort_coap_resources),
+    };
+
+    EMB_UNIT_TESTCALLER(coap_utils_tests, set_up, NULL, fixtures);
+
+    return (Test *)&coap_utils_tests;
+}
@@ -0,0 +1,72 @@
+#include <errno.h>
+#include <string.h>
+
+#include "embUnit.h"
+#include "net/gcoap.h"
+
+#include "coap_io1_xplained.h"
+
+#include "fakes.h"
+#include "tests.h"
+
+static uint8_t _buf[GCOAP_PDU_BUF_SIZE];
+
+static void set_up(void)
+{
+    fakes_reset();
+}
+
+static void test_convert(void)
+{
+    /* 25 °C, 25.5 °C with the fraction bits set, -12.5 °C, 0 °C */
+    static const uint8_t raw[][2] = { { 0x19, 0x00 }, { 0x19, 0x80 },
+                                      { 0x8c, 0x80 }, { 0x00, 0x00 } };
+
+    TEST_ASSERT_EQUAL_INT(25, io1_xplained_temperature_convert(raw[0]));
+    TEST_ASSERT_EQUAL_INT(25, io1_xplained_temperature_convert(raw[1]));
+    TEST_ASSERT_EQUAL_INT(-12, io1_xplained_temperature_convert(raw[2]));
+    TEST_ASSERT_EQUAL_INT(0, io1_xplained_temperature_convert(raw[3]));
+}
+
+static void test_read(void)
+{
+    int16_t temperature = 0;
+
+    fake_i2c.reg[0] = 0x1b;
+    read_io1_xplained_temperature(&temperature);
+    TEST_ASSERT_EQUAL_INT(27, temperature);
+    TEST_ASSERT_EQUAL_INT(0x4f, fake_i2c.addr);
+
+    /* the value is kept on a bus error */
+    fake_i2c.result = -EIO;
+    fake_i2c.reg[0] = 0x19;
+    read_io1_xplained_temperature(&temperature);
+    TEST_ASSERT_EQUAL_INT(27, temperature);
+}
+
+static void test_handler(void)
+{
+    coap_pkt_t pdu;
+
+    fake_i2c.reg[0] = 0x19;
+    fake_i2c.reg[1] = 0x80;
+    TEST_ASSERT_EQUAL_INT(0, tests_coap_request(&pdu, _buf, sizeof(_buf),
+                                                COAP_METHOD_GET,
+                                                "/temperature"));
+    ssize_t len = io1_xplained_temperature_handler(&pdu, _buf, sizeof(_buf),
+                                                   NULL);
+    tests_coap_check_text(_buf, len, "25°C");
+}
+
+Test *tests_io1_xplained_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_convert),
+        new_TestFixture(test_read),
+        new_TestFixture(test_handler),
+    };
+
+    EMB_UNIT_TESTCALLER(io1_xplained_tests, set_up, NULL, fixtures);
+
+    return (Test *)&io1_xplained_tests;
+}
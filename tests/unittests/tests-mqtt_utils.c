@@ -0,0 +1,100 @@
+#include <string.h>
+
+#include "embUnit.h"
+#include "net/emcute.h"
+
+#include "mqtt_utils.h"
+
+#include "fakes.h"
+#include "tests.h"
+
+static void set_up(void)
+{
+    fakes_reset();
+}
+
+static void test_publish_topic(void)
+{
+    emcute_topic_t topic = { .name = MQTT_TOPIC("temperature"), .id = 0 };
+
+    TEST_ASSERT_EQUAL_INT(0, publish_topic(&topic, "23.4°C"));
+    TEST_ASSERT_EQUAL_INT(1, fake_emcute.reg_calls);
+    TEST_ASSERT_EQUAL_INT(1, fake_emcute.pub_calls);
+    TEST_ASSERT_EQUAL_INT(1, topic.id);
+    TEST_ASSERT_EQUAL_INT(1, fake_emcute.topic_id);
+    TEST_ASSERT_EQUAL_INT(EMCUTE_QOS_1, fake_emcute.flags);
+    TEST_ASSERT_EQUAL_STRING("23.4°C", fake_emcute.payload);
+
+    /* the topic stays registered */
+    TEST_ASSERT_EQUAL_INT(0, publish_topic(&topic, "23.5°C"));
+    TEST_ASSERT_EQUAL_INT(1, fake_emcute.reg_calls);
+    TEST_ASSERT_EQUAL_INT(2, fake_emcute.pub_calls);
+    TEST_ASSERT_EQUAL_STRING("23.5°C", fake_emcute.payload);
+}
+
+static void test_publish_topic__reg_error(void)
+{
+    emcute_topic_t topic = { .name = MQTT_TOPIC("temperature"), .id = 0 };
+
+    fake_emcute.reg_result = EMCUTE_NOGW;
+    TEST_ASSERT_EQUAL_INT(1, publish_topic(&topic, "23.4°C"));
+    TEST_ASSERT_EQUAL_INT(0, fake_emcute.pub_calls);
+    TEST_ASSERT_EQUAL_INT(0, topic.id);
+
+    /* registered on the next try */
+    fake_emcute.reg_result = EMCUTE_OK;
+    TEST_ASSERT_EQUAL_INT(0, publish_topic(&topic, "23.4°C"));
+    TEST_ASSERT_EQUAL_INT(2, fake_emcute.reg_calls);
+}
+
+static void test_publish_topic__pub_error(void)
+{
+    emcute_topic_t topic = { .name = MQTT_TOPIC("temperature"), .id = 0 };
+
+    fake_emcute.pub_result = EMCUTE_TIMEOUT;
+    TEST_ASSERT_EQUAL_INT(1, publish_topic(&topic, "23.4°C"));
+    TEST_ASSERT_EQUAL_INT(1, fake_emcute.pub_calls);
+}
+
+static void test_publish(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, publish((uint8_t *)MQTT_TOPIC("name"),
+                                     (uint8_t *)"Node"));
+    TEST_ASSERT_EQUAL_INT(0, publish((uint8_t *)MQTT_TOPIC("name"),
+                                     (uint8_t *)"Node"));
+    /* the topic is not kept */
+    TEST_ASSERT_EQUAL_INT(2, fake_emcute.reg_calls);
+    TEST_ASSERT_EQUAL_INT(2, fake_emcute.pub_calls);
+    TEST_ASSERT_EQUAL_STRING("Node", fake_emcute.payload);
+}
+
+static void test_connect(void)
+{
+    fake_emcute.con_result = EMCUTE_NOGW;
+    TEST_ASSERT_EQUAL_INT(-1, mqtt_utils_connect());
+    TEST_ASSERT(!mqtt_utils_connected());
+
+    fake_emcute.con_result = EMCUTE_OK;
+    TEST_ASSERT_EQUAL_INT(0, mqtt_utils_connect());
+    TEST_ASSERT(mqtt_utils_connected());
+    TEST_ASSERT_EQUAL_INT(2, fake_emcute.con_calls);
+
+    /* the connection is shared by the later callers */
+    TEST_ASSERT_EQUAL_INT(0, mqtt_utils_connect());
+    TEST_ASSERT_EQUAL_INT(2, fake_emcute.con_calls);
+}
+
+Test *tests_mqtt_utils_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_publish_topic),
+        new_TestFixture(test_publish_topic__reg_error),
+        new_TestFixture(test_publish_topic__pub_error),
+        new_TestFixture(test_publish),
+        new_TestFixture(test_connect),
+    };
+
+    EMB_UNIT_TESTCALLER(mqtt_utils_tests, set_up, NULL, fixtures);
+
+    return (Test *)&mqtt_utils_tests;
+}
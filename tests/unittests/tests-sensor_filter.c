@@ -0,0 +1,110 @@
+#include <errno.h>
+
+#include "embUnit.h"
+
+#include "sensor_filter.h"
+
+#include "tests.h"
+
+static sensor_filter_t _filter;
+
+static void set_up(void)
+{
+    sensor_filter_init(&_filter);
+}
+
+static void test_add__errors(void)
+{
+    TEST_ASSERT_EQUAL_INT(-EINVAL, sensor_filter_add_median(&_filter, 0));
+    TEST_ASSERT_EQUAL_INT(-EINVAL,
+                          sensor_filter_add_median(&_filter,
+                                                   SENSOR_FILTER_MEDIAN_MAX + 1));
+    TEST_ASSERT_EQUAL_INT(-EINVAL, sensor_filter_add_ema(&_filter, 16));
+    for (unsigned i = 0; i < SENSOR_FILTER_STAGES_MAX; i++) {
+        TEST_ASSERT_EQUAL_INT(0, sensor_filter_add_ema(&_filter, 1));
+    }
+    TEST_ASSERT_EQUAL_INT(-ENOMEM, sensor_filter_add_ema(&_filter, 1));
+}
+
+static void test_median(void)
+{
+    int32_t value;
+
+    TEST_ASSERT_EQUAL_INT(0, sensor_filter_add_median(&_filter, 3));
+    TEST_ASSERT(!sensor_filter_get(&_filter, &value));
+    /* the window fills up first */
+    TEST_ASSERT_EQUAL_INT(10, sensor_filter_update(&_filter, 10));
+    TEST_ASSERT_EQUAL_INT(10, sensor_filter_update(&_filter, 100));
+    TEST_ASSERT_EQUAL_INT(20, sensor_filter_update(&_filter, 20));
+    TEST_ASSERT_EQUAL_INT(30, sensor_filter_update(&_filter, 30));
+    TEST_ASSERT_EQUAL_INT(20, sensor_filter_update(&_filter, -5));
+    TEST_ASSERT_EQUAL_INT(-5, sensor_filter_update(&_filter, -40));
+    TEST_ASSERT(sensor_filter_get(&_filter, &value));
+    TEST_ASSERT_EQUAL_INT(-5, value);
+}
+
+static void test_ema(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, sensor_filter_add_ema(&_filter, 2));
+    TEST_ASSERT_EQUAL_INT(100, sensor_filter_update(&_filter, 100));
+    TEST_ASSERT_EQUAL_INT(125, sensor_filter_update(&_filter, 200));
+    TEST_ASSERT_EQUAL_INT(144, sensor_filter_update(&_filter, 200));
+}
+
+/* a pressure in Pa with the largest shift, x * 2^15 needs 32 bits and more */
+static void test_ema__no_overflow(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, sensor_filter_add_ema(&_filter, 15));
+    TEST_ASSERT_EQUAL_INT(101325, sensor_filter_update(&_filter, 101325));
+    for (unsigned i = 0; i < 100; i++) {
+        TEST_ASSERT_EQUAL_INT(101325, sensor_filter_update(&_filter, 101325));
+    }
+    TEST_ASSERT_EQUAL_INT(101325, sensor_filter_update(&_filter, 101425));
+
+    sensor_filter_reset(&_filter);
+    TEST_ASSERT_EQUAL_INT(-101325, sensor_filter_update(&_filter, -101325));
+    TEST_ASSERT_EQUAL_INT(-101325, sensor_filter_update(&_filter, -101325));
+}
+
+static void test_iir(void)
+{
+    /* y = x / 4 + x[n-1] / 4 + y[n-1] / 2, unity gain */
+    TEST_ASSERT_EQUAL_INT(0, sensor_filter_add_iir(&_filter, 8192, 8192,
+                                                   -16384));
+    TEST_ASSERT_EQUAL_INT(1000, sensor_filter_update(&_filter, 1000));
+    TEST_ASSERT_EQUAL_INT(1250, sensor_filter_update(&_filter, 2000));
+    TEST_ASSERT_EQUAL_INT(1625, sensor_filter_update(&_filter, 2000));
+}
+
+static void test_setup__spike(void)
+{
+    int32_t value;
+
+    sensor_filter_setup(&_filter, 3, 2);
+    TEST_ASSERT_EQUAL_INT(2, _filter.numof);
+    sensor_filter_update(&_filter, 100);
+    sensor_filter_update(&_filter, 100);
+    /* the median drops the spike before the EMA sees it */
+    TEST_ASSERT_EQUAL_INT(100, sensor_filter_update(&_filter, 1000));
+    TEST_ASSERT_EQUAL_INT(100, sensor_filter_update(&_filter, 100));
+
+    sensor_filter_reset(&_filter);
+    TEST_ASSERT(!sensor_filter_get(&_filter, &value));
+    TEST_ASSERT_EQUAL_INT(500, sensor_filter_update(&_filter, 500));
+}
+
+Test *tests_sensor_filter_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_add__errors),
+        new_TestFixture(test_median),
+        new_TestFixture(test_ema),
+        new_TestFixture(test_ema__no_overflow),
+        new_TestFixture(test_iir),
+        new_TestFixture(test_setup__spike),
+    };
+
+    EMB_UNIT_TESTCALLER(sensor_filter_tests, set_up, NULL, fixtures);
+
+    return (Test *)&sensor_filter_tests;
+}
@@ -0,0 +1,111 @@
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "telemetry.h"
+
+#include "tests.h"
+
+static char _text[TELEMETRY_VALUE_MAX + 1];
+static unsigned _published;
+static unsigned _flushed;
+static char _last[TELEMETRY_VALUE_MAX + 1];
+
+static void _check(int32_t value, int8_t scale, uint8_t digits,
+                   const char *unit, const char *expected)
+{
+    telemetry_sample_t sample = {
+        .name = "value",
+        .idx = TELEMETRY_NO_INDEX,
+        .value = value,
+        .scale = scale,
+        .digits = digits,
+        .unit = unit,
+    };
+
+    TEST_ASSERT_EQUAL_INT(strlen(expected), telemetry_format(_text, &sample));
+    TEST_ASSERT_EQUAL_STRING(expected, _text);
+}
+
+static void test_format__decimals(void)
+{
+    _check(2345, -2, 1, "°C", "23.4°C");
+    _check(-2345, -2, 1, "°C", "-23.4°C");
+    _check(-5, -2, 2, "°C", "-0.05°C");
+    _check(2345, -2, 0, "°C", "23°C");
+    /* no more decimals than the scale */
+    _check(1013, -1, 3, "hPa", "101.3hPa");
+}
+
+static void test_format__integers(void)
+{
+    _check(101325, 0, 0, "Pa", "101325Pa");
+    _check(12, 2, 0, "lx", "1200lx");
+    _check(-7, 0, 0, NULL, "-7");
+}
+
+static void test_format__text(void)
+{
+    telemetry_sample_t sample = {
+        .name = "led",
+        .idx = TELEMETRY_NO_INDEX,
+        .str = "on",
+    };
+
+    TEST_ASSERT_EQUAL_INT(2, telemetry_format(_text, &sample));
+    TEST_ASSERT_EQUAL_STRING("on", _text);
+}
+
+static void _publish(const telemetry_sample_t *sample)
+{
+    _published++;
+    telemetry_format(_last, sample);
+}
+
+static void _flush(void)
+{
+    _flushed++;
+}
+
+static telemetry_sink_t _sink = {
+    .name = "test",
+    .publish = _publish,
+    .flush = _flush,
+};
+
+static void test_publish(void)
+{
+    telemetry_sample_t sample = {
+        .name = "temperature",
+        .idx = 0,
+        .value = 2345,
+        .scale = -2,
+        .digits = 1,
+        .unit = "°C",
+    };
+
+    telemetry_init();
+    telemetry_register_sink(&_sink);
+    telemetry_publish(&sample);
+    sample.value = 2350;
+    telemetry_publish(&sample);
+    TEST_ASSERT_EQUAL_INT(2, _published);
+    TEST_ASSERT_EQUAL_INT(0, _flushed);
+    TEST_ASSERT_EQUAL_STRING("23.5°C", _last);
+    telemetry_flush();
+    TEST_ASSERT_EQUAL_INT(1, _flushed);
+}
+
+Test *tests_telemetry_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_format__decimals),
+        new_TestFixture(test_format__integers),
+        new_TestFixture(test_format__text),
+        new_TestFixture(test_publish),
+    };
+
+    EMB_UNIT_TESTCALLER(telemetry_tests, NULL, NULL, fixtures);
+
+    return (Test *)&telemetry_tests;
+}
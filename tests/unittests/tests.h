@@ -0,0 +1,38 @@
+#ifndef TESTS_H
+#define TESTS_H
+
+#include <inttypes.h>
+#include <stdlib.h>
+
+#include "embUnit.h"
+#include "net/gcoap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TESTS_COAP_ID           (0x1234U)
+#define TESTS_COAP_TOKEN        (0xaaU)
+
+/* Writes a confirmable request for `path` with TESTS_COAP_ID and a one
+ * byte token and parses it into `pdu`, as gcoap hands it to a handler.
+ * Returns the result of coap_parse(). */
+int tests_coap_request(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                       unsigned method, const char *path);
+
+/* Checks that `buf` holds a 2.05 text response to the request of
+ * tests_coap_request() with `payload` */
+void tests_coap_check_text(uint8_t *buf, ssize_t len, const char *payload);
+
+Test *tests_coap_common_tests(void);
+Test *tests_coap_utils_tests(void);
+Test *tests_io1_xplained_tests(void);
+Test *tests_mqtt_utils_tests(void);
+Test *tests_sensor_filter_tests(void);
+Test *tests_telemetry_tests(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TESTS_H */
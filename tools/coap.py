@@ -0,0 +1,170 @@
+"""Minimal CoAP client used by the host tools.
+
+Only what the tools need from RFC 7252: confirmable requests with
+retransmissions, Uri-Path, Uri-Query and Content-Format options, piggybacked
+responses. There is no dependency beyond the standard library.
+"""
+
+import os
+import socket
+import struct
+import time
+
+CON, NON, ACK, RST = 0, 1, 2, 3
+GET, POST, PUT, DELETE = 1, 2, 3, 4
+
+OPT_URI_PATH = 11
+OPT_CONTENT_FORMAT = 12
+OPT_URI_QUERY = 15
+
+FORMAT_TEXT = 0
+FORMAT_CBOR = 60
+
+COAP_PORT = 5683
+
+
+def code_str(code):
+    """Return a response code as "2.05"."""
+    return "%d.%02d" % (code >> 5, code & 0x1f)
+
+
+def _option_nibble(value):
+    if value < 13:
+        return value, b""
+    if value < 269:
+        return 13, struct.pack("!B", value - 13)
+    return 14, struct.pack("!H", value - 269)
+
+
+def encode(mtype, code, mid, token, options=(), payload=b""):
+    """Encode a message, options are (number, bytes) pairs."""
+    data = struct.pack("!BBH", 0x40 | (mtype << 4) | len(token), code, mid)
+    data += token
+    last = 0
+    for number, value in sorted(options, key=lambda o: o[0]):
+        delta, delta_ext = _option_nibble(number - last)
+        length, length_ext = _option_nibble(len(value))
+        data += struct.pack("!B", (delta << 4) | length)
+        data += delta_ext + length_ext + value
+        last = number
+    if payload:
+        data += b"\xff" + payload
+    return data
+
+
+def decode(data):
+    """Decode a message into a dict, or return None if it is malformed."""
+    if len(data) < 4:
+        return None
+    first, code, mid = struct.unpack("!BBH", data[:4])
+    tkl = first & 0x0f
+    pos = 4 + tkl
+    msg = {
+        "type": (first >> 4) & 0x03,
+        "code": code,
+        "mid": mid,
+        "token": data[4:pos],
+        "options": [],
+        "payload": b"",
+    }
+    number = 0
+    while pos < len(data):
+        if data[pos] == 0xff:
+            msg["payload"] = data[pos + 1:]
+            break
+        delta, length = data[pos] >> 4, data[pos] & 0x0f
+        pos += 1
+        for field in ("delta", "length"):
+            value = delta if field == "delta" else length
+            if value == 13:
+                value = data[pos] + 13
+                pos += 1
+            elif value == 14:
+                value = struct.unpack("!H", data[pos:pos + 2])[0] + 269
+                pos += 2
+            if field == "delta":
+                delta = value
+            else:
+                length = value
+        number += delta
+        msg["options"].append((number, data[pos:pos + length]))
+        pos += length
+    return msg
+
+
+def request_options(path, query=None, content_format=None):
+    """Build the options of a request to "/a/b"."""
+    options = [(OPT_URI_PATH, seg.encode())
+               for seg in path.strip("/").split("/") if seg]
+    if content_format is not None:
+        options.append((OPT_CONTENT_FORMAT,
+                        struct.pack("!H", content_format).lstrip(b"\x00")))
+    for item in (query or []):
+        options.append((OPT_URI_QUERY, item.encode()))
+    return options
+
+
+def resolve(host, port=COAP_PORT):
+    """Resolve an address, link-local ones need a zone ("fe80::1%tap0")."""
+    info = socket.getaddrinfo(host, port, socket.AF_INET6, socket.SOCK_DGRAM)
+    return info[0][4]
+
+
+class Client(object):
+    """Blocking client for a single node."""
+
+    def __init__(self, host, port=COAP_PORT, timeout=2.0, retries=4):
+        self.remote = resolve(host, port)
+        self.timeout = timeout
+        self.retries = retries
+        self.sock = socket.socket(socket.AF_INET6, socket.SOCK_DGRAM)
+        self.mid = struct.unpack("!H", os.urandom(2))[0]
+
+    def close(self):
+        self.sock.close()
+
+    def request(self, method, path, payload=b"", query=None,
+                content_format=None):
+        """Send a confirmable request, return (code, payload, rtt in s) or
+        None once all retransmissions timed out."""
+        if isinstance(payload, str):
+            payload = payload.encode()
+        self.mid = (self.mid + 1) & 0xffff
+        token = os.urandom(4)
+        data = encode(CON, method, self.mid, token,
+                      request_options(path, query, content_format), payload)
+        timeout = self.timeout
+        start = time.time()
+        for _ in range(self.retries + 1):
+            self.sock.sendto(data, self.remote)
+            deadline = time.time() + timeout
+            while True:
+                left = deadline - time.time()
+                if left <= 0:
+                    break
+                self.sock.settimeout(left)
+                try:
+                    reply, _ = self.sock.recvfrom(2048)
+                except socket.timeout:
+                    break
+                msg = decode(reply)
+                if (msg is None or msg["token"] != token or
+                        msg["type"] not in (ACK, CON, NON)):
+                    continue
+                if msg["code"] == 0:
+                    # empty ACK, the response follows on its own
+                    continue
+                return msg["code"], msg["payload"], time.time() - start
+            timeout *= 2
+        return None
+
+    def get(self, path, **kwargs):
+        return self.request(GET, path, **kwargs)
+
+    def resources(self):
+        """Return the paths listed in /.well-known/core."""
+        res = self.get("/.well-known/core")
+        if res is None:
+            return []
+        links = res[1].decode(errors="replace").split(",")
+        return [link.split(">")[0].lstrip("<") for link in links if link]
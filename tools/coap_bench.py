@@ -0,0 +1,259 @@
+#!/usr/bin/env python3
+"""Load-test the CoAP server of firmwares on native.
+
+Each application is built for native (with the extra modules given, the
+sensors are mocked) and started on a tap interface, or a deployed node is
+used with --node. Workers then send confirmable GETs back to back,
+each on its own socket, picking resources from the mix. Host side loss
+drops requests and responses at random, the retransmissions of coap.py
+recover them as on a lossy link.
+
+For every app, concurrency and loss level the throughput and the p50, p99
+and p999 latencies, overall and per resource, are printed and saved as
+JSON in <output>/ with the revision of the tree, to compare runs with
+--compare.
+
+    $ ./tools/coap_bench.py node_saul node_leds --concurrency 1,4,16 \\
+          --loss 0,0.05 --duration 30
+    $ ./tools/coap_bench.py --node 2001:db8::1 --mix /temperature=3,/pressure=1
+    $ ./tools/coap_bench.py --compare results/old.json results/new.json
+"""
+
+import argparse
+import json
+import os
+import random
+import subprocess
+import sys
+import threading
+import time
+
+import coap
+import native
+import workload
+
+
+class LossySocket(object):
+    """Drops datagrams in both directions with probability `loss`."""
+
+    def __init__(self, sock, loss, rng):
+        self.sock = sock
+        self.loss = loss
+        self.rng = rng
+
+    def sendto(self, data, address):
+        if self.rng.random() >= self.loss:
+            self.sock.sendto(data, address)
+        return len(data)
+
+    def recvfrom(self, size):
+        while True:
+            data, address = self.sock.recvfrom(size)
+            if self.rng.random() >= self.loss:
+                return data, address
+
+    def settimeout(self, timeout):
+        self.sock.settimeout(timeout)
+
+    def close(self):
+        self.sock.close()
+
+
+def percentile(values, p):
+    if not values:
+        return None
+    index = min(len(values) - 1, int(len(values) * p / 100.0))
+    return values[index]
+
+
+def summarize(samples, duration):
+    """Throughput and latencies in ms of (ok, rtt) samples."""
+    rtts = sorted(rtt for ok, rtt in samples if ok)
+
+    def ms(value):
+        return None if value is None else round(value * 1000, 3)
+
+    return {
+        "requests": len(samples),
+        "ok": len(rtts),
+        "errors": len(samples) - len(rtts),
+        "throughput": round(len(rtts) / duration, 2),
+        "p50_ms": ms(percentile(rtts, 50)),
+        "p99_ms": ms(percentile(rtts, 99)),
+        "p999_ms": ms(percentile(rtts, 99.9)),
+        "max_ms": ms(rtts[-1] if rtts else None),
+    }
+
+
+def parse_mix(text, client):
+    """"/a=3,/b=1" to [(path, weight)], every resource once by default."""
+    if text:
+        mix = []
+        for item in text.split(","):
+            path, _, weight = item.partition("=")
+            mix.append((path, float(weight or 1)))
+        return mix
+    return [(path, 1.0) for path in client.resources()
+            if path not in workload.SKIP + ("/burst",)]
+
+
+def run(address, mix, concurrency, loss, duration, seed):
+    """Run one load level, return its summary."""
+    paths = [path for path, _ in mix]
+    weights = [weight for _, weight in mix]
+    samples = {path: [] for path in paths}
+    lock = threading.Lock()
+    end = time.time() + duration
+
+    def worker(index):
+        rng = random.Random(seed + index)
+        client = coap.Client(address)
+        if loss:
+            client.sock = LossySocket(client.sock, loss, rng)
+        local = []
+        while time.time() < end:
+            path = rng.choices(paths, weights)[0]
+            res = client.get(path)
+            ok = res is not None and res[0] >> 5 == 2
+            local.append((path, ok, res[2] if res else None))
+        client.close()
+        with lock:
+            for path, ok, rtt in local:
+                samples[path].append((ok, rtt))
+
+    start = time.time()
+    workers = [threading.Thread(target=worker, args=(i,))
+               for i in range(concurrency)]
+    for w in workers:
+        w.start()
+    for w in workers:
+        w.join()
+    elapsed = time.time() - start
+
+    everything = [s for path in paths for s in samples[path]]
+    result = summarize(everything, elapsed)
+    result["resources"] = {path: summarize(samples[path], elapsed)
+                           for path in paths}
+    return result
+
+
+def revision():
+    try:
+        rev = subprocess.check_output(["git", "-C", native.REPO, "describe",
+                                       "--always", "--dirty"],
+                                      universal_newlines=True).strip()
+    except (OSError, subprocess.CalledProcessError):
+        rev = "unknown"
+    return rev
+
+
+def print_result(name, result):
+    print("%-36s %7.1f req/s  p50 %8s  p99 %8s  p999 %8s ms  %d errors" % (
+        name, result["throughput"], result["p50_ms"], result["p99_ms"],
+        result["p999_ms"], result["errors"]))
+
+
+def bench(target, address, args):
+    client = coap.Client(address)
+    mix = parse_mix(args.mix, client)
+    client.close()
+    if not mix:
+        sys.exit("%s: no resource to load" % target)
+
+    report = {
+        "target": target,
+        "revision": revision(),
+        "date": time.strftime("%Y-%m-%dT%H:%M:%S"),
+        "duration": args.duration,
+        "mix": dict(mix),
+        "runs": [],
+    }
+    for loss in args.loss:
+        for concurrency in args.concurrency:
+            result = run(address, mix, concurrency, loss, args.duration,
+                         args.seed)
+            result.update({"concurrency": concurrency, "loss": loss})
+            report["runs"].append(result)
+            print_result("%s c=%d loss=%g" % (target, concurrency, loss),
+                         result)
+
+    path = os.path.join(args.output, "%s_%s_bench.json"
+                        % (target.replace(":", "_"), report["revision"]))
+    with open(path, "w") as f:
+        json.dump(report, f, indent=2, sort_keys=True)
+    print("saved to %s" % path)
+
+
+def compare(old_path, new_path):
+    with open(old_path) as f:
+        old = json.load(f)
+    with open(new_path) as f:
+        new = json.load(f)
+    print("%s (%s) -> %s (%s)" % (old["target"], old["revision"],
+                                  new["target"], new["revision"]))
+    old_runs = {(r["concurrency"], r["loss"]): r for r in old["runs"]}
+    for run_new in new["runs"]:
+        key = (run_new["concurrency"], run_new["loss"])
+        run_old = old_runs.get(key)
+        if run_old is None:
+            continue
+        line = "c=%d loss=%g" % key
+        for field in ("throughput", "p50_ms", "p99_ms", "p999_ms"):
+            a, b = run_old[field], run_new[field]
+            if a and b is not None:
+                line += "  %s %s -> %s (%+.1f%%)" % (field, a, b,
+                                                      (b - a) * 100.0 / a)
+        print(line)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    parser.add_argument("apps", nargs="*", help="applications to benchmark")
+    parser.add_argument("--node", help="address of a deployed node instead")
+    parser.add_argument("--tap", default="tap0")
+    parser.add_argument("--modules", default="",
+                        help="extra modules of the native builds, space "
+                             "separated")
+    parser.add_argument("--concurrency", default="1,4,16",
+                        help="comma separated numbers of workers")
+    parser.add_argument("--loss", default="0",
+                        help="comma separated loss ratios, e.g. 0,0.05")
+    parser.add_argument("--mix", help="weighted resources, e.g. /a=3,/b=1")
+    parser.add_argument("--duration", type=int, default=20,
+                        help="duration of each run in s")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--no-build", action="store_true")
+    parser.add_argument("--output", default="results")
+    parser.add_argument("--compare", nargs=2, metavar="JSON",
+                        help="compare two saved results")
+    args = parser.parse_args()
+
+    if args.compare:
+        compare(*args.compare)
+        return
+
+    args.concurrency = [int(c) for c in args.concurrency.split(",")]
+    args.loss = [float(l) for l in args.loss.split(",")]
+    os.makedirs(args.output, exist_ok=True)
+
+    if args.node:
+        bench(args.node, args.node, args)
+        return
+    if not args.apps:
+        parser.error("give applications to build, or --node")
+
+    modules = args.modules.split()
+    for app in args.apps:
+        elf = os.path.join(native.app_dir(app), "bin", "native", "%s.elf" % app)
+        if not args.no_build:
+            elf = native.build(app, modules=modules)
+        node = native.NativeNode(elf, args.tap)
+        try:
+            node.wait_ready()
+            bench(app, node.address, args)
+        finally:
+            node.stop()
+
+
+if __name__ == "__main__":
+    main()
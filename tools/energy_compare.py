@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+"""Compare the estimated current draw of a firmware under several settings.
+
+The application is built for native with the energy module. For each
+setting (a /config query, e.g. "report_interval=60"), a fresh instance is
+started on a tap interface in its own directory, the setting is applied,
+the energy accounting is reset and the node runs for the given duration,
+idle or driven through its busiest paths with --workload (see workload.py).
+The /energy summary of each run is written to <output>/<app>_energy.csv.
+
+Native uses the current tables of the SAM R21 board (see energy_params.h):
+the figures compare strategies, they do not predict a given board.
+
+    $ ./tools/energy_compare.py node_bmx280 report_interval=5 \\
+          report_interval=60 --duration 300
+"""
+
+import argparse
+import csv
+import os
+import sys
+import tempfile
+import time
+from urllib.parse import parse_qsl
+
+import coap
+import native
+import workload
+
+FIELDS = ["uptime", "tx_bytes", "tx_frames", "rx_bytes", "rx_frames",
+          "active_ms", "sleep_ms", "conversions", "mcu_ua", "radio_ua",
+          "sensor_ua", "avg_ua", "life_h"]
+
+
+def run(elf, setting, args):
+    """Run one instance with `setting`, return the /energy summary."""
+    node = native.NativeNode(elf, args.tap, cwd=tempfile.mkdtemp())
+    try:
+        node.wait_ready()
+        client = coap.Client(node.address)
+        if setting:
+            res = client.request(coap.PUT, "/config", setting)
+            if res is None or res[0] >> 5 != 2:
+                sys.exit("%s rejected by /config" % setting)
+        client.request(coap.DELETE, "/energy")
+        if args.workload:
+            workload.exercise(client, args.duration, log=lambda msg: None)
+        else:
+            time.sleep(args.duration)
+        res = client.get("/energy")
+        if res is None or res[0] != 0x45:
+            sys.exit("no /energy on the node, is the energy module built in?")
+    finally:
+        node.stop()
+    return dict(parse_qsl(res[1].decode()))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    parser.add_argument("app", help="application, e.g. node_bmx280")
+    parser.add_argument("settings", nargs="*",
+                        help="/config queries to compare, the defaults if none")
+    parser.add_argument("--tap", default="tap0")
+    parser.add_argument("--duration", type=int, default=120,
+                        help="duration of each run in s")
+    parser.add_argument("--workload", action="store_true",
+                        help="drive the node instead of leaving it idle")
+    parser.add_argument("--no-build", action="store_true")
+    parser.add_argument("--output", default="results")
+    args = parser.parse_args()
+
+    elf = os.path.join(native.app_dir(args.app), "bin", "native",
+                       "%s.elf" % args.app)
+    if not args.no_build:
+        elf = native.build(args.app, modules=["energy"])
+
+    rows = []
+    for setting in args.settings or [""]:
+        energy = run(elf, setting, args)
+        rows.append([setting or "default"] +
+                    [energy.get(field, "") for field in FIELDS])
+        print("%-30s %8s uA  mcu %6s  radio %6s  sensors %5s  %8s h" % (
+            rows[-1][0], energy.get("avg_ua"), energy.get("mcu_ua"),
+            energy.get("radio_ua"), energy.get("sensor_ua"),
+            energy.get("life_h")))
+
+    os.makedirs(args.output, exist_ok=True)
+    path = os.path.join(args.output, "%s_energy.csv" % args.app)
+    with open(path, "w") as f:
+        writer = csv.writer(f)
+        writer.writerow(["setting"] + FIELDS)
+        writer.writerows(rows)
+    print("saved to %s" % path)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,405 @@
+#!/usr/bin/env python3
+"""Run a fleet of native nodes against a stand-in broker and gateway.
+
+N instances of an application share one link: the taps of RIOT's
+tapsetup (`sudo dist/tools/tapsetup/tapsetup -c <N>`) are bridged on
+tapbr0. The host takes the place of the CoAP broker and of the MQTT-SN
+gateway on the link-local address of the bridge, the application is built
+with it as BROKER_ADDR and GATEWAY_ADDR and with the metrics module.
+
+The broker records the beacons and pushes, answers confirmable ones and
+polls a resource of random nodes as the Pyaiot broker does, the gateway
+accepts connections, registrations, subscriptions and publications. For
+each fleet size the uplink packets per second, the peak rate over 1 s and
+100 ms, the delivery ratio (packets received over the sends counted by the
+nodes) and the latency of the broker requests are printed and saved to
+<output>/fleet_<app>.json.
+
+    $ ./tools/fleet_sim.py node_bmx280 --nodes 10,50,100 --duration 120
+    $ ./tools/fleet_sim.py node_mqtt_bmx280 --nodes 20 --stagger 0.1
+"""
+
+import argparse
+import json
+import os
+import random
+import re
+import shutil
+import socket
+import struct
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+
+import coap
+import native
+import workload
+
+GATEWAY_PORT = 1885
+
+# MQTT-SN message types
+CONNECT, CONNACK = 0x04, 0x05
+REGISTER, REGACK = 0x0a, 0x0b
+PUBLISH, PUBACK = 0x0c, 0x0d
+SUBSCRIBE, SUBACK = 0x12, 0x13
+PINGREQ, PINGRESP = 0x16, 0x17
+DISCONNECT = 0x18
+
+MQTTSN_NAMES = {CONNECT: "connect", REGISTER: "register",
+                PUBLISH: "publish", SUBSCRIBE: "subscribe",
+                PINGREQ: "pingreq", DISCONNECT: "disconnect"}
+
+COUNTER_RE = re.compile(r"^(coap_tx|mqtt_tx)\s+(\d+)")
+
+
+def link_local(interface):
+    """Return the link-local address of `interface`."""
+    out = subprocess.check_output(["ip", "-6", "addr", "show", "dev",
+                                   interface, "scope", "link"],
+                                  universal_newlines=True)
+    match = re.search(r"inet6 (fe80::[0-9a-f:]+)/", out)
+    if match is None:
+        sys.exit("%s has no link-local address, is it up?" % interface)
+    return match.group(1)
+
+
+class Packets(object):
+    """Uplink packets received by the host, with their arrival time."""
+
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.packets = []
+        self.counting = True
+
+    def add(self, source, kind):
+        with self.lock:
+            if self.counting:
+                self.packets.append((time.time(), source, kind))
+
+    def stop(self):
+        with self.lock:
+            self.counting = False
+
+
+class Server(threading.Thread):
+    """UDP server on the bridge, `handle` returns the reply or None."""
+
+    def __init__(self, address, port, interface, packets):
+        super(Server, self).__init__()
+        self.daemon = True
+        self.packets = packets
+        self.sock = socket.socket(socket.AF_INET6, socket.SOCK_DGRAM)
+        self.sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        self.sock.bind(coap.resolve("%s%%%s" % (address, interface), port))
+        self.sock.settimeout(0.2)
+        self.running = True
+
+    def run(self):
+        while self.running:
+            try:
+                data, remote = self.sock.recvfrom(2048)
+            except socket.timeout:
+                continue
+            reply = self.handle(data, remote[0].split("%")[0])
+            if reply:
+                self.sock.sendto(reply, remote)
+
+    def stop(self):
+        self.running = False
+        self.join()
+        self.sock.close()
+
+
+class Broker(Server):
+    """Stand-in CoAP broker: counts the POSTs of the nodes per path."""
+
+    def handle(self, data, source):
+        msg = coap.decode(data)
+        if msg is None or msg["code"] >> 5 != 0 or msg["code"] == 0:
+            return None
+        path = "/" + "/".join(v.decode(errors="replace")
+                              for n, v in msg["options"]
+                              if n == coap.OPT_URI_PATH)
+        self.packets.add(source, "coap %s" % path)
+        if msg["type"] == coap.CON:
+            # 2.04 Changed, piggybacked
+            return coap.encode(coap.ACK, 0x44, msg["mid"], msg["token"])
+        return None
+
+
+class Gateway(Server):
+    """Stand-in MQTT-SN gateway: accepts everything, keeps the topic ids of
+    each client."""
+
+    def __init__(self, *args):
+        super(Gateway, self).__init__(*args)
+        self.topics = {}
+
+    def handle(self, data, source):
+        if len(data) < 2:
+            return None
+        if data[0] == 0x01:
+            msg_type, body = data[3], data[4:]
+        else:
+            msg_type, body = data[1], data[2:]
+        self.packets.add(source, "mqttsn %s" % MQTTSN_NAMES.get(
+            msg_type, "0x%02x" % msg_type))
+        topics = self.topics.setdefault(source, {})
+
+        if msg_type == CONNECT:
+            return struct.pack("!BBB", 3, CONNACK, 0)
+        if msg_type == REGISTER and len(body) >= 4:
+            msg_id, = struct.unpack_from("!H", body, 2)
+            name = body[4:].decode(errors="replace")
+            topic = topics.setdefault(name, len(topics) + 1)
+            return struct.pack("!BBHHB", 7, REGACK, topic, msg_id, 0)
+        if msg_type == PUBLISH and len(body) >= 5:
+            flags = body[0]
+            topic, msg_id = struct.unpack_from("!HH", body, 1)
+            if (flags >> 5) & 0x03 == 1:
+                return struct.pack("!BBHHB", 7, PUBACK, topic, msg_id, 0)
+            return None
+        if msg_type == SUBSCRIBE and len(body) >= 3:
+            flags = body[0]
+            msg_id, = struct.unpack_from("!H", body, 1)
+            name = body[3:].decode(errors="replace")
+            topic = topics.setdefault(name, len(topics) + 1)
+            return struct.pack("!BBBHHB", 8, SUBACK, flags & 0x60, topic,
+                               msg_id, 0)
+        if msg_type == PINGREQ:
+            return struct.pack("!BB", 2, PINGRESP)
+        if msg_type == DISCONNECT:
+            return struct.pack("!BB", 2, DISCONNECT)
+        return None
+
+
+class Poller(threading.Thread):
+    """Reads a resource of a random node at `rate` requests per second and
+    records the round trip times."""
+
+    def __init__(self, targets, rate, seed):
+        super(Poller, self).__init__()
+        self.daemon = True
+        self.targets = targets
+        self.rate = rate
+        self.rng = random.Random(seed)
+        self.rtts = []
+        self.lost = 0
+        self.running = True
+
+    def run(self):
+        while self.running and self.targets:
+            start = time.time()
+            address, path = self.rng.choice(self.targets)
+            client = coap.Client(address, retries=2)
+            res = client.get(path)
+            client.close()
+            if res is None:
+                self.lost += 1
+            else:
+                self.rtts.append(res[2])
+            time.sleep(max(0, 1.0 / self.rate - (time.time() - start)))
+
+    def stop(self):
+        self.running = False
+        self.join()
+
+
+def in_parallel(function, items):
+    """Return [function(item)] computed by one thread per item."""
+    results = [None] * len(items)
+
+    def run(index):
+        results[index] = function(items[index])
+
+    threads = [threading.Thread(target=run, args=(i,))
+               for i in range(len(items))]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    return results
+
+
+def sent_counters(node):
+    counters = {"coap_tx": 0, "mqtt_tx": 0}
+    for line in node.shell("metrics", idle=0.3):
+        match = COUNTER_RE.match(line)
+        if match:
+            counters[match.group(1)] = int(match.group(2))
+    return counters
+
+
+def percentile(values, p):
+    if not values:
+        return None
+    values = sorted(values)
+    return values[min(len(values) - 1, int(len(values) * p / 100.0))]
+
+
+def peak(times, window):
+    """Largest number of packets within `window` s."""
+    bins = {}
+    for t in times:
+        key = int(t / window)
+        bins[key] = bins.get(key, 0) + 1
+    return max(bins.values()) if bins else 0
+
+
+def run_fleet(elf, count, args, host):
+    """Run `count` nodes for the duration, return the summary."""
+    packets = Packets()
+    broker = Broker(host, args.broker_port, args.bridge, packets)
+    gateway = Gateway(host, GATEWAY_PORT, args.bridge, packets)
+    broker.start()
+    gateway.start()
+
+    workdir = tempfile.mkdtemp(prefix="fleet_")
+    nodes = []
+    try:
+        start = time.time()
+        for i in range(count):
+            cwd = os.path.join(workdir, "node%d" % i)
+            os.makedirs(cwd)
+            if args.trace:
+                shutil.copy(args.trace, os.path.join(cwd, "mock_sensors.csv"))
+            nodes.append(native.NativeNode(elf, "%s%d" % (args.tap, i),
+                                           cwd=cwd))
+            if args.stagger:
+                time.sleep(args.stagger)
+
+        def ready(node):
+            try:
+                node.wait_ready(timeout=60)
+                return True
+            except RuntimeError:
+                return False
+
+        up = in_parallel(ready, nodes)
+        nodes_up = [n for n, ok in zip(nodes, up) if ok]
+        print("%d/%d nodes up after %.1f s" % (len(nodes_up), count,
+                                               time.time() - start))
+
+        # the broker discovers the resources of each node
+        targets = []
+        if args.poll:
+            def discover(node):
+                address = node.address.split("%")[0] + "%" + args.bridge
+                client = coap.Client(address, retries=2)
+                paths = [p for p in client.resources()
+                         if p not in workload.SKIP + ("/burst", "/config")]
+                client.close()
+                return (address, paths[0]) if paths else None
+            targets = [t for t in in_parallel(discover, nodes_up) if t]
+        poller = Poller(targets, args.poll, args.seed)
+        poller.start()
+
+        time.sleep(args.duration)
+
+        poller.stop()
+        packets.stop()
+        elapsed = time.time() - start
+        sent = in_parallel(sent_counters, nodes_up)
+    finally:
+        for node in nodes:
+            node.stop()
+        broker.stop()
+        gateway.stop()
+        shutil.rmtree(workdir, ignore_errors=True)
+
+    times = [t for t, _, _ in packets.packets]
+    kinds = {}
+    for _, _, kind in packets.packets:
+        kinds[kind] = kinds.get(kind, 0) + 1
+    coap_rx = sum(n for k, n in kinds.items() if k.startswith("coap"))
+    mqtt_rx = kinds.get("mqttsn publish", 0)
+    coap_tx = sum(s["coap_tx"] for s in sent)
+    mqtt_tx = sum(s["mqtt_tx"] for s in sent)
+    sent_total = coap_tx + mqtt_tx
+
+    def ms(value):
+        return None if value is None else round(value * 1000, 1)
+
+    return {
+        "nodes": count,
+        "nodes_up": len(nodes_up),
+        "duration": round(elapsed, 1),
+        "packets": len(times),
+        "kinds": kinds,
+        "rate": round(len(times) / elapsed, 2),
+        "peak_1s": peak(times, 1.0),
+        "peak_100ms": peak(times, 0.1),
+        "sent": sent_total,
+        "delivery": (round(float(coap_rx + mqtt_rx) / sent_total, 4)
+                     if sent_total else None),
+        "poll_requests": len(poller.rtts) + poller.lost,
+        "poll_lost": poller.lost,
+        "poll_p50_ms": ms(percentile(poller.rtts, 50)),
+        "poll_p99_ms": ms(percentile(poller.rtts, 99)),
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    parser.add_argument("app", help="application to run on every node")
+    parser.add_argument("--nodes", default="10",
+                        help="comma separated fleet sizes, e.g. 10,50,100")
+    parser.add_argument("--duration", type=int, default=90,
+                        help="duration of each run in s, after boot")
+    parser.add_argument("--tap", default="tap",
+                        help="prefix of the taps, numbered from 0")
+    parser.add_argument("--bridge", default="tapbr0")
+    parser.add_argument("--broker-port", type=int, default=coap.COAP_PORT)
+    parser.add_argument("--stagger", type=float, default=0,
+                        help="s between node starts, 0 boots them together")
+    parser.add_argument("--poll", type=float, default=2,
+                        help="broker requests per second, 0 to disable")
+    parser.add_argument("--trace", help="mock_sensors.csv for every node")
+    parser.add_argument("--modules", default="",
+                        help="extra modules, space separated")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--no-build", action="store_true")
+    parser.add_argument("--output", default="results")
+    args = parser.parse_args()
+
+    sizes = [int(n) for n in args.nodes.split(",")]
+    for i in range(max(sizes)):
+        if not os.path.exists("/sys/class/net/%s%d" % (args.tap, i)):
+            sys.exit("%s%d is missing, run: sudo RIOT/dist/tools/tapsetup/"
+                     "tapsetup -c %d" % (args.tap, i, max(sizes)))
+    host = link_local(args.bridge)
+
+    elf = os.path.join(native.app_dir(args.app), "bin", "native",
+                       "%s.elf" % args.app)
+    if not args.no_build:
+        elf = native.build(args.app, modules=["metrics"] + args.modules.split(),
+                           variables=["BROKER_ADDR=%s" % host,
+                                      "BROKER_PORT=%d" % args.broker_port,
+                                      "GATEWAY_ADDR=%s" % host,
+                                      "GATEWAY_PORT=%d" % GATEWAY_PORT])
+
+    results = []
+    print("%6s %8s %8s %8s %10s %9s %9s %9s" % (
+        "nodes", "pkt/s", "peak 1s", "100ms", "delivery", "poll p50",
+        "poll p99", "poll lost"))
+    for count in sizes:
+        result = run_fleet(elf, count, args, host)
+        results.append(result)
+        print("%6d %8.1f %8d %8d %10s %9s %9s %9d" % (
+            count, result["rate"], result["peak_1s"], result["peak_100ms"],
+            result["delivery"], result["poll_p50_ms"], result["poll_p99_ms"],
+            result["poll_lost"]))
+
+    os.makedirs(args.output, exist_ok=True)
+    path = os.path.join(args.output, "fleet_%s.json" % args.app)
+    with open(path, "w") as f:
+        json.dump({"app": args.app, "duration": args.duration,
+                   "stagger": args.stagger, "runs": results}, f, indent=2,
+                  sort_keys=True)
+    print("saved to %s" % path)
+
+
+if __name__ == "__main__":
+    main()
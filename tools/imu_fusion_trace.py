@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+"""Generate the IMU trace replayed by the fusion case of microbench.
+
+A node is rolled and pitched back and forth while it turns slowly around
+its vertical axis. The accelerometer (in mg, with noise) and gyroscope
+(body rates in 1/100 dps, with bias and noise) samples are written with
+the true roll and pitch (in 1/100 degrees) as a C table, so that the
+microbench "fusion" case can report the error of imu_fusion next to its
+cost. With --csv the same samples are also written as a mock_sensors
+trace, for the /orientation resource of node_imu on native.
+
+    $ ./tools/imu_fusion_trace.py
+    $ ./tools/imu_fusion_trace.py --csv mock_sensors.csv
+"""
+
+import argparse
+import math
+import os
+import random
+
+REPO = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+HEADER = os.path.join(REPO, "modules", "microbench", "imu_fusion_trace.h")
+
+ROLL_AMPLITUDE = 30.0       # degrees
+ROLL_PERIOD = 4.0           # s
+PITCH_AMPLITUDE = 20.0
+PITCH_PERIOD = 3.0
+YAW_RATE = 10.0             # degrees per second
+ACC_NOISE = 15.0            # mg
+GYRO_BIAS = (0.5, -0.3, 0.2)    # degrees per second
+GYRO_NOISE = 0.3
+
+
+def motion(t):
+    """Euler angles and their rates in degrees at t."""
+    w_roll = 2 * math.pi / ROLL_PERIOD
+    w_pitch = 2 * math.pi / PITCH_PERIOD
+    roll = ROLL_AMPLITUDE * math.sin(w_roll * t)
+    pitch = PITCH_AMPLITUDE * math.sin(w_pitch * t + 1)
+    d_roll = ROLL_AMPLITUDE * w_roll * math.cos(w_roll * t)
+    d_pitch = PITCH_AMPLITUDE * w_pitch * math.cos(w_pitch * t + 1)
+    return roll, pitch, d_roll, d_pitch, YAW_RATE
+
+
+def samples(rate, duration, seed):
+    """(acc, gyro, roll, pitch) of each sample, in the units of the table."""
+    rng = random.Random(seed)
+    for n in range(int(rate * duration)):
+        roll, pitch, d_roll, d_pitch, d_yaw = motion(n / rate)
+        phi = math.radians(roll)
+        theta = math.radians(pitch)
+
+        # gravity in the body frame
+        acc = (-math.sin(theta),
+               math.sin(phi) * math.cos(theta),
+               math.cos(phi) * math.cos(theta))
+        acc = [round(a * 1000 + rng.gauss(0, ACC_NOISE)) for a in acc]
+
+        # body rates from the Euler rates
+        rates = (d_roll - d_yaw * math.sin(theta),
+                 d_pitch * math.cos(phi)
+                 + d_yaw * math.sin(phi) * math.cos(theta),
+                 -d_pitch * math.sin(phi)
+                 + d_yaw * math.cos(phi) * math.cos(theta))
+        gyro = [round((r + b + rng.gauss(0, GYRO_NOISE)) * 100)
+                for r, b in zip(rates, GYRO_BIAS)]
+
+        yield acc, gyro, round(roll * 100), round(pitch * 100)
+
+
+def write_header(path, rows, rate, args):
+    lines = [
+        "/* Generated by tools/imu_fusion_trace.py --rate %d --duration %g "
+        "--seed %d," % (args.rate, args.duration, args.seed),
+        " * do not edit. Accelerometer in mg, gyroscope body rates in 1/100",
+        " * dps, true roll and pitch in 1/100 degrees. */",
+        "",
+        "#ifndef IMU_FUSION_TRACE_H",
+        "#define IMU_FUSION_TRACE_H",
+        "",
+        "#include <inttypes.h>",
+        "",
+        "#ifdef __cplusplus",
+        'extern "C" {',
+        "#endif",
+        "",
+        "#define IMU_FUSION_TRACE_DT     (%dU)  /* us between samples */"
+        % (1000000 // rate),
+        "",
+        "typedef struct {",
+        "    int16_t acc[3];",
+        "    int16_t gyro[3];",
+        "    int16_t roll;",
+        "    int16_t pitch;",
+        "} imu_fusion_trace_t;",
+        "",
+        "static const imu_fusion_trace_t imu_fusion_trace[] = {",
+    ]
+    for acc, gyro, roll, pitch in rows:
+        lines.append("    { { %d, %d, %d }, { %d, %d, %d }, %d, %d },"
+                     % (tuple(acc) + tuple(gyro) + (roll, pitch)))
+    lines += [
+        "};",
+        "",
+        "#ifdef __cplusplus",
+        "}",
+        "#endif",
+        "",
+        "#endif /* IMU_FUSION_TRACE_H */",
+    ]
+    with open(path, "w") as f:
+        f.write("\n".join(lines) + "\n")
+
+
+def write_csv(path, rows, rate):
+    """mock_sensors trace, values in g and dps."""
+    channels = ("accel_x", "accel_y", "accel_z", "gyro_x", "gyro_y", "gyro_z")
+    with open(path, "w") as f:
+        for n, (acc, gyro, _, _) in enumerate(rows):
+            time_ms = n * 1000 // rate
+            values = [a / 1000 for a in acc] + [g / 100 for g in gyro]
+            for channel, value in zip(channels, values):
+                f.write("%d,%s,%g\n" % (time_ms, channel, value))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    parser.add_argument("--rate", type=int, default=50,
+                        help="samples per second")
+    parser.add_argument("--duration", type=float, default=6,
+                        help="length of the trace in s")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--header", default=HEADER)
+    parser.add_argument("--csv", help="also write a mock_sensors trace")
+    args = parser.parse_args()
+
+    rows = list(samples(args.rate, args.duration, args.seed))
+    write_header(args.header, rows, args.rate, args)
+    print("%d samples written to %s" % (len(rows), args.header))
+    if args.csv:
+        write_csv(args.csv, rows, args.rate)
+        print("mock_sensors trace written to %s" % args.csv)
+
+
+if __name__ == "__main__":
+    main()
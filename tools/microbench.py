@@ -0,0 +1,180 @@
+#!/usr/bin/env python3
+"""Time the hot paths of the modules on native and compare runs.
+
+Each application is built for native with the microbench module and
+started on a tap interface. Its "bench" shell command checks the result of
+each case (value formatting, batching, CoAP encoding, request dispatch to
+a handler, IO1 Xplained conversion, sensor filter stages, IMU fusion) and
+times it in ns and CPU cycles per operation. The fusion case also replays
+an IMU trace (see imu_fusion_trace.py) and prints its mean and max error
+in mdeg. The command is run --repeat times and the median of each case is
+printed and saved as JSON in <output>/ with the revision of the tree, with
+the fusion error.
+
+--compare prints the change of each case between two runs and exits with
+an error when one is slower by more than --threshold percent.
+
+    $ ./tools/microbench.py node_bmx280 node_io1_xplained --loops 10000
+    $ ./tools/microbench.py node_saul --path /temperature
+    $ ./tools/microbench.py node_imu --path /orientation
+    $ ./tools/microbench.py --compare results/old.json results/new.json
+"""
+
+import argparse
+import json
+import os
+import re
+import sys
+import time
+
+import coap_bench
+import native
+
+# "<case> <loops> <ns/op> <cycles/op>", cycles are "-" without a counter
+RESULT_RE = re.compile(r"^(\w+)\s+(\d+)\s+(\d+)\s+(\d+|-)$")
+FAILED_RE = re.compile(r"^(\w+)\s+FAILED$")
+# "<case> error mean <mdeg> max <mdeg> mdeg"
+ERROR_RE = re.compile(r"^(\w+)\s+error mean (\d+) max (\d+) mdeg$")
+
+
+def median(values):
+    values = sorted(values)
+    return values[len(values) // 2] if values else None
+
+
+def run(node, args):
+    """Run the benchmarks, return {case: {"ns": ..., "cycles": ...}}."""
+    samples = {}
+    errors = {}
+    failed = set()
+    command = "bench all %d %s" % (args.loops, args.path)
+    for _ in range(args.repeat):
+        for line in node.shell(command, timeout=120, idle=2):
+            match = RESULT_RE.match(line)
+            if match:
+                case, _, ns, cycles = match.groups()
+                samples.setdefault(case, []).append(
+                    (int(ns), None if cycles == "-" else int(cycles)))
+                continue
+            match = FAILED_RE.match(line)
+            if match:
+                failed.add(match.group(1))
+                continue
+            match = ERROR_RE.match(line)
+            if match:
+                errors[match.group(1)] = {"mean": int(match.group(2)),
+                                          "max": int(match.group(3))}
+    results = {}
+    for case, values in samples.items():
+        cycles = [c for _, c in values if c is not None]
+        results[case] = {"ns": median([ns for ns, _ in values]),
+                         "cycles": median(cycles)}
+        # the replay is the same on every run
+        if case in errors:
+            results[case]["error"] = errors[case]
+    for case in sorted(failed):
+        print("%s: wrong result" % case)
+    return results, sorted(failed)
+
+
+def bench(app, elf, args):
+    node = native.NativeNode(elf, args.tap)
+    try:
+        node.wait_ready()
+        results, failed = run(node, args)
+    finally:
+        node.stop()
+
+    print("%-12s %8s %9s" % (app, "ns/op", "cycles/op"))
+    for case, result in sorted(results.items()):
+        error = ""
+        if "error" in result:
+            error = "  error mean %(mean)d max %(max)d mdeg" % result["error"]
+        print("%-12s %8s %9s%s" % (case, result["ns"], result["cycles"],
+                                   error))
+
+    report = {
+        "target": app,
+        "revision": coap_bench.revision(),
+        "date": time.strftime("%Y-%m-%dT%H:%M:%S"),
+        "loops": args.loops,
+        "repeat": args.repeat,
+        "path": args.path,
+        "cases": results,
+        "failed": failed,
+    }
+    path = os.path.join(args.output, "%s_%s_microbench.json"
+                        % (app, report["revision"]))
+    with open(path, "w") as f:
+        json.dump(report, f, indent=2, sort_keys=True)
+    print("saved to %s" % path)
+    return not failed
+
+
+def compare(old_path, new_path, threshold):
+    """Print the changes, return False when a case got slower than the
+    threshold."""
+    with open(old_path) as f:
+        old = json.load(f)
+    with open(new_path) as f:
+        new = json.load(f)
+    print("%s (%s) -> %s (%s)" % (old["target"], old["revision"],
+                                  new["target"], new["revision"]))
+    ok = True
+    for case, result in sorted(new["cases"].items()):
+        before = old["cases"].get(case)
+        if before is None or not before["ns"]:
+            continue
+        change = (result["ns"] - before["ns"]) * 100.0 / before["ns"]
+        mark = ""
+        if change > threshold:
+            mark = "  REGRESSION"
+            ok = False
+        print("%-12s %8d -> %8d ns  (%+.1f%%)%s" % (case, before["ns"],
+                                                   result["ns"], change, mark))
+        if "error" in result and "error" in before:
+            print("%-12s %8d -> %8d mdeg mean error" % (
+                "", before["error"]["mean"], result["error"]["mean"]))
+    return ok
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    parser.add_argument("apps", nargs="*", help="applications to benchmark")
+    parser.add_argument("--tap", default="tap0")
+    parser.add_argument("--modules", default="",
+                        help="extra modules of the native builds, space "
+                             "separated")
+    parser.add_argument("--loops", type=int, default=1000,
+                        help="operations timed per case")
+    parser.add_argument("--repeat", type=int, default=5,
+                        help="runs of each case, the median is kept")
+    parser.add_argument("--path", default="/name",
+                        help="resource requested by the dispatch case")
+    parser.add_argument("--no-build", action="store_true")
+    parser.add_argument("--output", default="results")
+    parser.add_argument("--compare", nargs=2, metavar="JSON",
+                        help="compare two saved results")
+    parser.add_argument("--threshold", type=float, default=10,
+                        help="slowdown in %% reported as a regression")
+    args = parser.parse_args()
+
+    if args.compare:
+        sys.exit(0 if compare(args.compare[0], args.compare[1],
+                              args.threshold) else 1)
+    if not args.apps:
+        parser.error("give applications to build, or --compare")
+    os.makedirs(args.output, exist_ok=True)
+
+    modules = ["microbench"] + args.modules.split()
+    ok = True
+    for app in args.apps:
+        elf = os.path.join(native.app_dir(app), "bin", "native", "%s.elf" % app)
+        if not args.no_build:
+            elf = native.build(app, modules=modules)
+        ok = bench(app, elf, args) and ok
+    sys.exit(0 if ok else 1)
+
+
+if __name__ == "__main__":
+    main()
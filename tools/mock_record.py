@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""Record the sensor values of a node as a trace for the mock sensors.
+
+The sensor resources of a node (e.g. a board in the testbed) are polled
+over CoAP, or the "[telemetry]" lines of a console (built with
+telemetry_log) are read from stdin as they are printed. The values are
+written as "time_ms,channel,value" lines, to copy as mock_sensors.csv in
+the working directory of a native instance which then replays them.
+
+    $ ./tools/mock_record.py --coap 2001:db8::1 --duration 600 --interval 5
+    $ make -C apps/node_bmx280 term | ./tools/mock_record.py
+"""
+
+import argparse
+import os
+import re
+import sys
+import time
+
+import coap
+
+REPO = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+MOCK_SENSORS_H = os.path.join(REPO, "modules", "mock_sensors",
+                              "mock_sensors.h")
+
+NUMBER_RE = re.compile(r"^\s*(-?\d+(?:\.\d+)?)")
+TELEMETRY_RE = re.compile(r"\[telemetry\] (\w+)(?:/\d+)?: (.*)$")
+
+
+def channel_names():
+    """Channel names of the MOCK_CHANNELS list of mock_sensors.h."""
+    with open(MOCK_SENSORS_H) as f:
+        text = f.read()
+    block = text[text.index("#define MOCK_CHANNELS(X)"):]
+    block = block[:block.index("\n\n")]
+    return re.findall(r'X\(\w+,\s*"(\w+)"', block)
+
+
+class Recorder(object):
+
+    def __init__(self, out):
+        self.channels = channel_names()
+        self.out = out
+        self.start = time.time()
+        self.count = 0
+        out.write("time_ms,channel,value\n")
+
+    def add(self, name, text):
+        """Write the value of `text` (e.g. "23.4°C") if `name` is a
+        channel, return whether it was."""
+        match = NUMBER_RE.match(text)
+        if name not in self.channels or not match:
+            return False
+        now = int((time.time() - self.start) * 1000)
+        self.out.write("%d,%s,%s\n" % (now, name, match.group(1)))
+        self.out.flush()
+        self.count += 1
+        return True
+
+
+def poll(recorder, address, duration, interval):
+    client = coap.Client(address)
+    # the first instance of each channel, /temperature or /temperature/0
+    paths = {}
+    for path in client.resources():
+        name = path.strip("/").split("/")[0]
+        if name in recorder.channels and name not in paths:
+            paths[name] = path
+    if not paths:
+        sys.exit("%s has no sensor resource" % address)
+    print("recording %s" % " ".join(sorted(paths.values())), file=sys.stderr)
+
+    end = time.time() + duration
+    while time.time() < end:
+        for name, path in sorted(paths.items()):
+            res = client.get(path)
+            if res is None or res[0] != 0x45:
+                print("no answer from %s on %s" % (address, path),
+                      file=sys.stderr)
+                continue
+            recorder.add(name, res[1].decode(errors="replace"))
+        time.sleep(interval)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    parser.add_argument("--coap", metavar="ADDR",
+                        help="poll the sensor resources of a node, the "
+                             "console is read from stdin otherwise")
+    parser.add_argument("--duration", type=int, default=300,
+                        help="polling duration in s")
+    parser.add_argument("--interval", type=float, default=5,
+                        help="polling interval in s")
+    parser.add_argument("--output", default="mock_sensors.csv")
+    args = parser.parse_args()
+
+    with open(args.output, "w") as out:
+        recorder = Recorder(out)
+        try:
+            if args.coap:
+                poll(recorder, args.coap, args.duration, args.interval)
+            else:
+                for line in sys.stdin:
+                    match = TELEMETRY_RE.search(line)
+                    if match:
+                        recorder.add(match.group(1), match.group(2))
+        except KeyboardInterrupt:
+            pass
+    print("%d values saved to %s" % (recorder.count, args.output),
+          file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,120 @@
+"""Build and run the firmwares on the native board.
+
+The native board runs a firmware as a Linux process attached to a tap
+interface, its shell is the process stdin/stdout. Taps are created with
+RIOT's dist/tools/tapsetup/tapsetup. The sensors are served by the
+mock_sensors module, from mock_sensors.csv in the working directory of the
+instance when it exists.
+"""
+
+import os
+import queue
+import re
+import subprocess
+import threading
+import time
+
+REPO = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+APPS = os.path.join(REPO, "apps")
+
+ADDR_RE = re.compile(r"inet6 addr:\s*(fe80::[0-9a-fA-F:]+)")
+
+
+def app_dir(app):
+    return os.path.join(APPS, app)
+
+
+def build(app, modules=(), cflags=(), variables=(), jobs=None):
+    """Build `app` for native with extra modules, CFLAGS and make variables
+    (e.g. "BROKER_ADDR=fe80::1"), return the path of the elf file."""
+    env = dict(os.environ)
+    if modules:
+        env["USEMODULE"] = " ".join(
+            [env.get("USEMODULE", "")] + list(modules)).strip()
+    if cflags:
+        env["CFLAGS"] = " ".join(
+            [env.get("CFLAGS", "")] + list(cflags)).strip()
+    # most applications set BOARD, only the command line overrides it
+    cmd = ["make", "-C", app_dir(app), "BOARD=native"] + list(variables)
+    cmd.append("all")
+    if jobs:
+        cmd.append("-j%d" % jobs)
+    subprocess.check_call(cmd, env=env)
+    return os.path.join(app_dir(app), "bin", "native", "%s.elf" % app)
+
+
+class NativeNode(object):
+    """A running native instance, its console lines are queued as they
+    are printed."""
+
+    def __init__(self, elf, tap, args=(), cwd=None):
+        """`cwd` holds the files of the instance, e.g. node_config.txt."""
+        self.tap = tap
+        self.lines = queue.Queue()
+        self.log = []
+        self.address = None
+        self.proc = subprocess.Popen([elf, tap] + list(args),
+                                     stdin=subprocess.PIPE,
+                                     stdout=subprocess.PIPE,
+                                     stderr=subprocess.STDOUT,
+                                     universal_newlines=True, bufsize=1,
+                                     cwd=cwd)
+        self._reader = threading.Thread(target=self._read)
+        self._reader.daemon = True
+        self._reader.start()
+
+    def _read(self):
+        for line in self.proc.stdout:
+            line = line.rstrip("\n")
+            self.log.append(line)
+            match = ADDR_RE.search(line)
+            if match and self.address is None:
+                self.address = "%s%%%s" % (match.group(1), self.tap)
+            self.lines.put(line)
+
+    def wait_for(self, pattern, timeout=30):
+        """Wait for a console line matching `pattern`, return the match."""
+        regex = re.compile(pattern)
+        deadline = time.time() + timeout
+        while time.time() < deadline:
+            try:
+                line = self.lines.get(timeout=max(0.01, deadline - time.time()))
+            except queue.Empty:
+                break
+            match = regex.search(line)
+            if match:
+                return match
+        raise RuntimeError("%s: '%s' not seen after %ss"
+                           % (self.tap, pattern, timeout))
+
+    def wait_ready(self, timeout=30):
+        self.wait_for(r"All up", timeout)
+
+    def shell(self, command, timeout=5, idle=0.5):
+        """Run a shell command and return its output lines, the output is
+        considered complete once the console is idle for `idle` s."""
+        while not self.lines.empty():
+            self.lines.get_nowait()
+        self.proc.stdin.write(command + "\n")
+        self.proc.stdin.flush()
+        out = []
+        deadline = time.time() + timeout
+        while time.time() < deadline:
+            try:
+                line = self.lines.get(timeout=idle)
+            except queue.Empty:
+                if out:
+                    break
+                continue
+            line = line.lstrip("> ")
+            if line and line != command:
+                out.append(line)
+        return out
+
+    def stop(self):
+        if self.proc.poll() is None:
+            self.proc.terminate()
+            try:
+                self.proc.wait(timeout=5)
+            except subprocess.TimeoutExpired:
+                self.proc.kill()
@@ -0,0 +1,84 @@
+#!/usr/bin/env python3
+"""Profile the CPU time of each thread and sensor job of firmwares on native.
+
+Each application is built for native with the perf module, started on a tap
+interface, its counters are reset once it is up, then it is driven through
+its busiest paths (see workload.py) and the "perf" shell command gives the
+active time, wakeups per second and average run length of each thread and
+of each sensor bus job. The results are written to <output>/<app>_perf.csv.
+
+    $ ./tools/perf_profile.py node_saul node_leds --tap tap0 --duration 60
+"""
+
+import argparse
+import csv
+import os
+import re
+
+import coap
+import native
+import workload
+
+ROW_RE = re.compile(r"^(\S.*?)\s+(\d+)\s+(\d+\.\d)\s+(\d+\.\d+)\s+(\d+)$")
+
+
+def parse(lines):
+    """Return (kind, name, active ms, cpu %, rate, avg run us) rows."""
+    rows = []
+    kind = None
+    for line in lines:
+        header = line.split()
+        if header and header[0] in ("thread", "job"):
+            kind = header[0]
+            continue
+        match = ROW_RE.match(line)
+        if kind and match:
+            rows.append((kind, match.group(1), int(match.group(2)),
+                         float(match.group(3)), float(match.group(4)),
+                         int(match.group(5))))
+    return rows
+
+
+def profile(app, args):
+    elf = os.path.join(native.app_dir(app), "bin", "native", "%s.elf" % app)
+    if not args.no_build:
+        elf = native.build(app, modules=["perf"])
+    node = native.NativeNode(elf, args.tap)
+    try:
+        node.wait_ready()
+        node.shell("perf reset")
+        client = coap.Client(node.address)
+        requests, lost = workload.exercise(client, args.duration)
+        print("%s: %d requests, %d unanswered" % (app, requests, lost))
+        rows = parse(node.shell("perf"))
+    finally:
+        node.stop()
+
+    path = os.path.join(args.output, "%s_perf.csv" % app)
+    with open(path, "w") as f:
+        writer = csv.writer(f)
+        writer.writerow(["kind", "name", "active_ms", "cpu_percent",
+                         "runs_per_s", "avg_run_us"])
+        writer.writerows(rows)
+    for row in rows:
+        print("%-6s %-20s %8d ms %5.1f%% %9.3f/s %8d us" % row)
+    print("saved to %s" % path)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    parser.add_argument("apps", nargs="+", help="applications to profile")
+    parser.add_argument("--tap", default="tap0")
+    parser.add_argument("--duration", type=int, default=60,
+                        help="workload duration in s")
+    parser.add_argument("--no-build", action="store_true")
+    parser.add_argument("--output", default="results")
+    args = parser.parse_args()
+
+    os.makedirs(args.output, exist_ok=True)
+    for app in args.apps:
+        profile(app, args)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+"""Measure the peak stack usage of each thread of a firmware.
+
+By default the firmware is built for native with the stack_usage module,
+started on a tap interface and driven through its busiest paths (see
+workload.py), then the "stacks" shell command gives the high-water mark of
+each thread. With --node, a deployed board built with stack_usage is driven
+instead and its /stacks resource is read.
+
+The results are written to <output>/<app>_stacks.csv with a suggested size
+for each thread (peak plus margin), to be set with the <MODULE>_STACKSIZE
+macros. Native threads run on the host ABI and libc, their figures are
+larger than on the boards: size the boards from --node runs.
+
+    $ ./tools/stack_profile.py node_saul --tap tap0 --duration 120
+    $ ./tools/stack_profile.py node_bmx280 --node 2001:db8::1
+"""
+
+import argparse
+import csv
+import os
+import re
+import sys
+
+import coap
+import native
+import workload
+
+ROW_RE = re.compile(r"^\s*(-?\d+)\s*\|\s*(\S.*?)\s*\|\s*(\d+)\s*\|\s*(\d+)\s*\|")
+
+
+def parse_shell(lines):
+    stacks = []
+    for line in lines:
+        match = ROW_RE.match(line)
+        if match:
+            stacks.append((match.group(2), int(match.group(3)),
+                           int(match.group(4))))
+    return stacks
+
+
+def parse_resource(payload):
+    stacks = []
+    for line in payload.decode().splitlines():
+        name, _, sizes = line.rpartition(":")
+        used, _, size = sizes.partition("/")
+        stacks.append((name, int(size), int(used)))
+    return stacks
+
+
+def suggest(used, margin):
+    """Peak plus margin, rounded up to 8 bytes for the stack alignment."""
+    size = used + (used * margin) // 100
+    return (size + 7) & ~7
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    parser.add_argument("app", help="application, e.g. node_bmx280")
+    parser.add_argument("--tap", default="tap0")
+    parser.add_argument("--node", help="address of a deployed node")
+    parser.add_argument("--duration", type=int, default=90,
+                        help="workload duration in s, covers a few beacons")
+    parser.add_argument("--margin", type=int, default=25,
+                        help="margin over the peak in %%")
+    parser.add_argument("--no-build", action="store_true")
+    parser.add_argument("--output", default="results")
+    args = parser.parse_args()
+
+    node = None
+    if args.node:
+        address = args.node
+    else:
+        elf = os.path.join(native.app_dir(args.app), "bin", "native",
+                           "%s.elf" % args.app)
+        if not args.no_build:
+            elf = native.build(args.app, modules=["stack_usage"])
+        node = native.NativeNode(elf, args.tap)
+        node.wait_ready()
+        address = node.address
+
+    try:
+        client = coap.Client(address)
+        requests, lost = workload.exercise(client, args.duration)
+        print("%d requests, %d unanswered" % (requests, lost))
+
+        if node:
+            stacks = parse_shell(node.shell("stacks"))
+        else:
+            res = client.get("/stacks")
+            if res is None or res[0] != 0x45:
+                sys.exit("no /stacks on %s, is stack_usage built in?" % address)
+            stacks = parse_resource(res[1])
+    finally:
+        if node:
+            node.stop()
+
+    if not stacks:
+        sys.exit("no stack usage reported")
+
+    os.makedirs(args.output, exist_ok=True)
+    path = os.path.join(args.output, "%s_stacks.csv" % args.app)
+    with open(path, "w") as f:
+        writer = csv.writer(f)
+        writer.writerow(["thread", "size", "used", "suggested"])
+        print("%-20s %6s %6s %9s" % ("thread", "size", "used", "suggested"))
+        for name, size, used in stacks:
+            suggested = suggest(used, args.margin)
+            writer.writerow([name, size, used, suggested])
+            print("%-20s %6d %6d %9d" % (name, size, used, suggested))
+    print("saved to %s" % path)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,210 @@
+#!/usr/bin/env python3
+"""Decode the tokenized log of a firmware built with the tlog module.
+
+The records only hold the offset of their format string in the "tlog_fmt"
+section of the ELF file, a timestamp and the raw arguments, the text is
+rebuilt here from the ELF file of the exact same build. Records are read
+from the "tlog:" lines of a console capture (file or stdin), or polled
+from the /log resource of a node with --coap.
+
+    $ ./tools/tlog_decode.py apps/node_saul/bin/native/node_saul.elf console.txt
+    $ ./tools/tlog_decode.py node_bmx280.elf --coap 2001:db8::1 --interval 5
+    $ ./tools/tlog_decode.py node_bmx280.elf --table > formats.json
+"""
+
+import argparse
+import json
+import re
+import struct
+import sys
+import time
+
+import coap
+
+SECTION = "tlog_fmt"
+ID_DROPPED = 0xffff
+HEADER = struct.Struct("<BHI")
+
+SHF_WRITE = 0x1
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+
+LINE_RE = re.compile(r"tlog:([0-9a-fA-F]+)")
+SPEC_RE = re.compile(r"%([-+ #0]*)(\*|\d+)?(?:\.(\d+))?(hh|h|ll|l|z|j|t)?"
+                     r"([diouxXcsp%])")
+
+
+class Elf(object):
+    """Sections of an ELF file, only what the decoder needs."""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        if self.data[:4] != b"\x7fELF":
+            raise ValueError("%s is not an ELF file" % path)
+        is64 = self.data[4] == 2
+        order = "<" if self.data[5] == 1 else ">"
+        if is64:
+            shoff, = struct.unpack_from(order + "Q", self.data, 0x28)
+            shentsize, shnum, shstrndx = struct.unpack_from(
+                order + "HHH", self.data, 0x3a)
+            entry = order + "IIQQQQIIQQ"
+        else:
+            shoff, = struct.unpack_from(order + "I", self.data, 0x20)
+            shentsize, shnum, shstrndx = struct.unpack_from(
+                order + "HHH", self.data, 0x2e)
+            entry = order + "IIIIIIIIII"
+
+        headers = [struct.unpack_from(entry, self.data, shoff + i * shentsize)
+                   for i in range(shnum)]
+        strtab = headers[shstrndx]
+        self.sections = []
+        for name, stype, flags, addr, offset, size in (h[:6] for h in headers):
+            start = strtab[4] + name
+            name = self.data[start:self.data.index(b"\0", start)].decode()
+            self.sections.append({
+                "name": name, "type": stype, "flags": flags,
+                "addr": addr, "offset": offset, "size": size,
+            })
+
+    def section(self, name):
+        for section in self.sections:
+            if section["name"] == name:
+                return section
+        return None
+
+    def contents(self, section):
+        return self.data[section["offset"]:section["offset"] + section["size"]]
+
+    def const_string(self, addr):
+        """Return the string at `addr` if it lies in read only data."""
+        for section in self.sections:
+            if (section["flags"] & (SHF_ALLOC | SHF_WRITE) != SHF_ALLOC or
+                    section["type"] == SHT_NOBITS or not section["addr"]):
+                continue
+            if section["addr"] <= addr < section["addr"] + section["size"]:
+                pos = section["offset"] + addr - section["addr"]
+                end = self.data.find(b"\0", pos)
+                return self.data[pos:end].decode(errors="replace")
+        return None
+
+
+class Decoder(object):
+
+    def __init__(self, elf):
+        self.elf = elf
+        section = elf.section(SECTION)
+        if section is None:
+            raise ValueError("no %s section, is the tlog module built in?"
+                             % SECTION)
+        self.formats = {}
+        data = elf.contents(section)
+        pos = 0
+        while pos < len(data):
+            end = data.index(b"\0", pos)
+            self.formats[pos] = data[pos:end].decode(errors="replace")
+            pos = end + 1
+
+    def format(self, fmt, args):
+        args = list(args)
+
+        def convert(match):
+            flags, width, precision, length, conv = match.groups()
+            if conv == "%":
+                return "%"
+            if width == "*":
+                width = str(args.pop(0) if args else 0)
+            value = args.pop(0) if args else 0
+            spec = "%" + flags + (width or "")
+            if precision is not None:
+                spec += "." + precision
+            if length == "hh":
+                value &= 0xff
+            elif length == "h":
+                value &= 0xffff
+            if conv in "di":
+                bits = {"hh": 8, "h": 16}.get(length, 32)
+                if value >= 1 << (bits - 1):
+                    value -= 1 << bits
+                return (spec + "d") % value
+            if conv == "u":
+                return (spec + "d") % value
+            if conv == "c":
+                return (spec + "c") % chr(value & 0xff)
+            if conv == "p":
+                return "0x%08x" % value
+            if conv == "s":
+                text = self.elf.const_string(value)
+                if text is None:
+                    text = "<0x%08x>" % value
+                return (spec + "s") % text
+            return (spec + conv) % value
+
+        return SPEC_RE.sub(convert, fmt)
+
+    def records(self, data):
+        """Yield (time in us, text) for each record of `data`."""
+        pos = 0
+        while pos + HEADER.size <= len(data):
+            nargs, fmt_id, now = HEADER.unpack_from(data, pos)
+            pos += HEADER.size
+            args = struct.unpack_from("<%dI" % nargs, data, pos)
+            pos += 4 * nargs
+            if fmt_id == ID_DROPPED:
+                yield now, "[tlog] %d records dropped" % args[0]
+            elif fmt_id in self.formats:
+                yield now, self.format(self.formats[fmt_id], args).rstrip("\n")
+            else:
+                yield now, "[tlog] unknown format %d, another build?" % fmt_id
+
+
+def print_records(decoder, data):
+    for now, text in decoder.records(data):
+        print("%10.6f %s" % (now / 1e6, text))
+    sys.stdout.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    parser.add_argument("elf", help="ELF file of the running firmware")
+    parser.add_argument("console", nargs="?",
+                        help="console capture, stdin by default")
+    parser.add_argument("--coap", metavar="ADDR",
+                        help="poll the /log resource of a node instead")
+    parser.add_argument("--interval", type=float, default=2,
+                        help="polling interval in s")
+    parser.add_argument("--table", action="store_true",
+                        help="dump the format strings by id as JSON")
+    args = parser.parse_args()
+
+    decoder = Decoder(Elf(args.elf))
+
+    if args.table:
+        json.dump(decoder.formats, sys.stdout, indent=2, sort_keys=True)
+        print()
+        return
+
+    if args.coap:
+        client = coap.Client(args.coap)
+        while True:
+            res = client.get("/log")
+            if res is None or res[0] != 0x45:
+                print("no answer from %s" % args.coap, file=sys.stderr)
+            elif res[1]:
+                print_records(decoder, res[1])
+                # more records may be waiting
+                continue
+            time.sleep(args.interval)
+
+    console = open(args.console) if args.console else sys.stdin
+    for line in console:
+        match = LINE_RE.search(line)
+        if match:
+            print_records(decoder, bytes.fromhex(match.group(1)))
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except KeyboardInterrupt:
+        pass
@@ -0,0 +1,199 @@
+#!/usr/bin/env python3
+"""Export the request trace of a firmware built with the trace module.
+
+Events are read from the "trace:" lines of a console capture (file or
+stdin), or polled from the /trace resource of a node with --coap. They are
+written as Chrome trace JSON, to open in chrome://tracing or Perfetto: each
+thread has its own track with the stages it ran, and each request has an
+async track with its stages in order. The time spent per stage and the
+slowest requests are printed as well.
+
+    $ ./tools/trace_export.py console.txt --output trace.json
+    $ ./tools/trace_export.py --coap 2001:db8::1 --duration 60
+"""
+
+import argparse
+import json
+import os
+import re
+import struct
+import sys
+import time
+
+import coap
+
+REPO = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+TRACE_H = os.path.join(REPO, "modules", "trace", "trace.h")
+
+EVENT = struct.Struct("<IIBBb")
+LOCAL = 0x10000
+STAGE_LOST = 0xff
+BEGIN, END, INSTANT = 0, 1, 2
+
+LINE_RE = re.compile(r"trace:([0-9a-fA-F]+)$")
+THREAD_RE = re.compile(r"trace:thread (\d+) (.*)$")
+
+
+def stage_names():
+    """Stage names in enum order, from the TRACE_STAGES list of trace.h."""
+    with open(TRACE_H) as f:
+        text = f.read()
+    block = text[text.index("#define TRACE_STAGES(X)"):]
+    block = block[:block.index("\n\n")]
+    return re.findall(r'X\(\w+, "(\w+)"\)', block)
+
+
+def request_name(rid):
+    if rid & LOCAL:
+        return "local %d" % (rid & 0xffff)
+    return "coap %d" % rid
+
+
+def percentile(values, p):
+    values = sorted(values)
+    return values[min(len(values) - 1, int(len(values) * p / 100))]
+
+
+class Trace(object):
+
+    def __init__(self):
+        self.names = stage_names()
+        self.threads = {0: "isr"}
+        self.events = []
+        self.lost = 0
+        self._last = None
+        self._wraps = 0
+
+    def add(self, data):
+        for pos in range(0, len(data) - EVENT.size + 1, EVENT.size):
+            now, rid, stage, phase, pid = EVENT.unpack_from(data, pos)
+            if stage == STAGE_LOST:
+                self.lost += rid
+                continue
+            # the node clock is 32 bit us, it wraps after 71 minutes
+            if self._last is not None and now < self._last and \
+                    self._last - now > 1 << 31:
+                self._wraps += 1
+            self._last = now
+            name = (self.names[stage] if stage < len(self.names)
+                    else "stage%d" % stage)
+            self.events.append((now + (self._wraps << 32), rid, name,
+                                phase, pid))
+
+    def chrome(self):
+        out = []
+        for pid, name in sorted(self.threads.items()):
+            out.append({"name": "thread_name", "ph": "M", "pid": 0,
+                        "tid": pid, "args": {"name": name}})
+        for ts, rid, name, phase, pid in self.events:
+            args = {"request": request_name(rid)}
+            if phase == INSTANT:
+                out.append({"name": name, "ph": "i", "s": "t", "ts": ts,
+                            "pid": 0, "tid": pid, "args": args})
+                out.append({"name": name, "cat": "request", "ph": "n",
+                            "id": rid, "ts": ts, "pid": 0, "tid": pid,
+                            "args": args})
+                continue
+            out.append({"name": name, "ph": "B" if phase == BEGIN else "E",
+                        "ts": ts, "pid": 0, "tid": pid, "args": args})
+            out.append({"name": name, "cat": "request",
+                        "ph": "b" if phase == BEGIN else "e",
+                        "id": rid, "ts": ts, "pid": 0, "tid": pid,
+                        "args": args})
+        return {"traceEvents": out, "displayTimeUnit": "ms"}
+
+    def spans(self):
+        """Return the (request, stage, start, duration) of the matched
+        begin and end events."""
+        open_spans = {}
+        spans = []
+        for ts, rid, name, phase, pid in self.events:
+            key = (pid, rid, name)
+            if phase == BEGIN:
+                open_spans.setdefault(key, []).append(ts)
+            elif phase == END and open_spans.get(key):
+                start = open_spans[key].pop()
+                spans.append((rid, name, start, ts - start))
+        return spans
+
+    def summary(self, slowest=5):
+        spans = self.spans()
+        print("%d events, %d lost on the node" % (len(self.events), self.lost))
+        print("%-10s %7s %9s %9s %9s" % ("stage", "count", "p50 us",
+                                         "p99 us", "max us"))
+        for name in self.names:
+            durations = [d for _, n, _, d in spans if n == name]
+            if durations:
+                print("%-10s %7d %9d %9d %9d" % (
+                    name, len(durations), percentile(durations, 50),
+                    percentile(durations, 99), max(durations)))
+
+        requests = {}
+        for ts, rid, name, phase, pid in self.events:
+            first, last = requests.get(rid, (ts, ts))
+            requests[rid] = (min(first, ts), max(last, ts))
+        ranked = sorted(requests.items(), key=lambda r: r[1][0] - r[1][1])
+        if ranked:
+            print("slowest requests:")
+        for rid, (first, last) in ranked[:slowest]:
+            stages = ", ".join("%s %dus" % (n, d) for r, n, _, d in spans
+                               if r == rid)
+            print("  %-12s %8d us  %s" % (request_name(rid), last - first,
+                                         stages))
+
+
+def read_console(trace, lines):
+    for line in lines:
+        match = THREAD_RE.search(line)
+        if match:
+            trace.threads[int(match.group(1))] = match.group(2).strip()
+            continue
+        match = LINE_RE.search(line.strip())
+        if match:
+            trace.add(bytes.fromhex(match.group(1)))
+
+
+def poll(trace, address, duration, interval):
+    client = coap.Client(address)
+    end = time.time() + duration
+    while time.time() < end:
+        res = client.get("/trace")
+        if res is None or res[0] != 0x45:
+            print("no answer from %s" % address, file=sys.stderr)
+        elif res[1]:
+            trace.add(res[1])
+            # more events may be waiting
+            continue
+        time.sleep(interval)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    parser.add_argument("console", nargs="?",
+                        help="console capture, stdin by default")
+    parser.add_argument("--coap", metavar="ADDR",
+                        help="poll the /trace resource of a node instead")
+    parser.add_argument("--duration", type=int, default=30,
+                        help="polling duration in s")
+    parser.add_argument("--interval", type=float, default=0.5,
+                        help="polling interval in s, before the ring fills")
+    parser.add_argument("--output", default="trace.json")
+    args = parser.parse_args()
+
+    trace = Trace()
+    if args.coap:
+        poll(trace, args.coap, args.duration, args.interval)
+    elif args.console:
+        with open(args.console) as f:
+            read_console(trace, f)
+    else:
+        read_console(trace, sys.stdin)
+
+    with open(args.output, "w") as f:
+        json.dump(trace.chrome(), f)
+    trace.summary()
+    print("saved to %s" % args.output)
+
+
+if __name__ == "__main__":
+    main()
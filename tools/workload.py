@@ -0,0 +1,49 @@
+"""Drive the busiest paths of a node over CoAP.
+
+Every resource listed in /.well-known/core is read, /config is read and
+written back unchanged, and a short burst is requested on each source when
+the firmware has /burst. Beacons and sensor reports run on their own during
+the workload.
+"""
+
+import time
+
+import coap
+
+BURST_RATE = 20
+BURST_DURATION = 2
+
+# resources of the tools themselves, reading them is not part of the load
+SKIP = ("/.well-known/core", "/energy", "/log", "/metrics",
+        "/metrics/latency", "/stacks", "/trace")
+
+
+def exercise(client, duration, log=print):
+    """Run the workload for `duration` s, return the number of requests
+    and of those left without an answer."""
+    paths = [p for p in client.resources() if p not in SKIP]
+    log("resources: %s" % " ".join(paths))
+    sources = sorted(set(p.strip("/").split("/")[0] for p in paths
+                         if p not in ("/burst", "/config")))
+    requests = 0
+    lost = 0
+    end = time.time() + duration
+    while time.time() < end:
+        for path in paths:
+            requests += 1
+            res = client.get(path)
+            if res is None:
+                lost += 1
+                continue
+            if path == "/config" and res[0] == 0x45:
+                requests += 1
+                if client.request(coap.PUT, path, res[1]) is None:
+                    lost += 1
+        if "/burst" in paths:
+            for source in sources:
+                requests += 1
+                payload = "resource=%s&rate=%d&duration=%d" % (
+                    source, BURST_RATE, BURST_DURATION)
+                if client.request(coap.POST, "/burst", payload) is None:
+                    lost += 1
+    return requests, lost